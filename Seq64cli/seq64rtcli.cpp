@@ -51,6 +51,7 @@
 
 #include "midifile.hpp"                 /* seq64::midifile to open the file */
 #include "perform.hpp"                  /* seq64::perform, the main object  */
+#include "rt_audit.hpp"                 /* seq64::rt_audit_report()         */
 #include "settings.hpp"                 /* seq64::usr() and seq64::rc()     */
 
 #if defined PLATFORM_LINUX
@@ -62,7 +63,15 @@
 static bool s_seq64cli_running = false;
 
 /**
- *  Provides a signal handler for exiting the application gracefully.
+ *  Set by SIGUSR1 to ask the main loop to print the timing report of the
+ *  output loop, and, in an audit build, the realtime-safety report.
+ */
+
+static bool s_seq64cli_report = false;
+
+/**
+ *  Provides a signal handler for exiting the application gracefully, and
+ *  for requesting the timing report.
  */
 
 static void
@@ -72,6 +81,8 @@ seq64_signal_handler (int signalnumber)
         s_seq64cli_running = false;
     else if (signalnumber == SIGTERM)
         s_seq64cli_running = false;
+    else if (signalnumber == SIGUSR1)
+        s_seq64cli_report = true;
 }
 
 #endif  // PLATFORM_LINUX
@@ -210,7 +221,27 @@ main (int argc, char * argv [])
                 if (! ok)
                     extant_msg_active = true;
             }
-            if (ok)
+
+            /*
+             * With "-o render=filename", the song is rendered to a MIDI
+             * file, faster than real time, and not played.
+             */
+
+            std::string renderfile = seq64::rc().render_filename();
+            if (ok && ! renderfile.empty())
+            {
+                std::string errmsg;
+                ok = p.render_offline(renderfile, errmsg);
+                if (ok)
+                    printf("[Rendered the song to %s]\n", renderfile.c_str());
+                else
+                {
+                    errprint(errmsg.c_str());
+                }
+
+                p.finish();                         /* tear down performer  */
+            }
+            else if (ok)
             {
                 if (seq64::rc().lash_support())
                     seq64::create_lash_driver(p, argc, argv);
@@ -226,9 +257,21 @@ main (int argc, char * argv [])
                 {
                     if (signal(SIGTERM, seq64_signal_handler) != SIG_ERR)
                     {
+                        (void) signal(SIGUSR1, seq64_signal_handler);
                         s_seq64cli_running = true;
                         while (s_seq64cli_running)
+                        {
                             usleep(1000000);
+                            if (s_seq64cli_report)
+                            {
+                                s_seq64cli_report = false;
+                                printf("%s", p.timing_report().c_str());
+#ifdef SEQ64_RT_AUDIT
+                                fflush(stdout);
+                                seq64::rt_audit_report(STDERR_FILENO);
+#endif
+                            }
+                        }
                     }
                     else
                         printf("? Cannot set SIGTERM handler\n");
@@ -237,6 +280,9 @@ main (int argc, char * argv [])
                     printf("? Cannot set SIGINT handler\n");
 #endif
 
+                if (p.timing_stats())
+                    printf("%s", p.timing_report().c_str());
+
                 p.finish();                         /* tear down performer  */
                 if (seq64::rc().auto_option_save())
                 {
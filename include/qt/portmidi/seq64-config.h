@@ -364,6 +364,9 @@
 #endif
  */
 
+/* Define to enable the realtime-safety audit */
+/* #undef RT_AUDIT */
+
 /* Define to enable statistics gathering */
 /* #undef STATISTICS_SUPPORT */
 
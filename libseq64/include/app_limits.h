@@ -566,6 +566,139 @@
 
 #define SEQ64_DEFAULT_TRIGWIDTH_MS         4
 
+/**
+ *  Default value for c_scheduler_max_sleep_us, the longest that the
+ *  event-driven output scheduler sleeps, even if nothing is due sooner.
+ *  It bounds the delay in noticing a change that does not wake the output
+ *  thread, such as a tempo change.
+ */
+
+#define SEQ64_SCHEDULER_MAX_SLEEP_MS       50
+
+/**
+ *  The largest lookahead window, in milliseconds, that can be set with the
+ *  "-o lookahead=ms" option.  Mute, queue, and tempo changes take effect up
+ *  to this much later than they are made, so the window must stay small.
+ */
+
+#define SEQ64_LOOKAHEAD_MAX_MS             100
+
+/**
+ *  The default and largest number of messages that the MIDI input queue of
+ *  a port can hold, for the APIs that queue their input (JACK), as set with
+ *  the "-o inqueue=n" option.
+ */
+
+#define SEQ64_INPUT_QUEUE_SIZE            1024
+#define SEQ64_INPUT_QUEUE_SIZE_MAX       65536
+
+/**
+ *  The number of events that the submission queue of an output buss can
+ *  hold between two flushes of the master buss.  Must be a power of 2.  A
+ *  producer that finds the queue full flushes the master buss itself.
+ */
+
+#define SEQ64_OUTPUT_QUEUE_SIZE           1024
+
+/**
+ *  The largest number of threads that can render the patterns, as set with
+ *  the "-o threads=n" option.  With the default of 1, the output thread
+ *  renders all of the patterns itself.
+ */
+
+#define SEQ64_RENDER_THREADS_MAX            16
+
+/**
+ *  The smallest number of active patterns for which the worker threads are
+ *  used.  Below this count, handing the patterns to the workers costs more
+ *  than it saves, and the output thread renders them itself.
+ */
+
+#define SEQ64_RENDER_PARALLEL_MIN           16
+
+/**
+ *  The number of events that the render buffer of a worker thread holds
+ *  before it has to grow.  The buffers are allocated when the workers are
+ *  created.
+ */
+
+#define SEQ64_RENDER_BUFFER_SIZE          4096
+
+/**
+ *  The largest number of output ports of the null MIDI backend, as set with
+ *  the "-o null=n" option.  It has a single input port.
+ */
+
+#define SEQ64_NULL_PORTS_MAX                16
+
+/**
+ *  The number of events that the capture buffer of the null MIDI backend
+ *  holds.  The buffer is allocated when the backend is created; events
+ *  played once it is full are counted, but not captured.
+ */
+
+#define SEQ64_NULL_CAPTURE_SIZE         262144
+
+/**
+ *  The largest number of MIDI clock pulses whose delays are precomputed for
+ *  one pass of the output loop.  At 24 pulses per quarter note, this covers
+ *  a lookahead of more than 2.5 beats; pulses beyond it are scheduled at the
+ *  tempo of the pass.
+ */
+
+#define SEQ64_CLOCK_SCHEDULE_MAX            64
+
+/**
+ *  The longest time, in milliseconds, that the input thread blocks waiting
+ *  for MIDI input before it checks whether it is still running.  Input
+ *  wakes it at once, and so does the perform destructor; this only bounds
+ *  the wait if a wakeup is missed.
+ */
+
+#define SEQ64_INPUT_WAKEUP_MS              100
+
+/**
+ *  The largest number of routes in the MIDI-thru routing table.  See the
+ *  thru_map module.
+ */
+
+#define SEQ64_THRU_ROUTES_MAX               16
+
+/**
+ *  Marks the input buss or channel of a thru route that matches any buss or
+ *  channel, the output channel of a route that keeps the channel of the
+ *  input, and the input buss of an event whose buss is not known.
+ */
+
+#define SEQ64_THRU_ANY                    0xFF
+
+/**
+ *  The number of slots in the hash table that maps the status and first data
+ *  byte of an incoming event to the MIDI controls it triggers.  A power of
+ *  two, well above the number of distinct keys that the toggle, on, and off
+ *  settings of all of the controls can hold.  See the midi_control_map
+ *  module.
+ */
+
+#define SEQ64_MIDI_CONTROL_SLOTS          512
+
+/**
+ *  The number of recorded events that a pattern buffers before they are
+ *  merged into its event list.  Must be a power of 2.  The input thread
+ *  also merges them after every burst of input.  See the record_buffer
+ *  module.
+ */
+
+#define SEQ64_RECORD_BUFFER_SIZE          128
+
+/**
+ *  The number of events in each of the blocks in which an event_array
+ *  stores the events of a pattern, when it is the event container (see the
+ *  "--with-events=array" configure option).
+ */
+
+#define SEQ64_EVENT_BLOCK_SIZE            256
+
 /*
  *  Default value for c_thread_trigger_width_ms.  Not in use at present.
  *
@@ -269,9 +269,9 @@ private:
         bus()->init_clock(tick);
     }
 
-    void clock (midipulse tick)
+    void clock (midipulse tick, const clock_schedule * schedule = nullptr)
     {
-        bus()->clock(tick);
+        bus()->clock(tick, schedule);
     }
 
     void sysex (event * ev)
@@ -328,9 +328,18 @@ public:
     void stop ();
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
-    void clock (midipulse tick);
+    void clock (midipulse tick, const clock_schedule * schedule = nullptr);
     void sysex (event * ev);
-    void play (bussbyte bus, event * e24, midibyte channel);
+    void play
+    (
+        bussbyte bus, event * e24, midibyte channel, long delay_us = 0
+    );
+    bool submit
+    (
+        bussbyte bus, event * e24, midibyte channel, long delay_us = 0
+    );
+    void drain ();
+    bool pending () const;
     bool set_clock (bussbyte bus, clock_e clocktype);
     void set_all_clocks ();
     clock_e get_clock (bussbyte bus);
@@ -72,6 +72,8 @@
 namespace seq64
 {
 
+class tempo_map;
+
 /**
  *  Provides a clear enumation of wave types supported by the wave function.
  *  We still have to clarify these type values, though.
@@ -125,6 +127,14 @@ extern std::string pulses_to_timestring
 (
     midipulse pulses, midibpm bpm, int ppqn, bool showus = true
 );
+extern std::string pulses_to_timestring
+(
+    midipulse p, const tempo_map & tm, bool showus = true
+);
+extern std::string microseconds_to_timestring
+(
+    unsigned long microseconds, bool showus = true
+);
 extern midipulse measurestring_to_pulses
 (
     const std::string & measures,
@@ -0,0 +1,227 @@
+#ifndef SEQ64_CLOCK_SCHEDULE_HPP
+#define SEQ64_CLOCK_SCHEDULE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          clock_schedule.hpp
+ *
+ *  This module declares/defines the schedule of the MIDI clock pulses of
+ *  one pass of the output loop, and the measurement of their timing.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  Without a schedule, midibase::clock() sends each 24-PPQN pulse when the
+ *  output loop passes its tick, so the clock jitters with the loop.  The
+ *  schedule holds, for each pulse from the current position to the end of
+ *  the lookahead window, the delay from now at which it is due, computed
+ *  from the tempo map.  The busses hand these delays to api_clock_at(),
+ *  and a backend that can schedule its output sends each pulse on time.
+ *
+ *  The schedule also measures the pulses it schedules:  the jitter is the
+ *  difference between the interval from the previous pulse and the ideal
+ *  interval at the current tempo, and the skew is the sum of the jitter
+ *  since the clock was started, that is, how far the clock has drifted.
+ *  The times measured are the times at which the pulses were scheduled to
+ *  be sent; without lookahead, that is when they were sent.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+
+#include "app_limits.h"                 /* SEQ64_CLOCK_SCHEDULE_MAX         */
+#include "midibyte.hpp"                 /* seq64::midipulse, midibpm        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class tempo_map;
+    class timing_histogram;
+
+/**
+ *  Precomputes the delays of the MIDI clock pulses of a pass of the output
+ *  loop.  Built and measured by the output thread; the statistics can be
+ *  read by any thread.
+ */
+
+class clock_schedule
+{
+
+private:
+
+    /**
+     *  The pulses-per-quarter-note of the song.
+     */
+
+    int m_ppqn;
+
+    /**
+     *  The number of ticks between MIDI clock pulses, m_ppqn / 24.
+     */
+
+    midipulse m_pulse_ticks;
+
+    /**
+     *  The clock position, with its fraction, at which the schedule was
+     *  built.  The delays are relative to it.
+     */
+
+    double m_clock_now;
+
+    /**
+     *  The length of a tick at the tempo of the pass, in microseconds.
+     *  Gives the delays of the pulses beyond the table, and the ideal
+     *  interval between pulses.
+     */
+
+    double m_us_per_tick;
+
+    /**
+     *  The last tick covered by the schedule.
+     */
+
+    midipulse m_end_tick;
+
+    /**
+     *  The tick of the first pulse in m_delays_us, the first one after
+     *  m_clock_now.  Pulses before it are due now.
+     */
+
+    midipulse m_first_pulse;
+
+    /**
+     *  The number of delays in m_delays_us.
+     */
+
+    int m_count;
+
+    /**
+     *  The delays, in microseconds from m_clock_now, of the pulses from
+     *  m_first_pulse on.
+     */
+
+    long m_delays_us[SEQ64_CLOCK_SCHEDULE_MAX];
+
+    /**
+     *  The last pulse measured, or SEQ64_NULL_MIDIPULSE after restart().
+     */
+
+    midipulse m_measured_pulse;
+
+    /**
+     *  The time at which the last pulse measured was to be sent, in
+     *  microseconds of the clock given to measure().  Zero if there is no
+     *  previous pulse.
+     */
+
+    long long m_last_sent_us;
+
+    /**
+     *  The drift of the clock, kept with its fraction, so that the rounding
+     *  of the times of the pulses does not add up.
+     */
+
+    double m_drift_us;
+
+    /**
+     *  The drift of the clock since it was started, in microseconds.
+     *  Positive if the clock runs late.
+     */
+
+    std::atomic<long> m_skew_us;
+
+    /**
+     *  The error of the last interval between pulses, in microseconds.
+     */
+
+    std::atomic<long> m_jitter_us;
+
+    /**
+     *  The largest magnitude of m_jitter_us since reset_stats().
+     */
+
+    std::atomic<long> m_max_jitter_us;
+
+public:
+
+    clock_schedule (int ppqn = SEQ64_DEFAULT_PPQN);
+
+    void restart (int ppqn);
+    void reset_stats ();
+    void build
+    (
+        double clocknow, double songnow, midipulse endtick,
+        const tempo_map * tm, midibpm bpm
+    );
+    long delay_us (midipulse pulse) const;
+    int measure (long long now_us, timing_histogram * histogram);
+
+    /**
+     * \getter m_skew_us
+     */
+
+    long skew_us () const
+    {
+        return m_skew_us.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \getter m_jitter_us
+     */
+
+    long jitter_us () const
+    {
+        return m_jitter_us.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \getter m_max_jitter_us
+     */
+
+    long max_jitter_us () const
+    {
+        return m_max_jitter_us.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    /*
+     * The schedule holds atomics; it is never copied.
+     */
+
+    clock_schedule (const clock_schedule &);
+    clock_schedule & operator = (const clock_schedule &);
+
+};          // class clock_schedule
+
+}           // namespace seq64
+
+#endif      // SEQ64_CLOCK_SCHEDULE_HPP
+
+/*
+ * clock_schedule.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
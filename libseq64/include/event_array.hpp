@@ -0,0 +1,407 @@
+#ifndef SEQ64_EVENT_ARRAY_HPP
+#define SEQ64_EVENT_ARRAY_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_array.hpp
+ *
+ *  This module declares/defines a sorted, block-allocated container of
+ *  events, a third choice of container for the event_list class.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  With the std::list or std::multimap, every traversal of a pattern, in
+ *  drawing, selection, editing, and file I/O, chases pointers through nodes
+ *  scattered over the heap.  An event_array stores the events themselves
+ *  in blocks of SEQ64_EVENT_BLOCK_SIZE events, allocated as needed, and
+ *  keeps them in order with a contiguous vector of pointers into the
+ *  blocks.  Events added in time order, as when reading a MIDI file or
+ *  copying a pattern, are laid out in time order, so that a traversal walks
+ *  through memory.
+ *
+ *  An event never moves once it is stored, so that the note links
+ *  (event::m_linked) stay valid through insertions, removals, and sorts, as
+ *  with the std::list.  Removing an event frees its place in its block for
+ *  reuse; the blocks themselves are freed only by clear() and the
+ *  destructor.
+ *
+ *  Unlike the std::list, an insertion or removal invalidates the iterators
+ *  after the point of the change, though not the references to the events.
+ *  Selected by configuring with "--with-events=array", which defines the
+ *  SEQ64_USE_EVENT_ARRAY macro.
+ */
+
+#include <cstddef>                      /* std::ptrdiff_t                   */
+#include <iterator>                     /* std::reverse_iterator<>          */
+#include <vector>                       /* std::vector<>                    */
+
+#include "app_limits.h"                 /* SEQ64_EVENT_BLOCK_SIZE           */
+#include "event.hpp"                    /* seq64::event                     */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds events sorted by time-stamp and rank, in stable storage.
+ */
+
+class event_array
+{
+
+    /**
+     *  The sorted pointers to the events.
+     */
+
+    typedef std::vector<event *> Slots;
+
+public:
+
+    class const_iterator;
+
+    /**
+     *  Walks the events in order.  Dereferences to the event itself, as an
+     *  std::list<event> iterator does.
+     */
+
+    class iterator
+    {
+        friend class event_array;
+        friend class const_iterator;
+
+    private:
+
+        Slots::iterator m_slot;     /**< The pointer to the current event.  */
+
+    public:
+
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef event value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef event * pointer;
+        typedef event & reference;
+
+        iterator () : m_slot ()
+        {
+            // Empty body
+        }
+
+        explicit iterator (Slots::iterator s) : m_slot (s)
+        {
+            // Empty body
+        }
+
+        event & operator * () const
+        {
+            return **m_slot;
+        }
+
+        event * operator -> () const
+        {
+            return *m_slot;
+        }
+
+        iterator & operator ++ ()
+        {
+            ++m_slot;
+            return *this;
+        }
+
+        iterator operator ++ (int)
+        {
+            iterator result = *this;
+            ++m_slot;
+            return result;
+        }
+
+        iterator & operator -- ()
+        {
+            --m_slot;
+            return *this;
+        }
+
+        iterator operator -- (int)
+        {
+            iterator result = *this;
+            --m_slot;
+            return result;
+        }
+
+        bool operator == (const iterator & rhs) const
+        {
+            return m_slot == rhs.m_slot;
+        }
+
+        bool operator != (const iterator & rhs) const
+        {
+            return m_slot != rhs.m_slot;
+        }
+    };
+
+    /**
+     *  Walks the events in order, without modifying them.
+     */
+
+    class const_iterator
+    {
+        friend class event_array;
+
+    private:
+
+        Slots::const_iterator m_slot;   /**< The current event's pointer.  */
+
+    public:
+
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef event value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const event * pointer;
+        typedef const event & reference;
+
+        const_iterator () : m_slot ()
+        {
+            // Empty body
+        }
+
+        explicit const_iterator (Slots::const_iterator s) : m_slot (s)
+        {
+            // Empty body
+        }
+
+        const_iterator (const iterator & i) : m_slot (i.m_slot)
+        {
+            // Empty body
+        }
+
+        const event & operator * () const
+        {
+            return **m_slot;
+        }
+
+        const event * operator -> () const
+        {
+            return *m_slot;
+        }
+
+        const_iterator & operator ++ ()
+        {
+            ++m_slot;
+            return *this;
+        }
+
+        const_iterator operator ++ (int)
+        {
+            const_iterator result = *this;
+            ++m_slot;
+            return result;
+        }
+
+        const_iterator & operator -- ()
+        {
+            --m_slot;
+            return *this;
+        }
+
+        const_iterator operator -- (int)
+        {
+            const_iterator result = *this;
+            --m_slot;
+            return result;
+        }
+
+        bool operator == (const const_iterator & rhs) const
+        {
+            return m_slot == rhs.m_slot;
+        }
+
+        bool operator != (const const_iterator & rhs) const
+        {
+            return m_slot != rhs.m_slot;
+        }
+    };
+
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+private:
+
+    /**
+     *  The pointers to the events, sorted by time-stamp and rank.
+     */
+
+    Slots m_slots;
+
+    /**
+     *  The blocks of events, each of SEQ64_EVENT_BLOCK_SIZE events.
+     */
+
+    std::vector<event *> m_blocks;
+
+    /**
+     *  The number of events used in the last block.
+     */
+
+    int m_block_used;
+
+    /**
+     *  The places of removed events, reused before the last block is
+     *  extended.
+     */
+
+    std::vector<event *> m_free;
+
+public:
+
+    event_array ();
+    event_array (const event_array & rhs);
+    event_array & operator = (const event_array & rhs);
+    ~event_array ();
+
+    iterator insert (const event & e);
+    iterator push_back (const event & e);
+    iterator erase (iterator i);
+    iterator find (const event * ep);
+    void merge (event_array & rhs);
+    void sort ();
+    bool remove_marked ();
+    void clear ();
+
+    /**
+     * \getter m_slots.begin(), non-constant version.
+     */
+
+    iterator begin ()
+    {
+        return iterator(m_slots.begin());
+    }
+
+    /**
+     * \getter m_slots.begin(), constant version.
+     */
+
+    const_iterator begin () const
+    {
+        return const_iterator(m_slots.begin());
+    }
+
+    /**
+     * \getter m_slots.end(), non-constant version.
+     */
+
+    iterator end ()
+    {
+        return iterator(m_slots.end());
+    }
+
+    /**
+     * \getter m_slots.end(), constant version.
+     */
+
+    const_iterator end () const
+    {
+        return const_iterator(m_slots.end());
+    }
+
+    /**
+     * \getter end(), as a reverse iterator, non-constant version.
+     */
+
+    reverse_iterator rbegin ()
+    {
+        return reverse_iterator(end());
+    }
+
+    /**
+     * \getter end(), as a reverse iterator, constant version.
+     */
+
+    const_reverse_iterator rbegin () const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /**
+     * \getter begin(), as a reverse iterator, non-constant version.
+     */
+
+    reverse_iterator rend ()
+    {
+        return reverse_iterator(begin());
+    }
+
+    /**
+     * \getter begin(), as a reverse iterator, constant version.
+     */
+
+    const_reverse_iterator rend () const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * \getter m_slots.size()
+     */
+
+    std::size_t size () const
+    {
+        return m_slots.size();
+    }
+
+    /**
+     * \getter m_slots.empty()
+     */
+
+    bool empty () const
+    {
+        return m_slots.empty();
+    }
+
+private:
+
+    event * allocate (const event & e);
+    void copy (const event_array & rhs);
+
+    /**
+     *  Orders the pointers by the events they point to.
+     */
+
+    static bool less (const event * lhs, const event * rhs)
+    {
+        return *lhs < *rhs;
+    }
+
+};          // class event_array
+
+}           // namespace seq64
+
+#endif      // SEQ64_EVENT_ARRAY_HPP
+
+/*
+ * event_array.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
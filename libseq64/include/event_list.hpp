@@ -49,11 +49,14 @@
 
 #include <string>
 #include <stack>
+#include <vector>
 
 #include "seq64_features.h"             /* SEQ64_USE_EVENT_MAP          */
 
-#ifdef SEQ64_USE_EVENT_MAP
+#if defined SEQ64_USE_EVENT_MAP
 #include <map>                          /* std::multimap                */
+#elif defined SEQ64_USE_EVENT_ARRAY
+#include "event_array.hpp"              /* seq64::event_array           */
 #else
 #include <list>                         /* std::list                    */
 #endif
@@ -79,10 +82,11 @@ namespace seq64
 {
 
 /**
- *  The event_list class is a receptable for MIDI events.  Two
- *  implementations, an std::multimap, and the original, an std::list, are
- *  provided for comparison, and are selected at build time, by manually
- *  defining the SEQ64_USE_EVENT_MAP macro near the top of this module.
+ *  The event_list class is a receptable for MIDI events.  Three
+ *  implementations, an std::multimap, a sorted event_array, and the
+ *  original, an std::list, are provided for comparison, and are selected at
+ *  build time by the "--with-events" configure option, which defines the
+ *  SEQ64_USE_EVENT_MAP or SEQ64_USE_EVENT_ARRAY macro.
  */
 
 class event_list
@@ -138,6 +142,10 @@ public:
     typedef std::multimap<event_key, event> Events;
     typedef std::pair<event_key, event> EventsPair;
 
+#elif defined SEQ64_USE_EVENT_ARRAY
+
+    typedef event_array Events;
+
 #else   // use std::list here:
 
     typedef std::list<event> Events;
@@ -184,6 +192,17 @@ private:
 
     bool m_has_time_signature;
 
+    /**
+     *  Counts the changes (insertions, removals, sorts, merges,
+     *  assignments, and calls to modify()) made to the container.  Unlike
+     *  m_is_modified, this value is never reset, so that a client holding a
+     *  copy of the container (such as the playback snapshot of the sequence
+     *  class) can tell that the copy is out of date.  It is not copied
+     *  by the copy constructor or the assignment operator.
+     */
+
+    unsigned long m_generation;
+
 public:
 
     event_list ();
@@ -267,8 +286,8 @@ public:
 
     bool add (const event & e)
     {
-#ifdef SEQ64_USE_EVENT_MAP
-        return append(e);
+#if defined SEQ64_USE_EVENT_MAP || defined SEQ64_USE_EVENT_ARRAY
+        return append(e);               /* inserts in sorted order  */
 #else
         bool result = append(e);
         sort();                         /* by time-stamp and "rank" */
@@ -292,7 +311,8 @@ public:
 #else
 
     /**
-     *  Needed as a special case when std::list is used.
+     *  Needed as a special case when std::list is used.  The event_array
+     *  keeps the event in sorted order, after any equal events.
      *
      * \param e
      *      Provides the event value to push at the back of the event list.
@@ -301,6 +321,7 @@ public:
     void push_back (const event & e)
     {
         m_events.push_back(e);
+        ++m_generation;
     }
 
 #endif
@@ -314,6 +335,15 @@ public:
         return m_is_modified;
     }
 
+    /**
+     * \getter m_generation
+     */
+
+    unsigned long generation () const
+    {
+        return m_generation;
+    }
+
     /**
      * \getter m_has_tempo
      */
@@ -343,6 +373,18 @@ public:
         m_is_modified = false;
     }
 
+    /**
+     * \setter m_is_modified and m_generation
+     *      To be called when events are modified in place (data bytes or
+     *      time-stamps), which the container itself cannot detect.
+     */
+
+    void modify ()
+    {
+        m_is_modified = true;
+        ++m_generation;
+    }
+
     /**
      *  Provides a wrapper for the iterator form of erase(), which is the
      *  only one that sequence uses.  Currently, no check on removal is
@@ -356,6 +398,7 @@ public:
     {
         m_events.erase(ie);
         m_is_modified = true;
+        ++m_generation;
     }
 
     /**
@@ -366,6 +409,7 @@ public:
     {
         m_events.clear();
         m_is_modified = true;
+        ++m_generation;
     }
 
     void merge (event_list & el, bool presort = true);
@@ -380,6 +424,7 @@ public:
         // we need nothin' for sorting a multimap
 #else
         m_events.sort();
+        ++m_generation;
 #endif
     }
 
@@ -423,6 +468,8 @@ private:                                // functions for friend sequence
      */
 
     void link_new ();
+    void merge_recorded (const std::vector<event> & batch);
+    void link_recorded (iterator i);
     void clear_links ();
 #ifdef USE_FILL_TIME_SIG_AND_TEMPO
     void scan_meta_events ();
@@ -177,6 +177,13 @@ const int c_thread_trigger_width_ms = SEQ64_DEFAULT_TRIGWIDTH_MS;
 
 const int c_thread_trigger_width_us = SEQ64_DEFAULT_TRIGWIDTH_MS * 1000;
 
+/**
+ *  The longest sleep of the event-driven output scheduler, in microseconds.
+ *  This value is 50000 us.
+ */
+
+const int c_scheduler_max_sleep_us = SEQ64_SCHEDULER_MAX_SLEEP_MS * 1000;
+
 /*
  *  The trigger lookahead in milliseconds.  This value is 2 ms.  Not used
  *  anywhere, so commented out.
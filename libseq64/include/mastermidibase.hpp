@@ -36,11 +36,14 @@
  *  PortMidi.
  */
 
+#include <atomic>                       /* std::atomic<bool>                */
 #include <vector>                       /* for channel-filtered recording   */
 
 #include "businfo.hpp"                  /* seq64::businfo & busarray        */
+#include "midi_wakeup.hpp"              /* seq64::midi_wakeup               */
 #include "midibus_common.hpp"
 #include "mutex.hpp"
+#include "thru_map.hpp"                 /* seq64::thru_map                  */
 #include "user_midi_bus.hpp"
 
 /*
@@ -50,6 +53,7 @@
 namespace seq64
 {
     class event;
+    class midi_capture;
     class midibus;
     class sequence;
 
@@ -155,9 +159,53 @@ protected:
 
     sequence * m_seq;
 
+    /**
+     *  Set while a thread drains the output queues of the busses in flush().
+     *  A thread that finds it set does not wait; the draining thread checks
+     *  the queues again when it is done, and so plays its events.
+     */
+
+    std::atomic<bool> m_draining;
+
+    /**
+     *  The number of events submitted by play() since the buss was created.
+     *  Read by perform to count the events of each output pass.
+     */
+
+    std::atomic<unsigned long> m_play_count;
+
+    /**
+     *  If not null, play() records the events here, in place of the output
+     *  busses.  Set by perform::render_offline(), only while the output
+     *  thread is stopped.
+     */
+
+    midi_capture * m_capture;
+
+    /**
+     *  Wakes the input thread when input is queued.  Posted by the input
+     *  ports that can (see midi_in_jack), and polled by the ALSA code along
+     *  with its sequencer descriptors.  If no port arms it, the input thread
+     *  polls, as before.
+     */
+
+    midi_wakeup m_input_wakeup;
+
+    /**
+     *  The MIDI-thru routing table, read from rc().thru_routes() when the
+     *  object is created, and not changed after that.  Applied by the JACK
+     *  process callback when the API can do it (see api_routes_thru()), and
+     *  otherwise by thru().
+     */
+
+    thru_map m_thru_map;
+
     /**
      *  The locking mutex.  This object is passed to an automutex object that
-     *  lends exception-safety to the mutex locking.
+     *  lends exception-safety to the mutex locking.  It no longer guards the
+     *  playing of each event, which goes through the output queue of each
+     *  buss, but only the port configuration, the clock, and the draining of
+     *  the queues into the MIDI API.
      */
 
     mutex m_mutex;
@@ -294,22 +342,81 @@ public:
     void stop ();
     void port_start (int client, int port);
     void port_exit (int client, int port);
-    void play (bussbyte bus, event * e24, midibyte channel);
+    void play
+    (
+        bussbyte bus, event * e24, midibyte channel, long delay_us = 0
+    );
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
-    void emit_clock (midipulse tick);
+    void emit_clock
+    (
+        midipulse tick, const clock_schedule * schedule = nullptr
+    );
     void sysex (event * event);
     void print () const;
     void flush ();
+
+    /**
+     * \getter m_play_count
+     */
+
+    unsigned long play_count () const
+    {
+        return m_play_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \setter m_capture
+     *      Diverts the events played to a capture, or, given a null pointer,
+     *      back to the output busses.
+     */
+
+    void capture (midi_capture * mc)
+    {
+        m_capture = mc;
+    }
+
     void panic ();                                          /* kepler34 func  */
     void set_sequence_input (bool state, sequence * seq);
     void dump_midi_input (event in);                        /* seq32 function */
+    void flush_recording ();
 
     std::string get_midi_out_bus_name (bussbyte bus);
     std::string get_midi_in_bus_name (bussbyte bus);
 
     int poll_for_midi ();
     bool is_more_input ();
+
+    /**
+     * \getter m_input_wakeup
+     *      For the backends that post it or poll it.
+     */
+
+    midi_wakeup & input_wakeup ()
+    {
+        return m_input_wakeup;
+    }
+
+    /**
+     * \getter m_thru_map
+     */
+
+    const thru_map & thru_routes () const
+    {
+        return m_thru_map;
+    }
+
+    void thru (const event & ev);
+
+    /**
+     *  Wakes the input thread, so that it sees at once that it must exit.
+     */
+
+    void wake_input ()
+    {
+        m_input_wakeup.post();
+    }
+
     bool get_midi_event (event * in);
 
     bool set_clock (bussbyte bus, clock_e clock_type);
@@ -465,6 +572,16 @@ protected:
     virtual bool api_get_midi_event (event * inev) = 0;
     virtual int api_poll_for_midi ();
 
+    /**
+     *  Indicates if the MIDI API applies the thru routing table itself, as
+     *  soon as the input arrives.  If not, thru() applies it.
+     */
+
+    virtual bool api_routes_thru () const
+    {
+        return false;
+    }
+
 /*
  *  So far, there is no need for these API-specific functions.
  *
@@ -0,0 +1,150 @@
+#ifndef SEQ64_MIDI_CAPTURE_HPP
+#define SEQ64_MIDI_CAPTURE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_capture.hpp
+ *
+ *  This module declares/defines a timestamped stream of the events played
+ *  to the master buss, for rendering a song to a MIDI file.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-21
+ * \updates       2018-11-21
+ * \license       GNU GPLv2 or above
+ *
+ *  perform::render_offline() plays a song from a virtual clock, one tick
+ *  per pass, as fast as the patterns can be played.  While it does, the
+ *  master buss hands each event to a midi_capture, in place of the output
+ *  busses, and perform::set_beats_per_minute() hands it the tempo changes.
+ *  Each event is stamped with the tick of the pass.  midifile::write_capture()
+ *  then writes the stream as a flat SMF 1 file, with a tempo track and one
+ *  track per output buss.
+ */
+
+#include <vector>                       /* std::vector<>                    */
+
+#include "midi_out_queue.hpp"           /* seq64::midi_out_queue::item      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds the events captured from the master buss, in the order played.
+ */
+
+class midi_capture
+{
+
+public:
+
+    /**
+     *  Provides a captured event, or a tempo change.
+     */
+
+    struct item
+    {
+        midipulse mc_tick;              /**< The tick of the pass.          */
+        midibpm mc_tempo;               /**< Non-zero for a tempo change.   */
+        midi_out_queue::item mc_event;  /**< The event, as for a buss.      */
+        bussbyte mc_bus;                /**< The output buss of the event.  */
+    };
+
+private:
+
+    /**
+     *  The captured events, in the order played, so in order of tick.
+     */
+
+    std::vector<item> m_items;
+
+    /**
+     *  The tick stamped on the events now being played.
+     */
+
+    midipulse m_tick;
+
+    /**
+     *  The tempo in force at the start of the capture.
+     */
+
+    midibpm m_bpm;
+
+public:
+
+    midi_capture (midibpm bpm);
+
+    void add (bussbyte bus, const event & ev, midibyte channel);
+    void add_tempo (midibpm bpm);
+    int bus_count () const;
+
+    /**
+     * \setter m_tick
+     *      Sets the tick of the events played from now on.
+     */
+
+    void tick (midipulse t)
+    {
+        m_tick = t;
+    }
+
+    /**
+     * \getter m_tick
+     */
+
+    midipulse tick () const
+    {
+        return m_tick;
+    }
+
+    /**
+     * \getter m_bpm
+     */
+
+    midibpm bpm () const
+    {
+        return m_bpm;
+    }
+
+    /**
+     * \getter m_items
+     */
+
+    const std::vector<item> & items () const
+    {
+        return m_items;
+    }
+
+};          // class midi_capture
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDI_CAPTURE_HPP
+
+/*
+ * midi_capture.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
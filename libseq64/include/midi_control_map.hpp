@@ -0,0 +1,137 @@
+#ifndef SEQ64_MIDI_CONTROL_MAP_HPP
+#define SEQ64_MIDI_CONTROL_MAP_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_control_map.hpp
+ *
+ *  This module declares/defines the lookup table that dispatches incoming
+ *  events to the MIDI controls they trigger.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  perform::midi_control_event() used to check every incoming event against
+ *  the toggle, on, and off settings of all of the MIDI controls, some 250
+ *  comparisons per event, which adds up during a controller sweep.  A
+ *  control can only trigger on an event whose status and first data byte
+ *  match one of its settings, so the active settings are compiled into a
+ *  small open-addressed hash table keyed by those two bytes.  Each key holds
+ *  the numbers of the controls it can trigger, in ascending order, so that
+ *  they are handled in the same order as by the old loop.
+ *
+ *  The table is rebuilt by the thread that reads it, the input thread, when
+ *  perform is told that the [midi-control] settings have changed.
+ */
+
+#include "app_limits.h"                 /* SEQ64_MIDI_CONTROL_SLOTS         */
+#include "midi_control.hpp"             /* seq64::midi_control              */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Maps a status byte and first data byte to the MIDI controls that match
+ *  them.
+ */
+
+class midi_control_map
+{
+
+private:
+
+    /**
+     *  Provides one slot of the hash table.  An empty slot has no controls.
+     */
+
+    struct slot
+    {
+        unsigned sl_key;                /**< Status << 8 | data byte.       */
+        short sl_first;                 /**< First index in m_controls.     */
+        short sl_count;                 /**< Number of controls, or 0.      */
+    };
+
+    /**
+     *  The hash table, probed linearly.
+     */
+
+    slot m_slots[SEQ64_MIDI_CONTROL_SLOTS];
+
+    /**
+     *  The control numbers of all of the keys, grouped by key.  A control
+     *  appears at most once per key, even if more than one of its settings
+     *  uses the key, since perform::handle_midi_control_event() checks all
+     *  three.
+     */
+
+    short m_controls[3 * c_midi_controls_extended];
+
+public:
+
+    midi_control_map ();
+
+    void clear ();
+    void build
+    (
+        const midi_control * toggle,
+        const midi_control * on,
+        const midi_control * off,
+        int count
+    );
+    int lookup (midibyte status, midibyte d0, const short * & controls) const;
+
+private:
+
+    /**
+     *  Makes the key of a status and data byte.
+     */
+
+    static unsigned make_key (int status, int d0)
+    {
+        return (unsigned(status) << 8) | unsigned(d0);
+    }
+
+    /**
+     *  Hashes a key to its first slot, by Fibonacci hashing.
+     */
+
+    static int hash (unsigned key)
+    {
+        return int((key * 2654435761u) >> 16) & (SEQ64_MIDI_CONTROL_SLOTS - 1);
+    }
+
+};          // class midi_control_map
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDI_CONTROL_MAP_HPP
+
+/*
+ * midi_control_map.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
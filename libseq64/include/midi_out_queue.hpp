@@ -0,0 +1,164 @@
+#ifndef SEQ64_MIDI_OUT_QUEUE_HPP
+#define SEQ64_MIDI_OUT_QUEUE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_out_queue.hpp
+ *
+ *  This module declares/defines a lock-free submission queue for the events
+ *  to be sent on an output buss.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-16
+ * \updates       2018-11-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The output thread, the input thread (MIDI thru), and the user-interface
+ *  (note previews) can all play events on the same busses.  They used to
+ *  serialize on the mutex of the master buss for every event.  Now each
+ *  output buss has one of these queues.  Any thread can submit an event to
+ *  it without locking anything; the thread that flushes the master buss then
+ *  drains the queues of all the busses into the MIDI API, in the order in
+ *  which the events were submitted.  See mastermidibase::flush().
+ *
+ *  This is a bounded multiple-producer queue, with a sequence number in each
+ *  cell, as described by Dmitry Vyukov.  Only one thread drains it at a
+ *  time.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+
+#include "app_limits.h"                 /* SEQ64_OUTPUT_QUEUE_SIZE          */
+#include "event.hpp"                    /* SEQ64_MIDI_DATA_BYTE_COUNT       */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds the events submitted to an output buss, until they are drained.
+ */
+
+class midi_out_queue
+{
+
+public:
+
+    /**
+     *  Provides the compact form of a submitted channel event.  Its members
+     *  mirror the event members of the same name, plus the arguments of
+     *  midibase::play().
+     */
+
+    struct item
+    {
+        long oq_delay_us;           /**< The delay given to play().         */
+        midibyte oq_status;         /**< The status byte, without channel.  */
+        midibyte oq_channel;        /**< The channel of the event.          */
+        midibyte oq_data[SEQ64_MIDI_DATA_BYTE_COUNT];   /**< Data bytes.    */
+        midibyte oq_play_channel;   /**< The channel given to play().       */
+    };
+
+private:
+
+    /**
+     *  A slot of the queue.  The sequence number tells if the slot is free
+     *  for the producer of a given position, or filled for the consumer.
+     */
+
+    struct cell
+    {
+        std::atomic<unsigned> c_sequence;
+        item c_item;
+    };
+
+    /**
+     *  The number of cells, a power of 2.
+     */
+
+    const unsigned m_size;
+
+    /**
+     *  The cells, allocated once, in the constructor.
+     */
+
+    cell * m_cells;
+
+    /**
+     *  The position of the next cell to be filled, claimed by producers.
+     */
+
+    std::atomic<unsigned> m_enqueue_pos;
+
+    /**
+     *  The position of the next cell to be drained.  Used only by the
+     *  thread draining the queue.
+     */
+
+    std::atomic<unsigned> m_dequeue_pos;
+
+public:
+
+    midi_out_queue (unsigned size = SEQ64_OUTPUT_QUEUE_SIZE);
+    ~midi_out_queue ();
+
+    bool push (const event & e24, midibyte channel, long delay_us);
+    bool pop (item & it);
+
+    /**
+     *  Indicates if the queue may hold events.  Used by the draining thread,
+     *  and by a producer that has to check that its events get drained.
+     */
+
+    bool pending () const
+    {
+        return m_enqueue_pos.load() != m_dequeue_pos.load();
+    }
+
+    static void to_item
+    (
+        const event & e24, midibyte channel, long delay_us, item & it
+    );
+    static void to_event (const item & it, event & ev);
+
+private:
+
+    /*
+     * The queue holds atomics and owns its cells; it is never copied.
+     */
+
+    midi_out_queue (const midi_out_queue &);
+    midi_out_queue & operator = (const midi_out_queue &);
+
+};          // class midi_out_queue
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDI_OUT_QUEUE_HPP
+
+/*
+ * midi_out_queue.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,154 @@
+#ifndef SEQ64_MIDI_WAKEUP_HPP
+#define SEQ64_MIDI_WAKEUP_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_wakeup.hpp
+ *
+ *  This module declares/defines the object that wakes the MIDI input thread
+ *  when input arrives.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  The input thread used to poll the input busses, sleeping a millisecond
+ *  between polls, so that input waited up to a millisecond and the thread
+ *  woke a thousand times a second when there was none.  Now it blocks on a
+ *  midi_wakeup, and the code that queues the input posts it.  On Linux the
+ *  wakeup is an eventfd, elsewhere in POSIX a non-blocking pipe; either can
+ *  be added to a poll() set, as the ALSA code does with its sequencer
+ *  descriptors.  Posting is a single non-blocking write, so the JACK process
+ *  callback can do it.  Where there is neither, wait() sleeps a millisecond,
+ *  as before.
+ */
+
+#include <atomic>                       /* std::atomic<bool>                */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  A wakeup that one thread posts and another waits on.  Posts are not
+ *  counted:  any number of them, made before a wait(), end that wait.
+ */
+
+class midi_wakeup
+{
+
+private:
+
+    /**
+     *  The descriptor to poll and read.  For an eventfd, it is also the one
+     *  to write.  -1 if the wakeup could not be created.
+     */
+
+    int m_read_fd;
+
+    /**
+     *  The descriptor to write to post the wakeup.
+     */
+
+    int m_write_fd;
+
+    /**
+     *  True once a producer of input has undertaken to post the wakeup.
+     *  Until then, the input thread cannot count on being woken, and keeps
+     *  polling.
+     */
+
+    std::atomic<bool> m_armed;
+
+public:
+
+    midi_wakeup ();
+    ~midi_wakeup ();
+
+    void post ();
+    bool wait (int timeout_ms);
+    void drain ();
+
+    /**
+     * \getter m_read_fd
+     *      To add to a poll() set.  When it is readable, call drain().
+     */
+
+    int fd () const
+    {
+        return m_read_fd;
+    }
+
+    /**
+     * \getter m_read_fd
+     *      Checks that the wakeup was created.
+     */
+
+    bool valid () const
+    {
+        return m_read_fd >= 0;
+    }
+
+    /**
+     * \getter m_armed
+     */
+
+    bool armed () const
+    {
+        return m_armed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \setter m_armed
+     *      Called by a producer of input that will post the wakeup.  Has no
+     *      effect if the wakeup could not be created.
+     */
+
+    void arm ()
+    {
+        if (valid())
+            m_armed.store(true, std::memory_order_release);
+    }
+
+private:
+
+    /*
+     * The wakeup owns its descriptors; it is never copied.
+     */
+
+    midi_wakeup (const midi_wakeup &);
+    midi_wakeup & operator = (const midi_wakeup &);
+
+};          // class midi_wakeup
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDI_WAKEUP_HPP
+
+/*
+ * midi_wakeup.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
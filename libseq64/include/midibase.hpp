@@ -38,6 +38,7 @@
 #include "app_limits.h"                 /* SEQ64_USE_DEFAULT_PPQN       */
 #include "easy_macros.h"                /* for autoconf header files    */
 #include "mutex.hpp"
+#include "midi_out_queue.hpp"           /* seq64::midi_out_queue            */
 #include "midibus_common.hpp"
 #include "midibyte.hpp"                 /* seq64::midibyte typedef          */
 
@@ -47,6 +48,7 @@
 
 namespace seq64
 {
+    class clock_schedule;
     class event;
 
 /**
@@ -181,6 +183,14 @@ private:
 
     bool m_is_system_port;
 
+    /**
+     *  The lock-free queue to which the events for an output port are
+     *  submitted, until the master buss drains them.  Null for an input
+     *  port.  See submit() and drain().
+     */
+
+    midi_out_queue * m_out_queue;
+
     /**
      *  Locking mutex.
      */
@@ -492,12 +502,25 @@ public:
     bool deinit_in ();
     bool init_out_sub ();
     bool init_in_sub ();
-    void play (event * e24, midibyte channel);
+    void play (event * e24, midibyte channel, long delay_us = 0);
+    bool submit (event * e24, midibyte channel, long delay_us = 0);
+    void drain ();
+
+    /**
+     *  Indicates if events submitted to this buss may still be waiting in
+     *  its output queue.
+     */
+
+    bool pending () const
+    {
+        return not_nullptr(m_out_queue) && m_out_queue->pending();
+    }
+
     void sysex (event * e24);
     void flush ();
     void start ();
     void stop ();
-    void clock (midipulse tick);
+    void clock (midipulse tick, const clock_schedule * schedule = nullptr);
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void print ();
@@ -592,6 +615,35 @@ protected:
 
     virtual void api_play (event * e24, midibyte channel) = 0;
 
+    /**
+     *  Plays an event at the given time from now, for lookahead rendering.
+     *  A backend that cannot schedule its output sends the event
+     *  immediately, which is the behavior without lookahead.
+     *
+     *  The \a delay_us parameter, the delay in microseconds, is unused here.
+     */
+
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, long /* delay_us */
+    )
+    {
+        api_play(e24, channel);
+    }
+
+    /**
+     *  Sends a MIDI clock pulse at the given time from now, for scheduled
+     *  clock output.  A backend that cannot schedule its output sends the
+     *  pulse immediately.
+     *
+     *  The \a delay_us parameter, the delay in microseconds, is unused here.
+     */
+
+    virtual void api_clock_at (midipulse tick, long /* delay_us */)
+    {
+        api_clock(tick);
+    }
+
     /**
      *  Handles implementation details for SysEx messages.
      *
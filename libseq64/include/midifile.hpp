@@ -130,6 +130,7 @@ namespace seq64
      * Forward references.
      */
 
+    class midi_capture;
     class midi_splitter;
     class perform;
     class midi_vector;
@@ -304,6 +305,7 @@ public:
     virtual bool write (perform & p, bool doseqspec = true);
 
     bool write_song (perform & p);
+    bool write_capture (perform & p, const midi_capture & cap);
 
     /**
      * \getter m_error_message
@@ -469,6 +471,10 @@ protected:
     bool set_error_dump (const std::string & msg);
     bool set_error_dump (const std::string & msg, unsigned long p);
     void write_track (const midi_vector & lst);
+    void write_capture_track
+    (
+        perform & p, const midi_capture & cap, int bus
+    );
 
     /**
      *  Returns the size of a sequence-number event, which is always 5
@@ -27,7 +27,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2016-05-06
+ * \updates       2018-11-10
  * \license       GNU GPLv2 or above
  *
  *  This module defines the following classes:
@@ -41,6 +41,18 @@
 
 #include <pthread.h>
 
+#include "platform_macros.h"            /* PLATFORM_LINUX                   */
+
+/**
+ *  Defined if the condition_var measures the deadline of wait_until() with
+ *  CLOCK_MONOTONIC, which NTP and the user cannot step.  Otherwise the
+ *  deadline is measured by CLOCK_REALTIME, the default clock.
+ */
+
+#ifdef PLATFORM_LINUX
+#define SEQ64_CONDVAR_MONOTONIC
+#endif
+
 /*
  *  Do not document a namespace; it breaks Doxygen.
  */
@@ -79,6 +91,7 @@ public:
 
     mutex ();
     void lock () const;
+    bool try_lock () const;
     void unlock () const;
 
 };
@@ -160,7 +173,9 @@ public:
 
     condition_var ();
     void wait ();
+    bool wait_until (const struct timespec & deadline);
     void signal ();
+    void broadcast ();
 
 };
 
@@ -59,19 +59,27 @@
 
 #include "globals.h"                    /* globals, nullptr, & more         */
 #include "jack_assistant.hpp"           /* optional seq64::jack_assistant   */
+#include "clock_schedule.hpp"           /* seq64::clock_schedule            */
 #include "gui_assistant.hpp"            /* seq64::gui_assistant             */
 #include "keys_perform.hpp"             /* seq64::keys_perform              */
 #include "mastermidibus.hpp"            /* seq64::mastermidibus for ALSA    */
+#include "midi_capture.hpp"             /* seq64::midi_capture              */
 #include "midi_control.hpp"             /* seq64::midi_control "struct"     */
+#include "midi_control_map.hpp"         /* seq64::midi_control_map          */
 #include "playlist.hpp"                 /* seq64::playlist, 0.96 and above  */
+#include "render_pool.hpp"              /* seq64::render_pool               */
 #include "sequence.hpp"                 /* seq64::sequence                  */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
+#include "timing_histogram.hpp"         /* seq64::timing_histogram          */
 
 #ifdef SEQ64_SONG_BOX_SELECT
 #include <functional>                   /* std::function, function objects  */
 #include <set>                          /* std::set, arbitary selection     */
 #endif
 
+#include <atomic>                       /* std::atomic<>                    */
 #include <memory>                       /* std::unique_pt<>                 */
+#include <utility>                      /* std::pair<>                      */
 #include <vector>                       /* std::vector<>                    */
 #include <pthread.h>                    /* pthread_t C structure            */
 
@@ -252,6 +260,7 @@ struct performcallback
 
 class perform
 {
+    friend class benchmark;             // tests/seq64bench.cpp
     friend class jack_assistant;
     friend class keybindentry;
     friend class mainwnd;
@@ -268,6 +277,7 @@ class perform
     friend class wrkfile;
     friend void * input_thread_func (void * myperf);
     friend void * output_thread_func (void * myperf);
+    friend void render_thread_func (void * myperf, int index, int worker);
 
 #ifdef SEQ64_JACK_SUPPORT
 
@@ -944,6 +954,24 @@ private:
 
     midi_control m_midi_cc_off[c_midi_controls_extended];
 
+    /**
+     *  Maps the status and first data byte of an incoming event to the
+     *  controls in the three arrays above that it can trigger, so that
+     *  midi_control_event() need not check them all.  Accessed only by the
+     *  input thread.
+     */
+
+    midi_control_map m_midi_control_map;
+
+    /**
+     *  Set by the set_midi_control_toggle(), set_midi_control_on(), and
+     *  set_midi_control_off() setters when the settings of the MIDI controls
+     *  are modified.  The next call to midi_control_event() then rebuilds
+     *  m_midi_control_map.
+     */
+
+    std::atomic<bool> m_midi_control_dirty;
+
     /**
      *  Holds the OR'ed control status values.  Need to learn more about this
      *  one.  It is used in the replace, snapshot, and queue functionality.
@@ -1026,6 +1054,207 @@ private:
 
     int m_sequence_high;
 
+    /**
+     *  The dense list of patterns for which play() calls play_queue() on
+     *  every tick:  those that are playing, queued, or in song mode have
+     *  triggers ahead of the current position.  Muted, idle patterns are
+     *  parked (see sequence::park()) and dropped from this list, so that the
+     *  per-tick work scales with the number of active patterns rather than
+     *  with m_sequence_high.  Accessed only by the output thread.
+     */
+
+    std::vector<sequence *> m_active_seqs;
+
+    /**
+     *  Set by wake_sequences() when a parked pattern might need to be played
+     *  again, or when a pattern is installed or deleted.  The next call to
+     *  play() then rebuilds m_active_seqs from all of the patterns.
+     */
+
+    std::atomic<bool> m_active_seqs_dirty;
+
+    /**
+     *  The playback mode for which m_active_seqs was built.  A change of mode
+     *  changes which patterns have to be played, and forces a rebuild.
+     */
+
+    bool m_active_seqs_mode;
+
+    /**
+     *  The patterns removed by delete_sequence() or install_sequence() that
+     *  m_active_seqs might still hold, each with the value of m_seqs_retire
+     *  at its removal.  A pattern is deleted only once the output thread has
+     *  rebuilt m_active_seqs after its removal.  Accessed only by the
+     *  user-interface thread and the destructor.
+     */
+
+    std::vector<std::pair<sequence *, unsigned long>> m_seqs_retired;
+
+    /**
+     *  Incremented when a pattern is retired, after its pointer is removed
+     *  from m_seqs.
+     */
+
+    std::atomic<unsigned long> m_seqs_retire;
+
+    /**
+     *  The value of m_seqs_retire read by rebuild_active_seqs() before it
+     *  read m_seqs, stored once the rebuild is done.  The patterns retired
+     *  at or before this value are no longer in m_active_seqs.
+     */
+
+    std::atomic<unsigned long> m_seqs_retire_ack;
+
+    /**
+     *  The lateness of the last wake-up of the output thread, in
+     *  microseconds, measured against its absolute deadline on
+     *  CLOCK_MONOTONIC.  Measured only when rc().absolute_timing() is true,
+     *  and reset when playback starts.
+     */
+
+    std::atomic<long> m_wake_lateness_us;
+
+    /**
+     *  The largest value of m_wake_lateness_us since playback started.
+     */
+
+    std::atomic<long> m_max_wake_lateness_us;
+
+    /**
+     *  The lookahead window of the current play() pass, in ticks.  Zero if
+     *  rc().lookahead_ms() is zero.  Used only by the output thread.
+     */
+
+    midipulse m_lookahead_ticks;
+
+    /**
+     *  The lookahead window of the current play() pass, in microseconds.
+     */
+
+    long m_lookahead_us;
+
+    /**
+     *  The end tick of the last lookahead window rendered by play().  It is
+     *  kept so that the window never moves backward when the tempo drops,
+     *  which would play some events twice.
+     */
+
+    midipulse m_render_tick;
+
+    /**
+     *  The length of a tick, in microseconds, at the tempo of the current
+     *  play() pass.  Converts the tick of a lookahead event to its delay.
+     */
+
+    double m_render_us_per_tick;
+
+    /**
+     *  The tempo map of the song, built from the Set Tempo events of all of
+     *  the patterns (see rebuild_tempo_map()).  It is never modified once
+     *  published; a new map is swapped in, so that the output thread, the
+     *  JACK callbacks, and the time displays can read it without a lock.
+     */
+
+    std::atomic<tempo_map *> m_tempo_map;
+
+    /**
+     *  The number of readers using m_tempo_map.  A replaced map is deleted
+     *  only when this count is seen to be zero.
+     */
+
+    std::atomic<int> m_tempo_map_readers;
+
+    /**
+     *  The replaced maps that might still be in use by a reader.
+     */
+
+    std::vector<tempo_map *> m_tempo_map_retired;
+
+    /**
+     *  Serializes the rebuilding of the tempo map, and protects
+     *  m_tempo_map_retired.
+     */
+
+    mutex m_tempo_map_mutex;
+
+    /**
+     *  The worker threads that render the active patterns when there are
+     *  many of them, if rc().render_threads() is greater than 1.  Created
+     *  and deleted by the output thread, in output_func().
+     */
+
+    render_pool * m_render_pool;
+
+    /**
+     *  The results of sequence::park() for the patterns of a parallel pass,
+     *  in the order of m_active_seqs.  Each renderer writes only the flags of
+     *  the patterns it claims.
+     */
+
+    std::vector<char> m_render_parked;
+
+    /**
+     *  The end tick of the current parallel pass.
+     */
+
+    midipulse m_render_play_tick;
+
+    /**
+     *  If not null, an offline render is in progress, and the events and
+     *  tempo changes played go to this capture.  See render_offline().
+     */
+
+    midi_capture * m_offline_capture;
+
+    /**
+     *  If true, the output loop records its timing in the histograms below.
+     *  Can be switched at any time; see timing_stats().
+     */
+
+    std::atomic<bool> m_timing_stats;
+
+    /**
+     *  The duration of the work of each pass of the output loop, in
+     *  microseconds.
+     */
+
+    timing_histogram m_loop_histogram;
+
+    /**
+     *  How late the output thread wakes up after its sleep, in microseconds.
+     */
+
+    timing_histogram m_lateness_histogram;
+
+    /**
+     *  The number of events played by each pass of play().
+     */
+
+    timing_histogram m_events_histogram;
+
+    /**
+     *  The delays of the MIDI clock pulses of the current pass of the output
+     *  loop, computed from the tempo map, and the measurement of the clock
+     *  skew and jitter.  Built only by the output thread; see
+     *  emit_scheduled_clock().
+     */
+
+    clock_schedule m_clock_schedule;
+
+    /**
+     *  The magnitude of the jitter of each MIDI clock pulse, in
+     *  microseconds.
+     */
+
+    timing_histogram m_clock_histogram;
+
+    /**
+     *  The number of passes whose work, or whose wake-up lateness, exceeded
+     *  the trigger width of the output loop.
+     */
+
+    std::atomic<unsigned long> m_underruns;
+
 #ifdef SEQ64_EDIT_SEQUENCE_HIGHLIGHT
 
     /**
@@ -2037,6 +2266,162 @@ public:
 
     void set_tick (midipulse tick);
 
+    /**
+     *  Tells play() to rebuild its list of active patterns on the next tick.
+     *  Called by a parked sequence whose status changes, and when patterns
+     *  are added or removed.
+     */
+
+    void wake_sequences ()
+    {
+        m_active_seqs_dirty = true;
+        wake_output();
+    }
+
+    void wake_output ();
+
+    /**
+     * \getter m_wake_lateness_us
+     */
+
+    long wake_lateness_us () const
+    {
+        return m_wake_lateness_us;
+    }
+
+    /**
+     * \getter m_max_wake_lateness_us
+     */
+
+    long max_wake_lateness_us () const
+    {
+        return m_max_wake_lateness_us;
+    }
+
+    /**
+     * \getter m_lookahead_us
+     */
+
+    long lookahead_us () const
+    {
+        return m_lookahead_us;
+    }
+
+    /**
+     * \getter m_timing_stats
+     */
+
+    bool timing_stats () const
+    {
+        return m_timing_stats;
+    }
+
+    /**
+     * \setter m_timing_stats
+     *      Starts or stops the recording of the output loop timing.  The
+     *      histograms are kept; see reset_timing_stats().
+     */
+
+    void timing_stats (bool flag)
+    {
+        m_timing_stats = flag;
+    }
+
+    /**
+     * \getter m_loop_histogram
+     */
+
+    const timing_histogram & loop_histogram () const
+    {
+        return m_loop_histogram;
+    }
+
+    /**
+     * \getter m_lateness_histogram
+     */
+
+    const timing_histogram & lateness_histogram () const
+    {
+        return m_lateness_histogram;
+    }
+
+    /**
+     * \getter m_events_histogram
+     */
+
+    const timing_histogram & events_histogram () const
+    {
+        return m_events_histogram;
+    }
+
+    /**
+     * \getter m_clock_histogram
+     */
+
+    const timing_histogram & clock_histogram () const
+    {
+        return m_clock_histogram;
+    }
+
+    /**
+     *  Gets the drift of the MIDI clock since playback started, as measured
+     *  by m_clock_schedule.  Positive if the clock runs late.
+     */
+
+    long clock_skew_us () const
+    {
+        return m_clock_schedule.skew_us();
+    }
+
+    /**
+     *  Gets the error of the last interval between MIDI clock pulses.
+     */
+
+    long clock_jitter_us () const
+    {
+        return m_clock_schedule.jitter_us();
+    }
+
+    /**
+     *  Gets the largest error of an interval between MIDI clock pulses,
+     *  since reset_timing_stats().
+     */
+
+    long max_clock_jitter_us () const
+    {
+        return m_clock_schedule.max_jitter_us();
+    }
+
+    /**
+     * \getter m_underruns
+     */
+
+    unsigned long underruns () const
+    {
+        return m_underruns;
+    }
+
+    void reset_timing_stats ();
+    std::string timing_report () const;
+
+    /**
+     *  Calculates how long from now an event rendered by the current play()
+     *  pass is to be sent.  Called by sequence::play() on the output thread.
+     *
+     * \param tick
+     *      The global tick of the event.
+     *
+     * \return
+     *      Returns the delay in microseconds, or 0 if the event is due now,
+     *      or if lookahead is disabled.
+     */
+
+    long render_delay_us (midipulse tick) const
+    {
+        return (m_lookahead_ticks > 0 && tick > m_tick) ?
+            long((tick - m_tick) * m_render_us_per_tick) : 0 ;
+    }
+
     /**
      * \getter m_jack_tick
      */
@@ -2921,6 +3306,13 @@ public:         // GUI-support functions
 
     void set_beats_per_minute (midibpm bpm);    /* more than just a setter  */
     void set_ppqn (int p);
+    void rebuild_tempo_map ();
+    bool tempo_map_active ();
+    double tick_to_us (double tick);
+    double us_to_tick (double us);
+    midibpm tempo_at (double tick);
+    std::string pulses_to_timestring (midipulse tick, bool showus = true);
+    bool render_offline (const std::string & filename, std::string & errmsg);
     void panic ();                              /* from kepler43        */
 
 private:
@@ -2957,9 +3349,12 @@ private:
         is_modified(true);
     }
 
-    midi_control & midi_control_toggle (int ctl);
-    midi_control & midi_control_on (int ctl);
-    midi_control & midi_control_off (int ctl);
+    const midi_control & midi_control_toggle (int ctl) const;
+    const midi_control & midi_control_on (int ctl) const;
+    const midi_control & midi_control_off (int ctl) const;
+    void set_midi_control_toggle (int ctl, const midi_control & mc);
+    void set_midi_control_on (int ctl, const midi_control & mc);
+    void set_midi_control_off (int ctl, const midi_control & mc);
     bool midi_control_event (const event & ev);
     bool midi_control_record (const event & ev);
     bool handle_midi_control (int control, bool state);
@@ -3121,6 +3516,22 @@ private:
     }
 
     bool install_sequence (sequence * seq, int seqnum);
+    void rebuild_active_seqs ();
+    void retire_sequence (sequence * s);
+    void delete_retired_sequences (bool all = false);
+    midipulse next_due_tick (midipulse tick);
+    long scheduler_sleep_us (const jack_scratchpad & pad, midibpm bpm);
+    bool sends_clock ();
+    void emit_scheduled_clock (const jack_scratchpad & pad, long long pass_us);
+    bool advance_tempo_map
+    (
+        double current, double & expected, double & map_us,
+        long elapsed_us, double & tick, midibpm & bpm
+    );
+    void delete_retired_tempo_maps ();
+    void play_parallel (midipulse tick);
+    void record_lateness (long late_us);
+    void render_sequence (int index, int worker);
     void inner_start (bool state);
     void inner_stop (bool midiclock = false);
     int clamp_track (int track) const;
@@ -3310,6 +3721,7 @@ private:
 
 extern void * output_thread_func (void * p);
 extern void * input_thread_func (void * p);
+extern void render_thread_func (void * p, int index, int worker);
 
 }           // namespace seq64
 
@@ -0,0 +1,217 @@
+#ifndef SEQ64_PLAYBACK_EVENTS_HPP
+#define SEQ64_PLAYBACK_EVENTS_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playback_events.hpp
+ *
+ *  This module declares/defines a read-only snapshot of the playable events
+ *  of a sequence, for use by the output thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-10
+ * \updates       2018-11-10
+ * \license       GNU GPLv2 or above
+ *
+ *  The event_list of a sequence is edited by the user-interface, the
+ *  recording code, and the MIDI-file code, all under the sequence mutex.
+ *  The output thread used to take the same mutex on every tick, so that a
+ *  long edit (paste, quantize, a big undo) stalled playback.
+ *
+ *  Instead, every time an edit of the event list finishes, the sequence
+ *  builds one of these objects from its event list and publishes it by
+ *  swapping an atomic pointer.  The output thread reads the current
+ *  snapshot without locking anything.  A snapshot is never modified after
+ *  it is built; the old one is deleted by the editing side once no reader
+ *  can still be using it.  See sequence::publish_playback().
+ */
+
+#include <vector>                       /* std::vector<>                */
+
+#include "event_list.hpp"               /* seq64::event_list, event     */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds a compact, contiguous, time-sorted copy of the events of a sequence
+ *  that can be played.  SysEx and Meta events are dropped, except for Set
+ *  Tempo events, which are reduced to their beats-per-minute value.
+ */
+
+class playback_events
+{
+
+public:
+
+    /**
+     *  Provides the compact form of a playable event.  Its members mirror
+     *  the event members of the same name.
+     */
+
+    struct item
+    {
+        midipulse pe_timestamp;     /**< The time-stamp of the event.       */
+        midibpm pe_tempo;           /**< Non-zero only for a tempo event.   */
+        midibyte pe_status;         /**< The status byte, without channel.  */
+        midibyte pe_channel;        /**< The channel, or the Meta type.     */
+        midibyte pe_data[SEQ64_MIDI_DATA_BYTE_COUNT];   /**< Data bytes.    */
+
+        /**
+         *  Indicates a Set Tempo event, the only kind of Meta event kept in
+         *  the snapshot.
+         */
+
+        bool is_tempo () const
+        {
+            return pe_status == EVENT_MIDI_META;
+        }
+
+        /**
+         *  Indicates a note event, including Aftertouch, just like
+         *  event::is_note().
+         */
+
+        bool is_note () const
+        {
+            return event::is_note_msg(pe_status);
+        }
+    };
+
+    /**
+     *  The contiguous container of items, sorted by time-stamp and rank.
+     */
+
+    typedef std::vector<item> Items;
+
+private:
+
+    /**
+     *  The items of the snapshot.
+     */
+
+    Items m_items;
+
+    /**
+     *  The event_list::generation() value of the event list from which the
+     *  snapshot was built.  Since a snapshot is published only after the
+     *  event list changes, this value identifies the snapshot, and lets the
+     *  playback cursor of the sequence detect a newly-published snapshot.
+     */
+
+    unsigned long m_generation;
+
+    /**
+     *  The length of the sequence when the snapshot was built.  It is
+     *  published with the events, so that play() never combines a new length
+     *  with the events of an older snapshot.
+     */
+
+    midipulse m_length;
+
+    /**
+     *  The number of Set Tempo items, so that a snapshot that affects the
+     *  tempo map of the song is detected without a scan.
+     */
+
+    int m_tempo_count;
+
+public:
+
+    playback_events ();
+    playback_events
+    (
+        const event_list & evl, unsigned long generation, midipulse len
+    );
+
+    /**
+     * \getter m_generation
+     */
+
+    unsigned long generation () const
+    {
+        return m_generation;
+    }
+
+    /**
+     * \getter m_length
+     */
+
+    midipulse length () const
+    {
+        return m_length;
+    }
+
+    /**
+     *  Returns the number of items, as an integer.
+     */
+
+    int count () const
+    {
+        return int(m_items.size());
+    }
+
+    /**
+     * \getter m_tempo_count
+     */
+
+    int tempo_count () const
+    {
+        return m_tempo_count;
+    }
+
+    /**
+     *  Returns the item at the given index, which is not validated.
+     */
+
+    const item & at (int index) const
+    {
+        return m_items[index];
+    }
+
+    int lower_bound (midipulse tick) const;
+    void to_event (int index, event & ev) const;
+
+private:
+
+    /*
+     * A snapshot is immutable and owned through a pointer; it is never
+     * copied.
+     */
+
+    playback_events (const playback_events &);
+    playback_events & operator = (const playback_events &);
+
+};          // class playback_events
+
+}           // namespace seq64
+
+#endif      // SEQ64_PLAYBACK_EVENTS_HPP
+
+/*
+ * playback_events.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
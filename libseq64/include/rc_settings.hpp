@@ -46,6 +46,7 @@
 
 #include <string>
 
+#include "app_limits.h"                 /* SEQ64_LOOKAHEAD_MAX_MS       */
 #include "seq64_features.h"             /* SEQ64_USE_ZOOM_POWER_OF_2    */
 #include "recent.hpp"                   /* seq64::recent class          */
 
@@ -96,6 +97,30 @@ enum mute_group_handling_t
     e_mute_group_max            /**< Keep this last... a size value.        */
 };
 
+/**
+ *  Provides mutually-exclusive codes for the way the output thread
+ *  (perform::output_func()) decides when to wake up.  Selectable with the
+ *  "-o scheduler=poll|event" option, so that the timing jitter of the two
+ *  can be compared.
+ *
+ *  e_scheduler_poll:
+ *  The legacy loop, which wakes up every c_thread_trigger_width_us (or
+ *  sooner, for the next MIDI clock), whether or not anything is due.
+ *
+ *  e_scheduler_event:
+ *  The output thread computes the next tick at which something is due (an
+ *  event of a playing pattern, a queued or trigger change, the next MIDI
+ *  clock pulse, or the loop end) and sleeps until exactly then, unless
+ *  woken sooner by a change in the patterns.
+ */
+
+enum output_scheduler_t
+{
+    e_scheduler_poll,           /**< Wake up every trigger-width interval.  */
+    e_scheduler_event,          /**< Wake up at the next due event.         */
+    e_scheduler_max             /**< Keep this last... a size value.        */
+};
+
 /**
  *  This class contains the options formerly named "global_xxxxxx".  It gives
  *  us a whole lot more encapsulation and control over how the options of the
@@ -110,6 +135,7 @@ class rc_settings
     friend class mainwnd;
     friend class rtmidi_info;
     friend int parse_command_line_options (perform &, int , char * []);
+    friend bool parse_o_options (int, char * []);
     friend bool help_check (int, char * []);
 
 private:
@@ -138,6 +164,13 @@ private:
     bool m_show_midi;               /**< Show MIDI events to console.       */
     bool m_priority;                /**< Run at high priority (Linux only). */
     bool m_stats;                   /**< Show some output statistics.       */
+    output_scheduler_t m_output_scheduler;  /**< Output-thread wake-up.     */
+    bool m_absolute_timing;         /**< Monotonic, absolute-deadline loop. */
+    int m_lookahead_ms;             /**< Render window ahead of playback.   */
+    int m_input_queue_size;         /**< Slots in a MIDI input queue.       */
+    int m_render_threads;           /**< Threads that render the patterns.  */
+    bool m_timing_histograms;       /**< Measure the output loop timing.    */
+    int m_null_midi_ports;          /**< Output ports of the null backend.  */
     bool m_pass_sysex;              /**< Pass SysEx to outputs, not ready.  */
     bool m_with_jack_transport;     /**< Enable synchrony with JACK.        */
     bool m_with_jack_master;        /**< Serve as a JACK transport Master.  */
@@ -164,6 +197,38 @@ private:
 
     std::string m_jack_session_uuid;
 
+    /**
+     *  Holds the name of the MIDI file to which seq64cli renders the song,
+     *  faster than real time, instead of playing it.  Set by the "-o
+     *  render=filename" option; empty if not rendering.
+     */
+
+    std::string m_render_filename;
+
+    /**
+     *  Holds the name of the file to which the null MIDI backend writes the
+     *  events it captured, when the application exits.  Set by the "-o
+     *  capture=filename" option; empty if the capture is not written.
+     */
+
+    std::string m_null_capture_filename;
+
+    /**
+     *  Holds the name of the script of timed input events that the null MIDI
+     *  backend injects.  Set by the "-o inject=filename" option; empty if no
+     *  input is injected.
+     */
+
+    std::string m_null_inject_filename;
+
+    /**
+     *  Holds the MIDI-thru routing table, as given by the "-o thru=routes"
+     *  option; empty if no input is routed.  See the thru_map module for the
+     *  format.
+     */
+
+    std::string m_thru_routes;
+
     /**
      *  Holds the directory from which the last MIDI file was opened (or
      *  saved).
@@ -403,6 +468,94 @@ public:
         return m_stats;
     }
 
+    /**
+     * \getter m_output_scheduler
+     */
+
+    output_scheduler_t output_scheduler () const
+    {
+        return m_output_scheduler;
+    }
+
+    /**
+     * \getter m_absolute_timing
+     *      If true, the output thread computes every tick from the absolute
+     *      time elapsed on CLOCK_MONOTONIC since playback started, and sleeps
+     *      until absolute deadlines, so that timing errors do not accumulate.
+     */
+
+    bool absolute_timing () const
+    {
+        return m_absolute_timing;
+    }
+
+    /**
+     * \getter m_lookahead_ms
+     *      If not zero, events are rendered this many milliseconds ahead of
+     *      the playback position and handed to the MIDI backend with the
+     *      delay at which they are to be sent.
+     */
+
+    int lookahead_ms () const
+    {
+        return m_lookahead_ms;
+    }
+
+    /**
+     * \getter m_input_queue_size
+     *      The number of messages that the MIDI input queue of a port can
+     *      hold before incoming messages are dropped.
+     */
+
+    int input_queue_size () const
+    {
+        return m_input_queue_size;
+    }
+
+    /**
+     * \getter m_render_threads
+     *      The number of threads, including the output thread, that render
+     *      the patterns during playback.  1 (the default) renders them all
+     *      on the output thread.
+     */
+
+    int render_threads () const
+    {
+        return m_render_threads;
+    }
+
+    /**
+     * \getter m_timing_histograms
+     *      If true, the output loop records its timing in histograms from
+     *      the start.  See perform::timing_stats().
+     */
+
+    bool timing_histograms () const
+    {
+        return m_timing_histograms;
+    }
+
+    /**
+     * \getter m_null_midi_ports
+     *      The number of output ports of the null MIDI backend, or 0 if a
+     *      real MIDI backend is used.
+     */
+
+    int null_midi_ports () const
+    {
+        return m_null_midi_ports;
+    }
+
+    /**
+     * \getter m_null_midi_ports
+     *      If true, the null MIDI backend replaces ALSA and JACK.
+     */
+
+    bool with_null_midi () const
+    {
+        return m_null_midi_ports > 0;
+    }
+
     /**
      * \getter m_pass_sysex
      */
@@ -558,6 +711,42 @@ public:
         return m_jack_session_uuid;
     }
 
+    /**
+     * \getter m_render_filename
+     */
+
+    const std::string & render_filename () const
+    {
+        return m_render_filename;
+    }
+
+    /**
+     * \getter m_null_capture_filename
+     */
+
+    const std::string & null_capture_filename () const
+    {
+        return m_null_capture_filename;
+    }
+
+    /**
+     * \getter m_null_inject_filename
+     */
+
+    const std::string & null_inject_filename () const
+    {
+        return m_null_inject_filename;
+    }
+
+    /**
+     * \getter m_thru_routes
+     */
+
+    const std::string & thru_routes () const
+    {
+        return m_thru_routes;
+    }
+
     /**
      * \getter m_last_used_dir
      */
@@ -825,6 +1014,120 @@ protected:
         m_stats = flag;
     }
 
+    /**
+     * \setter m_output_scheduler
+     */
+
+    void output_scheduler (output_scheduler_t s)
+    {
+        if (s >= e_scheduler_poll && s < e_scheduler_max)
+            m_output_scheduler = s;
+    }
+
+    /**
+     * \setter m_absolute_timing
+     */
+
+    void absolute_timing (bool flag)
+    {
+        m_absolute_timing = flag;
+    }
+
+    /**
+     * \setter m_lookahead_ms
+     *      The value is ignored if outside the range 0 to
+     *      SEQ64_LOOKAHEAD_MAX_MS.
+     */
+
+    void lookahead_ms (int ms)
+    {
+        if (ms >= 0 && ms <= SEQ64_LOOKAHEAD_MAX_MS)
+            m_lookahead_ms = ms;
+    }
+
+    /**
+     * \setter m_input_queue_size
+     *      The value is ignored if outside the range 1 to
+     *      SEQ64_INPUT_QUEUE_SIZE_MAX.
+     */
+
+    void input_queue_size (int count)
+    {
+        if (count > 0 && count <= SEQ64_INPUT_QUEUE_SIZE_MAX)
+            m_input_queue_size = count;
+    }
+
+    /**
+     * \setter m_render_threads
+     *      The value is ignored if outside the range 1 to
+     *      SEQ64_RENDER_THREADS_MAX.
+     */
+
+    void render_threads (int count)
+    {
+        if (count > 0 && count <= SEQ64_RENDER_THREADS_MAX)
+            m_render_threads = count;
+    }
+
+    /**
+     * \setter m_timing_histograms
+     */
+
+    void timing_histograms (bool flag)
+    {
+        m_timing_histograms = flag;
+    }
+
+    /**
+     * \setter m_render_filename
+     */
+
+    void render_filename (const std::string & value)
+    {
+        m_render_filename = value;
+    }
+
+    /**
+     * \setter m_null_midi_ports
+     *
+     * \param count
+     *      The number of output ports, from 1 to SEQ64_NULL_PORTS_MAX, or 0
+     *      to use a real MIDI backend.  Other values are ignored.
+     */
+
+    void null_midi_ports (int count)
+    {
+        if (count >= 0 && count <= SEQ64_NULL_PORTS_MAX)
+            m_null_midi_ports = count;
+    }
+
+    /**
+     * \setter m_null_capture_filename
+     */
+
+    void null_capture_filename (const std::string & value)
+    {
+        m_null_capture_filename = value;
+    }
+
+    /**
+     * \setter m_null_inject_filename
+     */
+
+    void null_inject_filename (const std::string & value)
+    {
+        m_null_inject_filename = value;
+    }
+
+    /**
+     * \setter m_thru_routes
+     */
+
+    void thru_routes (const std::string & value)
+    {
+        m_thru_routes = value;
+    }
+
     /**
      * \setter m_pass_sysex
      */
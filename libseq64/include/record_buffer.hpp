@@ -0,0 +1,135 @@
+#ifndef SEQ64_RECORD_BUFFER_HPP
+#define SEQ64_RECORD_BUFFER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          record_buffer.hpp
+ *
+ *  This module declares/defines the buffer that holds the events recorded
+ *  into a pattern until they are merged into it.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  sequence::stream_event() used to lock the pattern for each recorded
+ *  event, add it (re-sorting the whole std::list), link all of the notes of
+ *  the pattern, and perhaps quantize.  A dense controller or pitch-bend
+ *  sweep recorded into a long pattern got slower with every event, until it
+ *  starved the input thread.  Now the input thread only pushes the event
+ *  into the pattern's record_buffer, without locking.  The events are merged
+ *  into the pattern in sorted batches by sequence::flush_recording(), which
+ *  links only the new notes.
+ *
+ *  This is a single-producer, single-consumer ring.  The producer is the
+ *  input thread.  The consumer is whichever thread flushes the recording;
+ *  it does so while holding the lock of the pattern, so there is only ever
+ *  one at a time.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+
+#include "app_limits.h"                 /* SEQ64_RECORD_BUFFER_SIZE         */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event;
+
+/**
+ *  Holds the events recorded into a pattern, in the order received.
+ */
+
+class record_buffer
+{
+
+private:
+
+    /**
+     *  The number of slots, a power of 2.
+     */
+
+    const unsigned m_size;
+
+    /**
+     *  The slots, allocated once, in the constructor.
+     */
+
+    event * m_events;
+
+    /**
+     *  The position of the next event to be taken.  Written only by the
+     *  consumer.
+     */
+
+    std::atomic<unsigned> m_front;
+
+    /**
+     *  The position of the next event to be added.  Written only by the
+     *  producer.
+     */
+
+    std::atomic<unsigned> m_back;
+
+public:
+
+    record_buffer (unsigned size = SEQ64_RECORD_BUFFER_SIZE);
+    ~record_buffer ();
+
+    bool push (const event & ev);
+    bool pop (event & ev);
+    void clear ();
+
+    /**
+     *  Indicates if events are waiting to be merged.
+     */
+
+    bool empty () const
+    {
+        return
+            m_front.load(std::memory_order_acquire) ==
+            m_back.load(std::memory_order_acquire);
+    }
+
+private:
+
+    /*
+     * The buffer holds atomics and owns its slots; it is never copied.
+     */
+
+    record_buffer (const record_buffer &);
+    record_buffer & operator = (const record_buffer &);
+
+};          // class record_buffer
+
+}           // namespace seq64
+
+#endif      // SEQ64_RECORD_BUFFER_HPP
+
+/*
+ * record_buffer.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,290 @@
+#ifndef SEQ64_RENDER_POOL_HPP
+#define SEQ64_RENDER_POOL_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          render_pool.hpp
+ *
+ *  This module declares/defines a pool of worker threads that render the
+ *  patterns of a playback pass in parallel.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-19
+ * \updates       2018-11-19
+ * \license       GNU GPLv2 or above
+ *
+ *  perform::play() renders every active pattern on the output thread.  With
+ *  hundreds of dense patterns playing, that one thread saturates a core.
+ *  When "-o threads=n" is given, the output thread creates n - 1 workers,
+ *  and hands the active patterns of each pass to them.  The output thread
+ *  works on the pass as well, so that there are n renderers.
+ *
+ *  Each renderer takes the next unclaimed pattern from a shared counter, so
+ *  that a renderer that finishes early takes more of the patterns.  The
+ *  events that a pattern plays are not put on the busses, but recorded in
+ *  the render_buffer of its renderer.  Once all of the patterns are
+ *  rendered, merge() sorts the events of all of the buffers by delay, buss,
+ *  position of the pattern in the pass, and order of play, so that the
+ *  output does not depend on which renderer took which pattern.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector<>                    */
+#include <pthread.h>                    /* pthread_t                        */
+
+#include "midi_out_queue.hpp"           /* seq64::midi_out_queue::item      */
+#include "mutex.hpp"                    /* seq64::condition_var             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Provides an event recorded by a render_buffer, with its merge keys.
+ */
+
+struct render_item
+{
+    midi_out_queue::item ri_event;  /**< The event, as for a buss queue.    */
+    midibpm ri_tempo;               /**< Non-zero for a Set Tempo event.    */
+    int ri_order;                   /**< The pattern's position in the pass. */
+    int ri_index;                   /**< The order of play in the buffer.   */
+    bussbyte ri_bus;                /**< The output buss of the event.      */
+};
+
+/**
+ *  Holds the events played by the patterns that one renderer rendered in
+ *  the current pass.  Used only by the thread that owns it, until the pass
+ *  is merged.
+ */
+
+class render_buffer
+{
+
+private:
+
+    /**
+     *  The recorded events, in the order played.
+     */
+
+    std::vector<render_item> m_items;
+
+    /**
+     *  The position, in the pass, of the pattern being rendered.
+     */
+
+    int m_order;
+
+    /**
+     *  The thread rendering into this buffer.  Events played by any other
+     *  thread, such as a user-interface thread muting a pattern, are not
+     *  recorded, but go to the busses as usual.
+     */
+
+    pthread_t m_owner;
+
+public:
+
+    render_buffer ();
+
+    void start (int order);
+    bool is_owner () const;
+    void add (bussbyte bus, const event & ev, midibyte channel, long delay_us);
+    void add_tempo (midibpm bpm);
+
+    /**
+     *  Empties the buffer, keeping its storage.
+     */
+
+    void clear ()
+    {
+        m_items.clear();
+    }
+
+    /**
+     * \getter m_items
+     */
+
+    const std::vector<render_item> & items () const
+    {
+        return m_items;
+    }
+
+};          // class render_buffer
+
+/**
+ *  The function that renders one pattern of a pass.  The first parameter is
+ *  the context given to render_pool::run(), the second is the index of the
+ *  pattern, and the third is the index of the renderer, 0 being the calling
+ *  thread.
+ */
+
+typedef void (* render_func) (void * context, int index, int worker);
+
+/**
+ *  Provides the worker threads and their render buffers.
+ */
+
+class render_pool
+{
+
+private:
+
+    /**
+     *  Provides the arguments of a worker thread.
+     */
+
+    struct worker
+    {
+        render_pool * w_pool;       /**< The pool of the worker.            */
+        int w_index;                /**< The renderer index of the worker.  */
+    };
+
+    /**
+     *  The number of renderers, including the thread that calls run().
+     */
+
+    const int m_renderers;
+
+    /**
+     *  The worker threads, one less than m_renderers.
+     */
+
+    std::vector<pthread_t> m_threads;
+
+    /**
+     *  The arguments of the worker threads.
+     */
+
+    std::vector<worker> m_workers;
+
+    /**
+     *  One render buffer per renderer.
+     */
+
+    std::vector<render_buffer> m_buffers;
+
+    /**
+     *  The events of all of the buffers, sorted by merge().
+     */
+
+    std::vector<render_item> m_merged;
+
+    /**
+     *  Wakes the workers when a pass starts, or when the pool is destroyed.
+     */
+
+    condition_var m_condition;
+
+    /**
+     *  Set by the destructor to stop the workers.
+     */
+
+    std::atomic<bool> m_quit;
+
+    /**
+     *  The number of the current pass in the upper 32 bits, and the index of
+     *  the next unclaimed pattern in the lower 32 bits.  A renderer claims a
+     *  pattern by incrementing it, which fails if the pass has changed, so
+     *  that a late worker can never claim a pattern of the next pass.
+     */
+
+    std::atomic<unsigned long long> m_claim;
+
+    /**
+     *  The number of patterns of the current pass.
+     */
+
+    std::atomic<int> m_count;
+
+    /**
+     *  The number of patterns of the current pass already rendered.
+     */
+
+    std::atomic<int> m_completed;
+
+    /**
+     *  The number of the current pass.  Used only by the calling thread.
+     */
+
+    unsigned m_pass;
+
+    /**
+     *  The function and context of the current pass.  Set before the pass
+     *  is published in m_claim.
+     */
+
+    render_func m_func;
+    void * m_context;
+
+public:
+
+    render_pool (int renderers);
+    ~render_pool ();
+
+    /**
+     * \getter m_renderers
+     */
+
+    int renderers () const
+    {
+        return m_renderers;
+    }
+
+    /**
+     *  Returns the render buffer of a renderer, which is not validated.
+     */
+
+    render_buffer & buffer (int worker)
+    {
+        return m_buffers[worker];
+    }
+
+    void run (render_func f, void * context, int count);
+    const std::vector<render_item> & merge ();
+
+private:
+
+    static void * worker_func (void * arg);
+    void work (int worker);
+    void render_claimed (unsigned pass, int worker);
+
+    /*
+     * The pool owns threads; it is never copied.
+     */
+
+    render_pool (const render_pool &);
+    render_pool & operator = (const render_pool &);
+
+};          // class render_pool
+
+}           // namespace seq64
+
+#endif      // SEQ64_RENDER_POOL_HPP
+
+/*
+ * render_pool.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,155 @@
+#ifndef SEQ64_RT_AUDIT_HPP
+#define SEQ64_RT_AUDIT_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          rt_audit.hpp
+ *
+ *  This module declares/defines a debug mode that detects calls that are not
+ *  realtime-safe in the realtime threads.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-21
+ * \updates       2018-11-21
+ * \license       GNU GPLv2 or above
+ *
+ *  The output thread, the input thread, and the JACK process callbacks must
+ *  not allocate memory, wait on a mutex, or write to a stdio stream.  When
+ *  configured with "--enable-rtaudit", SEQ64_RT_AUDIT is defined, and those
+ *  contexts are marked as realtime with SEQ64_RT_SCOPE(), or with the
+ *  SEQ64_RT_ENTER()/SEQ64_RT_LEAVE() pair.  While a thread is in such a
+ *  context:
+ *
+ *      -   malloc(), calloc(), realloc(), and free() are intercepted, and so
+ *          are operator new and delete, which call them.  glibc only.
+ *      -   The common stdio output functions are intercepted.  glibc only.
+ *      -   seq64::mutex::lock() and the condition_var waits report
+ *          themselves.  All of the locking of Sequencer64 goes through these
+ *          classes.
+ *
+ *  Each violation is counted by kind, and recorded once per distinct call
+ *  stack with a backtrace and its own count.  rt_audit_report() writes the
+ *  records, so that one can check that a song plays allocation-free.
+ *
+ *  When SEQ64_RT_AUDIT is not defined, the macros are empty, and nothing is
+ *  intercepted.
+ */
+
+#include "seq64_features.h"             /* SEQ64_RT_AUDIT                   */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The kinds of realtime violations.
+ */
+
+enum rt_violation
+{
+    RT_VIOLATION_MALLOC,        /**< malloc(), calloc(), realloc(), new.    */
+    RT_VIOLATION_FREE,          /**< free(), or delete.                     */
+    RT_VIOLATION_MUTEX,         /**< A mutex lock or a condition wait.      */
+    RT_VIOLATION_STDIO,         /**< A write to a stdio stream.             */
+    RT_VIOLATION_MAX            /**< The number of kinds, not a kind.       */
+};
+
+/*
+ *  Free functions of the audit.  They are always declared, so that a caller
+ *  need not test the macro, but they do nothing useful unless
+ *  SEQ64_RT_AUDIT is defined.
+ */
+
+extern void rt_audit_enter ();
+extern void rt_audit_leave ();
+extern bool rt_audit_active ();
+extern void rt_audit_violation (rt_violation kind);
+extern unsigned long rt_audit_count (rt_violation kind);
+extern unsigned long rt_audit_total ();
+extern void rt_audit_reset ();
+extern void rt_audit_report (int fd);
+
+/**
+ *  Marks the calling thread as realtime for the life of the object.  Scopes
+ *  nest.
+ */
+
+class rt_scope
+{
+
+public:
+
+    /**
+     *  Enters the realtime context.
+     */
+
+    rt_scope ()
+    {
+        rt_audit_enter();
+    }
+
+    /**
+     *  Leaves the realtime context.
+     */
+
+    ~rt_scope ()
+    {
+        rt_audit_leave();
+    }
+
+private:
+
+    rt_scope (const rt_scope &);
+    rt_scope & operator = (const rt_scope &);
+
+};          // class rt_scope
+
+}           // namespace seq64
+
+/**
+ *  Macros to mark the realtime contexts, and to report a violation that the
+ *  audit cannot intercept.  They compile to nothing in a normal build.
+ */
+
+#ifdef SEQ64_RT_AUDIT
+#define SEQ64_RT_SCOPE()        seq64::rt_scope seq64_rt_scope_guard
+#define SEQ64_RT_ENTER()        seq64::rt_audit_enter()
+#define SEQ64_RT_LEAVE()        seq64::rt_audit_leave()
+#define SEQ64_RT_CHECK(kind)                                                \
+    do { if (seq64::rt_audit_active()) seq64::rt_audit_violation(kind); }   \
+    while (0)
+#else
+#define SEQ64_RT_SCOPE()
+#define SEQ64_RT_ENTER()
+#define SEQ64_RT_LEAVE()
+#define SEQ64_RT_CHECK(kind)
+#endif
+
+#endif      // SEQ64_RT_AUDIT_HPP
+
+/*
+ * rt_audit.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
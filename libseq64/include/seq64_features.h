@@ -258,6 +258,10 @@
  *    - SEQ64_MULTI_MAINWID
  *      Provides support for up to a 3 x 2 array of mainwids.  Now a configure
  *      option.
+ *    - SEQ64_USE_EVENT_ARRAY
+ *    - SEQ64_USE_EVENT_MAP
+ *      Select the container of the events of a pattern, via the
+ *      "--with-events=list|map|array" option.  See below.
  */
 
 /*
@@ -349,9 +353,16 @@
  *
  * What we finally did was use the faster list method, but only sort the list
  * after adding every event to it.
+ *
+ * The container is now chosen at configure time:  "--with-events=map"
+ * defines SEQ64_USE_EVENT_MAP, and "--with-events=array" defines
+ * SEQ64_USE_EVENT_ARRAY, which stores the events in a sorted, block-allocated
+ * array (see event_array.hpp).  The std::list remains the default.
  */
 
-#undef SEQ64_USE_EVENT_MAP              /* map seems to work well! But...   */
+#if defined SEQ64_USE_EVENT_MAP && defined SEQ64_USE_EVENT_ARRAY
+#error Define only one of SEQ64_USE_EVENT_MAP and SEQ64_USE_EVENT_ARRAY
+#endif
 
 /**
  *  Enables some mute-group patches contributed by a Sequencer64 user.
@@ -38,8 +38,10 @@
  *  module, and now just call its member functions to do the actual work.
  */
 
+#include <atomic>                       /* std::atomic<>                */
 #include <string>
 #include <stack>
+#include <vector>                       /* std::vector<>                */
 
 #include "seq64_features.h"             /* various feature #defines     */
 #include "calculations.hpp"             /* measures_to_ticks()          */
@@ -48,6 +50,8 @@
 #include "midi_container.hpp"           /* seq64::midi_container        */
 #include "midibus.hpp"                  /* seq64::midibus               */
 #include "mutex.hpp"                    /* seq64::mutex, automutex      */
+#include "playback_events.hpp"          /* seq64::playback_events       */
+#include "record_buffer.hpp"            /* seq64::record_buffer         */
 #include "scales.h"                     /* key and scale constants      */
 #include "triggers.hpp"                 /* seq64::triggers, etc.        */
 
@@ -65,6 +69,8 @@ namespace seq64
 {
     class mastermidibus;
     class perform;
+    class render_buffer;
+    class tempo_map;
 
 /**
  *  Provides a set of methods for drawing certain items.  These values are
@@ -165,6 +171,47 @@ public:
         e_is_selected_onset     /**< New, from Kepler34, onsets selected.   */
     };
 
+    /**
+     *  Locks the sequence like automutex does, for the functions that edit
+     *  the event list.  When the outermost editlock is released, the
+     *  playback snapshot is re-published if the event list changed, so that
+     *  a long edit publishes only once, at its end.  Functions that can be
+     *  called from the output thread (play() and what it calls) keep using a
+     *  plain automutex, since publishing allocates memory.  Code that adds
+     *  many events in a row, such as editable_events::save_events() and the
+     *  midi_splitter, holds one editlock around the whole batch, so that the
+     *  snapshot is not rebuilt for each event.
+     */
+
+    class editlock
+    {
+
+    private:
+
+        sequence & m_seq;   /**< The sequence to lock and publish.      */
+
+    private:
+
+        editlock (const editlock &);
+        editlock & operator = (const editlock &);
+
+    public:
+
+        editlock (sequence & s) : m_seq (s)
+        {
+            m_seq.m_mutex.lock();
+            ++m_seq.m_edit_depth;
+        }
+
+        ~editlock ()
+        {
+            if (--m_seq.m_edit_depth == 0)
+                m_seq.publish_playback();
+
+            m_seq.m_mutex.unlock();
+        }
+    };
+
 private:
 
     /**
@@ -257,11 +304,109 @@ private:
     EventStack m_events_redo;
 
     /**
-     *  An iterator for drawing events.
+     *  An iterator for drawing events.  It is used only while m_mutex is
+     *  held, and only if m_draw_generation is current; otherwise it is
+     *  re-seeked first.  See seek_draw_marker().
      */
 
     event_list::iterator m_iterator_draw;
 
+    /**
+     *  The number of events that m_iterator_draw has passed, so that it can
+     *  be put back in place after the events change under it.  The
+     *  event_array invalidates its iterators on every insertion or removal,
+     *  and the input thread can merge recorded events while a window is
+     *  drawing the pattern.
+     */
+
+    int m_draw_index;
+
+    /**
+     *  The event_list::generation() value for which m_iterator_draw is
+     *  valid.
+     */
+
+    unsigned long m_draw_generation;
+
+    /**
+     *  The current playback snapshot: a compact, time-sorted copy of the
+     *  playable events, rebuilt and published by the editing side (see
+     *  publish_playback()), and read by play() without taking m_mutex.
+     */
+
+    std::atomic<playback_events *> m_playback;
+
+    /**
+     *  Counts the threads currently reading m_playback.  A replaced snapshot
+     *  is deleted only when this count is zero; otherwise it is retired and
+     *  deleted by a later publication.
+     */
+
+    std::atomic<int> m_playback_readers;
+
+    /**
+     *  Holds replaced snapshots that a reader might still have been using
+     *  when they were replaced.  Accessed only under m_mutex.
+     */
+
+    std::vector<playback_events *> m_playback_retired;
+
+    /**
+     *  The nesting depth of editlock objects.  The snapshot is published
+     *  when the outermost editlock is released.  Accessed only under m_mutex.
+     */
+
+    int m_edit_depth;
+
+    /**
+     *  If not null, the render buffer of the worker thread rendering this
+     *  sequence in a parallel pass of perform::play().  The events played
+     *  are then recorded there, rather than put on the busses.  See
+     *  render_to().
+     */
+
+    std::atomic<render_buffer *> m_render_buffer;
+
+    /**
+     *  The playback cursor.  It is the index in the playback snapshot of the
+     *  next item that play() will examine, so that each output tick starts
+     *  where the previous one stopped, instead of walking the events from
+     *  their beginning.  It is valid only while m_play_cursor_tick matches
+     *  the start of the next frame, and the snapshot and length are
+     *  unchanged.  See play_cursor_valid().
+     */
+
+    int m_play_cursor_index;
+
+    /**
+     *  The loop-offset (a multiple of m_length) to add to the time-stamp of
+     *  the item at m_play_cursor_index to get its "unrolled" play-time.
+     */
+
+    midipulse m_play_cursor_base;
+
+    /**
+     *  The offset start-tick that the next play() call must have for the
+     *  cursor to be reused.  A value of SEQ64_NULL_MIDIPULSE (-1) means
+     *  that the cursor must be re-seeked.
+     */
+
+    midipulse m_play_cursor_tick;
+
+    /**
+     *  The pattern length in force when the cursor was last saved.
+     */
+
+    midipulse m_play_cursor_length;
+
+    /**
+     *  The playback_events::generation() value of the snapshot on which the
+     *  cursor was last saved.  Publishing a new snapshot invalidates the
+     *  cursor.
+     */
+
+    unsigned long m_play_cursor_generation;
+
     /**
      *  A new feature for recording, based on a "stazed" feature.  If true
      *  (not yet the default), then the seqedit window will record only MIDI
@@ -320,7 +465,7 @@ private:
      *  come close to the short limit of 32767.
      */
 
-    short m_playing_notes[SEQ64_MIDI_NOTES_MAX];
+    std::atomic<short> m_playing_notes[SEQ64_MIDI_NOTES_MAX];
 
     /**
      *  Indicates if the sequence was playing.
@@ -330,9 +475,13 @@ private:
 
     /**
      *  True if sequence playback currently is in progress for this sequence.
+     *  This flag, m_queued, m_one_shot, and m_song_recording are atomic
+     *  (sequentially consistent), since park() reads them without the mutex
+     *  after setting m_parked, while their setters write them and then read
+     *  m_parked in wake_playback().  Either side then sees the other's store.
      */
 
-    bool m_playing;
+    std::atomic<bool> m_playing;
 
     /**
      *  True if sequence recording currently is in progress for this sequence.
@@ -354,6 +503,21 @@ private:
 
     bool m_quantized_rec;
 
+    /**
+     *  Holds the events recorded during playback until flush_recording()
+     *  merges them into m_events.  The input thread pushes them without
+     *  locking.
+     */
+
+    record_buffer m_record_buffer;
+
+    /**
+     *  The batch of events taken from m_record_buffer by flush_recording().
+     *  Kept as a member so that its storage is reused.
+     */
+
+    std::vector<event> m_record_batch;
+
     /**
      *  True if recording in MIDI-through mode.
      */
@@ -361,10 +525,10 @@ private:
     bool m_thru;
 
     /**
-     *  True if the events are queued.
+     *  True if the events are queued.  Atomic, see m_playing.
      */
 
-    bool m_queued;
+    std::atomic<bool> m_queued;
 
 #ifdef SEQ64_SONG_RECORDING
 
@@ -376,9 +540,10 @@ private:
      *
      *  One-shot mode is entered when the MIDI control c_status_oneshot event
      *  is received.  Kepler34 reserves the period '.' to initiate this event.
+     *  Atomic, see m_playing.
      */
 
-    bool m_one_shot;
+    std::atomic<bool> m_one_shot;
 
     /**
      *  A Member from the Kepler34 project, set in sequence ::
@@ -406,10 +571,10 @@ private:
     /**
      *  Used to keep on blocking Song Mode events while recording new ones.
      *  Allows recording a live performance, by storing the sequence triggers.
-     *  Adapted from Kepler34.
+     *  Adapted from Kepler34.  Atomic, see m_playing.
      */
 
-    bool m_song_recording;
+    std::atomic<bool> m_song_recording;
 
     /**
      *  This value indicates that the following feature is active: the number
@@ -493,12 +658,29 @@ private:
 
     /**
      *  These members manage where we are in the playing of this sequence,
-     *  including triggering.
+     *  including triggering.  The last tick played is atomic because play()
+     *  advances it even when an edit holds the mutex, while set_last_tick()
+     *  sets it under the mutex.
      */
 
-    midipulse m_last_tick;          /**< Provides the last tick played.     */
+    std::atomic<midipulse> m_last_tick; /**< The last tick played.      */
     midipulse m_queued_tick;        /**< Provides the tick for queuing.     */
-    midipulse m_trigger_offset;     /**< Provides the trigger offset.       */
+
+    /**
+     *  Set by the perform object when it drops this sequence from its list of
+     *  active patterns, and so stops calling play() for it.  While parked,
+     *  m_last_tick is not updated; it is derived from the tick of the parent
+     *  instead.  See last_tick() and perform::play().
+     */
+
+    std::atomic<bool> m_parked;
+
+    /**
+     *  Provides the trigger offset, set by triggers::play() and not wrapped
+     *  to the length.  See wrap_trigger_offset().
+     */
+
+    midipulse m_trigger_offset;
 
     /**
      *  This constant provides the scaling used to calculate the time position
@@ -1210,9 +1392,10 @@ public:
      *  m_last_tick if m_length is 0 or 1.
      */
 
-    midipulse mod_last_tick ()
+    midipulse mod_last_tick () const
     {
-        return (m_length > 1) ? (m_last_tick % m_length) : m_last_tick ;
+        midipulse lt = last_tick();
+        return (m_length > 1) ? (lt % m_length) : lt ;
     }
 
     /*
@@ -1462,11 +1645,14 @@ public:
     bool append_event (const event & er);
 
     /**
-     *  Calls event_list::sort().
+     *  Calls event_list::sort().  Since append_event() does not publish the
+     *  playback snapshot (too time-consuming when loading a MIDI file),
+     *  this function, which must be called after appending, publishes it.
      */
 
     void sort_events ()
     {
+        editlock locker(*this);
         m_events.sort();
     }
 
@@ -1522,11 +1708,12 @@ public:
 
     /**
      * \getter m_trigger_offset
+     *      Wrapped to m_length.
      */
 
     midipulse get_trigger_offset () const
     {
-        return m_trigger_offset;
+        return wrap_trigger_offset(m_length);
     }
 
     void set_midi_bus (char mb, bool user_change = false);
@@ -1622,6 +1809,7 @@ public:
     midipulse clip_timestamp (midipulse ontime, midipulse offtime);
     void move_selected_notes (midipulse deltatick, int deltanote);
     bool stream_event (event & ev);
+    void flush_recording ();
     bool change_event_data_range
     (
         midipulse tick_s, midipulse tick_f,
@@ -1685,6 +1873,33 @@ public:
     void off_playing_notes ();
     void stop (bool song_mode = false);
     void pause (bool song_mode = false);
+
+    /**
+     *  Forces the next play() call to re-seek the playback cursor.
+     */
+
+    void reset_play_cursor ()
+    {
+        m_play_cursor_tick = SEQ64_NULL_MIDIPULSE;
+    }
+
+    bool needs_play (bool songmode) const;
+    midipulse next_due_tick (midipulse tick, bool songmode);
+    void get_tempo_changes (tempo_map & tm);
+    bool park (bool songmode);
+    void unpark ();
+    void wake_playback ();
+
+    /**
+     *  Sets or clears the render buffer of the sequence.  Called by the
+     *  renderer of a parallel pass, around its call to play_queue().
+     */
+
+    void render_to (render_buffer * rb)
+    {
+        m_render_buffer = rb;
+    }
+
     void inc_draw_marker ();
     void reset_draw_marker ();
     void reset_draw_trigger_marker ();
@@ -1857,7 +2072,10 @@ private:
     ) const;
 
     void set_parent (perform * p);
-    void put_event_on_bus (event & ev);
+    void put_event_on_bus
+    (
+        event & ev, long delay_us = 0, bool flush = true
+    );
     void reset_loop ();
     void set_trigger_offset (midipulse trigger_offset);
     void adjust_trigger_offsets_to_length (midipulse newlen);
@@ -1865,6 +2083,37 @@ private:
     void remove (event_list::iterator i);
     void remove (event & e);
     void remove_all ();
+    void seek_draw_marker ();
+
+    /**
+     *  Indicates if the playback cursor can be used as is for a frame
+     *  starting at the given (offset) tick.  Otherwise, play() must re-seek
+     *  it in the snapshot.
+     *
+     * \param pe
+     *      The playback snapshot in use for the frame.
+     *
+     * \param starttick
+     *      The offset start tick of the frame to be played.
+     */
+
+    bool play_cursor_valid
+    (
+        const playback_events & pe, midipulse starttick
+    ) const
+    {
+        return
+        (
+            starttick == m_play_cursor_tick &&
+            pe.length() == m_play_cursor_length &&
+            pe.generation() == m_play_cursor_generation
+        );
+    }
+
+    void publish_playback ();
+    midipulse wrap_trigger_offset (midipulse len) const;
+    void delete_retired_playback ();
+    midipulse last_tick () const;
 
     /**
      *  Checks to see if the event's channel matches the sequence's nominal
@@ -1896,6 +2145,7 @@ private:
     void one_shot (bool f)
     {
         m_one_shot = f;
+        wake_playback();
     }
 
     /**
@@ -1923,6 +2173,7 @@ private:
     void song_recording (bool f)
     {
         m_song_recording = f;
+        wake_playback();
     }
 
     /**
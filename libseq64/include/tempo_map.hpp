@@ -0,0 +1,161 @@
+#ifndef SEQ64_TEMPO_MAP_HPP
+#define SEQ64_TEMPO_MAP_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempo_map.hpp
+ *
+ *  This module declares/defines a song-wide map of the tempo changes, for
+ *  converting between ticks and microseconds.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-18
+ * \updates       2018-11-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The tempo used to be a single value, changed by perform when a pattern
+ *  played a Set Tempo event.  The time of a tick could only be computed at
+ *  the current tempo, so that a time display or a JACK position after a
+ *  tempo change was wrong, and a tempo change took effect only at the next
+ *  pass of the output loop.
+ *
+ *  A tempo_map is built from the Set Tempo events of all of the patterns,
+ *  taken as song positions, as they are in a MIDI file.  It holds one
+ *  segment per tempo, with the time in microseconds at which the segment
+ *  starts, so that a conversion is a binary search plus a linear step.  A
+ *  map is never modified after finish() is called; perform builds a new one
+ *  and swaps it in.  See perform::rebuild_tempo_map().
+ */
+
+#include <vector>                       /* std::vector<>                    */
+
+#include "app_limits.h"                 /* SEQ64_DEFAULT_BPM, etc.          */
+#include "midibyte.hpp"                 /* seq64::midipulse, midibpm        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds the tempo segments of a song, sorted by tick.
+ */
+
+class tempo_map
+{
+
+public:
+
+    /**
+     *  Provides one tempo of the song, from its starting tick to the starting
+     *  tick of the next segment.
+     */
+
+    struct segment
+    {
+        midipulse tm_tick;          /**< The tick at which the tempo starts. */
+        midibpm tm_bpm;             /**< The tempo, in beats per minute.     */
+        double tm_us;               /**< The time of tm_tick, in us.         */
+    };
+
+private:
+
+    /**
+     *  The segments, sorted by tick.  The first segment always starts at
+     *  tick 0.
+     */
+
+    std::vector<segment> m_segments;
+
+    /**
+     *  The number of tempo events added to the map.  If zero, the map holds
+     *  only the base tempo, and is not used for playback.
+     */
+
+    int m_changes;
+
+    /**
+     *  The pulses-per-quarter-note of the song.
+     */
+
+    int m_ppqn;
+
+public:
+
+    tempo_map
+    (
+        midibpm bpm = SEQ64_DEFAULT_BPM,
+        int ppqn    = SEQ64_DEFAULT_PPQN
+    );
+
+    void add (midipulse tick, midibpm bpm);
+    void finish ();
+
+    /**
+     *  Indicates if the map holds any tempo event.  If not, the tempo is the
+     *  single, user-adjustable, tempo of the performance.
+     */
+
+    bool active () const
+    {
+        return m_changes > 0;
+    }
+
+    /**
+     *  Returns the number of segments.
+     */
+
+    int count () const
+    {
+        return int(m_segments.size());
+    }
+
+    /**
+     * \getter m_ppqn
+     */
+
+    int ppqn () const
+    {
+        return m_ppqn;
+    }
+
+    midibpm bpm_at (double tick) const;
+    double tick_to_us (double tick) const;
+    double us_to_tick (double us) const;
+
+private:
+
+    int segment_at_tick (double tick) const;
+    int segment_at_us (double us) const;
+
+};          // class tempo_map
+
+}           // namespace seq64
+
+#endif      // SEQ64_TEMPO_MAP_HPP
+
+/*
+ * tempo_map.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
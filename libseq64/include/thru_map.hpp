@@ -0,0 +1,162 @@
+#ifndef SEQ64_THRU_MAP_HPP
+#define SEQ64_THRU_MAP_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          thru_map.hpp
+ *
+ *  This module declares/defines the MIDI-thru routing table.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  The "thru" button of a sequence editor echoes the input through the
+ *  input thread, the sequence (under its lock), and the output queues, which
+ *  costs a player monitoring through us a few milliseconds.  The routing
+ *  table echoes the channel messages of an input buss to an output buss as
+ *  soon as they arrive:  in the JACK process callback, in the same cycle,
+ *  when the ports are JACK ports, and otherwise as soon as the input thread
+ *  gets them, before any other handling.  Recording is not affected.
+ *
+ *  The table is given by the "-o thru=routes" option, a comma-separated
+ *  list of routes of the form
+ *
+\verbatim
+        inbus[.inchannel]:outbus[.outchannel][+transpose|-transpose]
+\endverbatim
+ *
+ *  The buss numbers start at 0, the channel numbers at 1.  An input buss or
+ *  channel of "*", or an input channel left out, matches any buss or
+ *  channel; an output channel left out keeps the channel of the input.  The
+ *  transposition applies to the notes of Note On, Note Off, and Aftertouch.
+ *  For example, "0:1,0.10:2.10-12" echoes all of buss 0 to buss 1, and its
+ *  channel 10 also to buss 2, an octave lower.
+ *
+ *  The table is built once, before the MIDI ports are opened, and is not
+ *  changed after that, so that the JACK callback can read it without
+ *  locking.  Routing allocates nothing.
+ */
+
+#include <string>
+
+#include "app_limits.h"                 /* SEQ64_THRU_ROUTES_MAX            */
+#include "midibyte.hpp"                 /* seq64::midibyte, bussbyte        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds the routes of the MIDI-thru table.
+ */
+
+class thru_map
+{
+
+public:
+
+    /**
+     *  Provides one route of the table.  The channels are 0 to 15, or
+     *  SEQ64_THRU_ANY.
+     */
+
+    struct route
+    {
+        bussbyte tr_in_bus;             /**< The input buss, or any.        */
+        midibyte tr_in_channel;         /**< The input channel, or any.     */
+        bussbyte tr_out_bus;            /**< The output buss.               */
+        midibyte tr_out_channel;        /**< The output channel, or same.   */
+        int tr_transpose;               /**< Semitones added to the note.   */
+    };
+
+private:
+
+    /**
+     *  The routes, in the order given.
+     */
+
+    route m_routes[SEQ64_THRU_ROUTES_MAX];
+
+    /**
+     *  The number of routes in m_routes.
+     */
+
+    int m_count;
+
+public:
+
+    thru_map ();
+
+    bool parse (const std::string & spec);
+    bool apply
+    (
+        int index, bussbyte inbus, midibyte & status, midibyte & d0
+    ) const;
+
+    /**
+     * \getter m_count
+     */
+
+    int count () const
+    {
+        return m_count;
+    }
+
+    /**
+     * \getter m_count
+     *      True if no input is routed.
+     */
+
+    bool empty () const
+    {
+        return m_count == 0;
+    }
+
+    /**
+     * \getter m_routes[index].tr_out_bus
+     *      The caller must check the index.
+     */
+
+    bussbyte out_bus (int index) const
+    {
+        return m_routes[index].tr_out_bus;
+    }
+
+private:
+
+    bool parse_route (const std::string & text, route & r);
+
+};          // class thru_map
+
+}           // namespace seq64
+
+#endif      // SEQ64_THRU_MAP_HPP
+
+/*
+ * thru_map.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
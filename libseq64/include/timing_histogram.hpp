@@ -0,0 +1,151 @@
+#ifndef SEQ64_TIMING_HISTOGRAM_HPP
+#define SEQ64_TIMING_HISTOGRAM_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          timing_histogram.hpp
+ *
+ *  This module declares/defines a lock-free, log-scale histogram for the
+ *  timing measurements of the output loop.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-20
+ * \updates       2018-11-20
+ * \license       GNU GPLv2 or above
+ *
+ *  The SEQ64_STATISTICS_SUPPORT code of perform::output_func() has to be
+ *  compiled in, prints from the output thread, and keeps only an average,
+ *  a minimum, and a maximum.  A timing_histogram can be filled by the output
+ *  thread at all times, at the cost of a few relaxed atomic increments, and
+ *  read at any time by another thread, which computes the percentiles
+ *  itself.
+ *
+ *  Values below 16 each have their own bucket.  Larger values are bucketed
+ *  by their power of 2, with 8 buckets per power, so that a percentile is
+ *  within 12.5% of the true value, over the whole range of an unsigned
+ *  32-bit value.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <string>                       /* std::string                      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Counts values in log-scale buckets.  One thread records; any thread
+ *  reads.
+ */
+
+class timing_histogram
+{
+
+public:
+
+    /**
+     *  The number of buckets:  16 linear ones, and 8 for each power of 2
+     *  from 2^4 to 2^31.
+     */
+
+    static const int c_bucket_count = 16 + 28 * 8;
+
+private:
+
+    /**
+     *  The counts of the buckets.
+     */
+
+    std::atomic<unsigned long> m_buckets[c_bucket_count];
+
+    /**
+     *  The number of values recorded.
+     */
+
+    std::atomic<unsigned long> m_count;
+
+    /**
+     *  The sum of the values recorded, for the mean.
+     */
+
+    std::atomic<unsigned long long> m_sum;
+
+    /**
+     *  The largest value recorded.
+     */
+
+    std::atomic<unsigned long> m_max;
+
+public:
+
+    timing_histogram ();
+
+    void record (unsigned long value);
+    void reset ();
+
+    /**
+     * \getter m_count
+     */
+
+    unsigned long count () const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \getter m_max
+     */
+
+    unsigned long maximum () const
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    double mean () const;
+    unsigned long percentile (double fraction) const;
+    std::string report (const std::string & name) const;
+
+    static int bucket_of (unsigned long value);
+    static unsigned long bucket_value (int bucket);
+
+private:
+
+    /*
+     * The histogram holds atomics; it is never copied.
+     */
+
+    timing_histogram (const timing_histogram &);
+    timing_histogram & operator = (const timing_histogram &);
+
+};          // class timing_histogram
+
+}           // namespace seq64
+
+#endif      // SEQ64_TIMING_HISTOGRAM_HPP
+
+/*
+ * timing_histogram.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
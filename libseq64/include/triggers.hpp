@@ -33,11 +33,17 @@
  *
  *  By segregating trigger support into its own module, the sequence class is
  *  a bit easier to understand.
+ *
+ *  The triggers are held in a vector, sorted by start tick.  The editing
+ *  functions keep them from overlapping, so that the end ticks are sorted
+ *  as well.  This lets play(), get_state(), intersect(), and the other
+ *  look-ups find the trigger at a given tick with a binary search, instead
+ *  of walking the list from the start on every tick.
  */
 
 #include <string>
-#include <list>
 #include <stack>
+#include <vector>
 
 /**
  *  Indicates that there is no paste-trigger.  This is a new feature from the
@@ -113,7 +119,7 @@ public:
      *      Returns true if m_tick_start is less than rhs's.
      */
 
-    bool operator < (const trigger & rhs)
+    bool operator < (const trigger & rhs) const
     {
         return m_tick_start < rhs.m_tick_start;
     }
@@ -309,9 +315,10 @@ private:
 
     /**
      *  Exposes the triggers type, currently needed for midi_container only.
+     *  A random-access container, sorted by start tick; see the banner.
      */
 
-    typedef std::list<trigger> List;
+    typedef std::vector<trigger> List;
 
     /**
      *  Provides a stack for use with the undo/redo features of the
@@ -361,16 +368,21 @@ private:
     Stack m_redo_stack;
 
     /**
-     *  An iterator for cycling through the triggers during playback.
+     *  The playback cursor:  the index of the first trigger that ends after
+     *  the end tick of the previous call to play().  Since playback moves
+     *  forward, play() usually finds its trigger at or just after this
+     *  index; otherwise, it searches the triggers again.  An index, rather
+     *  than an iterator, so that an edit of the triggers cannot invalidate
+     *  it.
      */
 
-    List::iterator m_iterator_play_trigger;
+    int m_play_trigger;
 
     /**
-     *  An iterator for cycling through the triggers during drawing.
+     *  An index for cycling through the triggers during drawing.
      */
 
-    List::iterator m_iterator_draw_trigger;
+    int m_draw_trigger;
 
     /**
      *  Set to true if there is an active trigger in the trigger clipboard.
@@ -509,6 +521,7 @@ public:
     midipulse get_selected_start ();
     midipulse get_selected_end ();
     midipulse get_maximum () const;
+    midipulse next_change (midipulse tick) const;
     void move (midipulse starttick, midipulse distance, bool direction);
     void copy (midipulse starttick, midipulse distance);
 
@@ -535,7 +548,7 @@ public:
 
     void reset_draw_trigger_marker ()
     {
-        m_iterator_draw_trigger = m_triggers.begin();
+        m_draw_trigger = 0;
     }
 
     void set_trigger_paste_tick (midipulse tick)
@@ -551,6 +564,9 @@ public:
 private:
 
     midipulse adjust_offset (midipulse offset);
+    int first_ending_after (midipulse tick) const;
+    int find (midipulse tick) const;
+    void sort ();
     void offset_selected (midipulse tick, grow_edit_t editmode);
     void split (trigger & t, midipulse splittick);
     void select (trigger & t, bool count = true);
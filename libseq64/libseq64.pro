@@ -38,6 +38,7 @@ HEADERS += \
  include/businfo.hpp \
  include/calculations.hpp \
  include/click.hpp \
+ include/clock_schedule.hpp \
  include/cmdlineopts.hpp \
  include/configfile.hpp \
  include/controllers.hpp \
@@ -46,6 +47,7 @@ HEADERS += \
  include/editable_event.hpp \
  include/editable_events.hpp \
  include/event.hpp \
+ include/event_array.hpp \
  include/event_list.hpp \
  include/file_functions.hpp \
  include/gdk_basic_keys.h \
@@ -57,11 +59,15 @@ HEADERS += \
  include/lash.hpp \
  include/mastermidibase.hpp \
  include/mastermidibus.hpp \
+ include/midi_capture.hpp \
  include/midi_container.hpp \
  include/midi_control.hpp \
+ include/midi_control_map.hpp \
  include/midi_list.hpp \
+ include/midi_out_queue.hpp \
  include/midi_splitter.hpp \
  include/midi_vector.hpp \
+ include/midi_wakeup.hpp \
  include/midibase.hpp \
  include/midibus.hpp \
  include/midibus_common.hpp \
@@ -72,14 +78,21 @@ HEADERS += \
  include/palette.hpp \
  include/perform.hpp \
  include/platform_macros.h \
+ include/playback_events.hpp \
  include/playlist.hpp \
  include/rc_settings.hpp \
  include/recent.hpp \
+ include/record_buffer.hpp \
  include/rect.hpp \
+ include/render_pool.hpp \
+ include/rt_audit.hpp \
  include/scales.h \
  include/seq64_features.h \
  include/sequence.hpp \
  include/settings.hpp \
+ include/tempo_map.hpp \
+ include/thru_map.hpp \
+ include/timing_histogram.hpp \
  include/triggers.hpp \
  include/user_instrument.hpp \
  include/user_midi_bus.hpp \
@@ -91,6 +104,7 @@ SOURCES += \
  src/businfo.cpp \
  src/calculations.cpp \
  src/click.cpp \
+ src/clock_schedule.cpp \
  src/cmdlineopts.cpp \
  src/configfile.cpp \
  src/controllers.cpp \
@@ -99,6 +113,7 @@ SOURCES += \
  src/editable_event.cpp \
  src/editable_events.cpp \
  src/event.cpp \
+ src/event_array.cpp \
  src/event_list.cpp \
  src/file_functions.cpp \
  src/gui_assistant.cpp \
@@ -107,11 +122,15 @@ SOURCES += \
  src/keystroke.cpp \
  src/lash.cpp \
  src/mastermidibase.cpp \
+ src/midi_capture.cpp \
  src/midi_container.cpp \
  src/midi_control.cpp \
+ src/midi_control_map.cpp \
  src/midi_list.cpp \
+ src/midi_out_queue.cpp \
  src/midi_splitter.cpp \
  src/midi_vector.cpp \
+ src/midi_wakeup.cpp \
  src/midibase.cpp \
  src/midibyte.cpp \
  src/midifile.cpp \
@@ -119,13 +138,20 @@ SOURCES += \
  src/optionsfile.cpp \
  src/palette.cpp \
  src/perform.cpp \
+ src/playback_events.cpp \
  src/playlist.cpp \
  src/rc_settings.cpp \
  src/recent.cpp \
+ src/record_buffer.cpp \
  src/rect.cpp \
+ src/render_pool.cpp \
+ src/rt_audit.cpp \
  src/seq64_features.cpp \
  src/sequence.cpp \
  src/settings.cpp \
+ src/tempo_map.cpp \
+ src/thru_map.cpp \
+ src/timing_histogram.cpp \
  src/triggers.cpp \
  src/user_instrument.cpp \
  src/user_midi_bus.cpp \
@@ -450,14 +450,18 @@ busarray::init_clock (midipulse tick)
  *
  * \param tick
  *      Provides the tick value for all busses use as the clock tick.
+ *
+ * \param schedule
+ *      The delays of the clock pulses, or null to send them now.  See
+ *      midibase::clock().
  */
 
 void
-busarray::clock (midipulse tick)
+busarray::clock (midipulse tick, const clock_schedule * schedule)
 {
     std::vector<businfo>::iterator bi;
     for (bi = m_container.begin(); bi != m_container.end(); ++bi)
-        bi->clock(tick);
+        bi->clock(tick, schedule);
 }
 
 /**
@@ -489,13 +493,83 @@ busarray::sysex (event * ev)
  *      The MIDI channel on which to play the event.  Sequencer64 controls
  *      the actual channel of playback, no matter what the channel specified
  *      in the event.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which the event is to be sent.
+ *      See midibase::play().
  */
 
 void
-busarray::play (bussbyte bus, event * e24, midibyte channel)
+busarray::play (bussbyte bus, event * e24, midibyte channel, long delay_us)
 {
     if (bus < count() && m_container[bus].active())
-        m_container[bus].bus()->play(e24, channel);
+        m_container[bus].bus()->play(e24, channel, delay_us);
+}
+
+/**
+ *  Like play(), but submits the event to the output queue of the buss,
+ *  without locking.  See midibase::submit().
+ *
+ * \param bus
+ *      The MIDI buss on which to play the event.  If it is not valid or not
+ *      active, the event is dropped, as in play().
+ *
+ * \param e24
+ *      A pointer to the event to be played.
+ *
+ * \param channel
+ *      The MIDI channel on which to play the event.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which the event is to be sent.
+ *
+ * \return
+ *      Returns false only if the queue of the buss is full.
+ */
+
+bool
+busarray::submit (bussbyte bus, event * e24, midibyte channel, long delay_us)
+{
+    bool result = true;
+    if (bus < count() && m_container[bus].active())
+        result = m_container[bus].bus()->submit(e24, channel, delay_us);
+
+    return result;
+}
+
+/**
+ *  Plays the events waiting in the output queues of all of the busses.  See
+ *  midibase::drain().
+ */
+
+void
+busarray::drain ()
+{
+    std::vector<businfo>::iterator bi;
+    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    {
+        if (not_nullptr(bi->bus()))
+            bi->bus()->drain();
+    }
+}
+
+/**
+ *  Indicates if any of the busses has events waiting in its output queue.
+ *
+ * \return
+ *      Returns true if a drain() is needed.
+ */
+
+bool
+busarray::pending () const
+{
+    std::vector<businfo>::const_iterator bi;
+    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    {
+        if (not_nullptr(bi->bus()) && bi->bus()->pending())
+            return true;
+    }
+    return false;
 }
 
 /**
@@ -78,6 +78,7 @@
 #include "app_limits.h"
 #include "calculations.hpp"
 #include "settings.hpp"
+#include "tempo_map.hpp"
 
 #if ! defined PI
 #define PI     3.14159265359
@@ -406,6 +407,50 @@ std::string
 pulses_to_timestring (midipulse p, midibpm bpm, int ppqn, bool showus)
 {
     unsigned long microseconds = ticks_to_delta_time_us(p, bpm, ppqn);
+    return microseconds_to_timestring(microseconds, showus);
+}
+
+/**
+ *  Converts MIDI pulses to a time-string, using a tempo map, so that the
+ *  time is correct for a song that changes tempo.
+ *
+ * \param p
+ *      Provides the song position, in pulses.
+ *
+ * \param tm
+ *      Provides the tempo map of the song, which also supplies the PPQN.
+ *
+ * \param showus
+ *      If true (the default), shows the microseconds as well.
+ *
+ * \return
+ *      Returns the time-string representation of the pulse (ticks) value.
+ */
+
+std::string
+pulses_to_timestring (midipulse p, const tempo_map & tm, bool showus)
+{
+    double us = tm.tick_to_us(double(p));
+    return microseconds_to_timestring((unsigned long)(us + 0.5), showus);
+}
+
+/**
+ *  Converts a time in microseconds to a time-string, in the format of
+ *  pulses_to_timestring().
+ *
+ * \param microseconds
+ *      Provides the time from the start of the song.
+ *
+ * \param showus
+ *      If true, shows the microseconds as well.
+ *
+ * \return
+ *      Returns the time-string.
+ */
+
+std::string
+microseconds_to_timestring (unsigned long microseconds, bool showus)
+{
     int seconds = int(microseconds / 1000000UL);
     int minutes = seconds / 60;
     int hours = seconds / (60 * 60);
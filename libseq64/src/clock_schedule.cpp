@@ -0,0 +1,247 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          clock_schedule.cpp
+ *
+ *  This module declares/defines the schedule of the MIDI clock pulses of
+ *  one pass of the output loop, and the measurement of their timing.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  See the clock_schedule.hpp module.
+ */
+
+#include "calculations.hpp"             /* seq64::pulse_length_us()         */
+#include "clock_schedule.hpp"           /* seq64::clock_schedule            */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
+#include "timing_histogram.hpp"         /* seq64::timing_histogram          */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.  The schedule starts empty.
+ *
+ * \param ppqn
+ *      The pulses-per-quarter-note of the song.
+ */
+
+clock_schedule::clock_schedule (int ppqn)
+ :
+    m_ppqn              (ppqn),
+    m_pulse_ticks       (1),
+    m_clock_now         (0.0),
+    m_us_per_tick       (0.0),
+    m_end_tick          (0),
+    m_first_pulse       (0),
+    m_count             (0),
+    m_measured_pulse    (SEQ64_NULL_MIDIPULSE),
+    m_last_sent_us      (0),
+    m_drift_us          (0.0),
+    m_skew_us           (0),
+    m_jitter_us         (0),
+    m_max_jitter_us     (0)
+{
+    restart(ppqn);
+}
+
+/**
+ *  Starts the measurement over, when the clock is started or repositioned.
+ *  The skew is the drift since this call.
+ *
+ * \param ppqn
+ *      The pulses-per-quarter-note of the song.
+ */
+
+void
+clock_schedule::restart (int ppqn)
+{
+    m_ppqn = ppqn > 0 ? ppqn : SEQ64_DEFAULT_PPQN ;
+    m_pulse_ticks = clock_ticks_from_ppqn(m_ppqn);
+    if (m_pulse_ticks < 1)
+        m_pulse_ticks = 1;
+
+    m_count = 0;
+    m_measured_pulse = SEQ64_NULL_MIDIPULSE;
+    m_last_sent_us = 0;
+    m_drift_us = 0.0;
+    m_skew_us.store(0, std::memory_order_relaxed);
+    m_jitter_us.store(0, std::memory_order_relaxed);
+}
+
+/**
+ *  Sets the largest jitter back to zero.  Can be called from any thread.
+ */
+
+void
+clock_schedule::reset_stats ()
+{
+    m_max_jitter_us.store(0, std::memory_order_relaxed);
+}
+
+/**
+ *  Computes the delays of the pulses from the current clock position to the
+ *  end of the pass.  No allocation is done, so the output thread can call
+ *  it on every pass.
+ *
+ * \param clocknow
+ *      The current clock position, with its fraction.  The clock position
+ *      does not wrap around at the end of a song loop.
+ *
+ * \param songnow
+ *      The current song position, with its fraction, at which the tempo map
+ *      is read.
+ *
+ * \param endtick
+ *      The last clock tick of the pass:  the current tick plus the lookahead
+ *      window, if any.
+ *
+ * \param tm
+ *      The tempo map, or null if the tempo is constant.  The caller must
+ *      keep the map alive during the call.
+ *
+ * \param bpm
+ *      The tempo at the current song position.
+ */
+
+void
+clock_schedule::build
+(
+    double clocknow, double songnow, midipulse endtick,
+    const tempo_map * tm, midibpm bpm
+)
+{
+    m_clock_now = clocknow;
+    m_end_tick = endtick;
+    m_us_per_tick = bpm > 0.0 ? pulse_length_us(bpm, m_ppqn) : 0.0 ;
+    m_first_pulse = (midipulse(clocknow) / m_pulse_ticks + 1) * m_pulse_ticks;
+    m_count = 0;
+
+    double base_us = not_nullptr(tm) ? tm->tick_to_us(songnow) : 0.0 ;
+    for
+    (
+        midipulse p = m_first_pulse;
+        p <= endtick && m_count < SEQ64_CLOCK_SCHEDULE_MAX;
+        p += m_pulse_ticks
+    )
+    {
+        double ahead = double(p) - clocknow;
+        double us = not_nullptr(tm) ?
+            tm->tick_to_us(songnow + ahead) - base_us :
+            ahead * m_us_per_tick ;
+
+        m_delays_us[m_count++] = long(us + 0.5);
+    }
+}
+
+/**
+ *  Gets the delay of a pulse.
+ *
+ * \param pulse
+ *      The tick of the pulse, a multiple of m_pulse_ticks.
+ *
+ * \return
+ *      Returns the delay, in microseconds, from the time at which the
+ *      schedule was built, or 0 if the pulse is already due.
+ */
+
+long
+clock_schedule::delay_us (midipulse pulse) const
+{
+    if (pulse < m_first_pulse)
+        return 0;
+
+    midipulse index = (pulse - m_first_pulse) / m_pulse_ticks;
+    if (index < m_count)
+        return m_delays_us[index];
+
+    return long((double(pulse) - m_clock_now) * m_us_per_tick);
+}
+
+/**
+ *  Measures the pulses scheduled since the last call, up to the end of the
+ *  pass.  If the clock has jumped forward by more than the schedule can
+ *  hold, the measurement starts over from the current position.
+ *
+ * \param now_us
+ *      The time at which the schedule was built, in microseconds of a
+ *      monotonic clock.
+ *
+ * \param histogram
+ *      If not null, receives the magnitude of the jitter of each pulse.
+ *
+ * \return
+ *      Returns the number of pulses measured.
+ */
+
+int
+clock_schedule::measure (long long now_us, timing_histogram * histogram)
+{
+    midipulse ct = m_pulse_ticks;
+    midipulse current = midipulse(m_clock_now) / ct * ct;
+    midipulse pulse = is_null_midipulse(m_measured_pulse) ?
+        current : m_measured_pulse + ct ;
+
+    if ((m_end_tick - pulse) / ct > SEQ64_CLOCK_SCHEDULE_MAX)
+    {
+        pulse = current;                            /* the clock jumped     */
+        m_last_sent_us = 0;
+    }
+
+    int result = 0;
+    double ideal_us = ct * m_us_per_tick;
+    for ( ; pulse <= m_end_tick; pulse += ct)
+    {
+        long long sent_us = now_us + delay_us(pulse);
+        if (m_last_sent_us > 0)
+        {
+            double error = double(sent_us - m_last_sent_us) - ideal_us;
+            long jitter = long(error < 0.0 ? error - 0.5 : error + 0.5);
+            long magnitude = jitter < 0 ? -jitter : jitter ;
+            m_drift_us += error;
+            m_jitter_us.store(jitter, std::memory_order_relaxed);
+            m_skew_us.store(long(m_drift_us), std::memory_order_relaxed);
+            if (magnitude > m_max_jitter_us.load(std::memory_order_relaxed))
+                m_max_jitter_us.store(magnitude, std::memory_order_relaxed);
+
+            if (not_nullptr(histogram))
+                histogram->record((unsigned long)(magnitude));
+        }
+        m_last_sent_us = sent_us;
+        m_measured_pulse = pulse;
+        ++result;
+    }
+    return result;
+}
+
+}           // namespace seq64
+
+/*
+ * clock_schedule.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
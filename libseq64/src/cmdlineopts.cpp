@@ -63,6 +63,7 @@
 #include "optionsfile.hpp"              /* seq64::optionsfile               */
 #include "perform.hpp"                  /* seq64::perform, the master!      */
 #include "settings.hpp"                 /* seq64::rc() and usr()            */
+#include "thru_map.hpp"                 /* seq64::thru_map, -o thru         */
 #include "userfile.hpp"                 /* seq64::userfile                  */
 
 /*
@@ -311,10 +312,49 @@ static const char * const s_help_4 =
 "                            default of 4x8.  Supported values of R are 4 to 8,\n"
 "                            and C can range from 8 to 12. If not 4x8, seq64 is\n"
 "                            in 'variset' mode. Affects mute groups, too.\n"
+"              scheduler=S   Selects how the output thread wakes up: 'poll'\n"
+"                            (the default) wakes every few milliseconds;\n"
+"                            'event' sleeps until the next event, trigger,\n"
+"                            or MIDI clock pulse is due.\n"
+"              timing=T      Selects how the output thread keeps time:\n"
+"                            'relative' (the default) adds up the measured\n"
+"                            deltas; 'absolute' computes each tick from a\n"
+"                            monotonic start time and sleeps until absolute\n"
+"                            deadlines, so that errors do not accumulate.\n"
+"              lookahead=ms  Renders events up to 'ms' milliseconds (0 to\n"
+"                            100) ahead, and lets the MIDI backend send them\n"
+"                            at their exact times.  0 (the default) sends\n"
+"                            each event when the output thread reaches it.\n"
+"              inqueue=n     Sets the number of messages (1 to 65536) that\n"
+"                            a JACK MIDI input port can hold before it drops\n"
+"                            incoming messages.  The default is 1024.\n"
+"              threads=n     Renders the patterns on n threads (1 to 16)\n"
+"                            when many of them are playing.  The events are\n"
+"                            merged in a fixed order.  The default is 1.\n"
+"              histograms=H  'on' records the output-loop duration, wake-up\n"
+"                            lateness, events per pass, and underruns, for\n"
+"                            percentile reports.  'off' is the default.\n"
+"              null=n        Uses the null MIDI backend instead of ALSA or\n"
+"                            JACK, with n output ports (1 to 16) and one\n"
+"                            input port.  It needs no sound server.\n"
+"              capture=file  With 'null', writes the events played, with\n"
+"                            their times, to a text file at exit.\n"
+"              inject=file   With 'null', plays the timed events of a text\n"
+"                            file into the input port.\n"
+"              thru=routes   Echoes input channel messages to output busses as\n"
+"                            soon as they arrive, apart from recording.  The\n"
+"                            routes are comma-separated, each of the form\n"
+"                            in[.ch]:out[.ch][+n|-n], with busses from 0,\n"
+"                            channels from 1, '*' for any input buss or\n"
+"                            channel, and an optional transposition.  For\n"
+"                            example, 'thru=0:1,0.10:2.10-12'.\n"
 "\n"
 " seq64cli:\n"
 "              daemonize     Makes this application fork to the background.\n"
 "              no-daemonize  Or not.  These options do not apply to Windows.\n"
+"              render=file   Renders the song of the MIDI file given, in Song\n"
+"                            mode and faster than real time, to a flat MIDI\n"
+"                            file, then exits without playing.\n"
 "\n"
 "The 'daemonize' option works only in the CLI build. The 'sets' option works in\n"
 "the CLI build as well.  Specify the '--user-save' option to make these options\n"
@@ -573,6 +613,114 @@ parse_o_options (int argc, char * argv [])
                                     result = true;
                                 }
                             }
+                            else if (optionname == "scheduler")
+                            {
+                                if (arg == "poll")
+                                {
+                                    rc().output_scheduler(e_scheduler_poll);
+                                    result = true;
+                                }
+                                else if (arg == "event")
+                                {
+                                    rc().output_scheduler(e_scheduler_event);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "timing")
+                            {
+                                if (arg == "relative")
+                                {
+                                    rc().absolute_timing(false);
+                                    result = true;
+                                }
+                                else if (arg == "absolute")
+                                {
+                                    rc().absolute_timing(true);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "lookahead")
+                            {
+                                int ms = atoi(arg.c_str());
+                                if (ms >= 0 && ms <= SEQ64_LOOKAHEAD_MAX_MS)
+                                {
+                                    rc().lookahead_ms(ms);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "inqueue")
+                            {
+                                int n = atoi(arg.c_str());
+                                if (n > 0 && n <= SEQ64_INPUT_QUEUE_SIZE_MAX)
+                                {
+                                    rc().input_queue_size(n);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "threads")
+                            {
+                                int n = atoi(arg.c_str());
+                                if (n > 0 && n <= SEQ64_RENDER_THREADS_MAX)
+                                {
+                                    rc().render_threads(n);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "render")
+                            {
+                                if (! arg.empty())
+                                {
+                                    rc().render_filename(arg);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "null")
+                            {
+                                int n = atoi(arg.c_str());
+                                if (n > 0 && n <= SEQ64_NULL_PORTS_MAX)
+                                {
+                                    rc().null_midi_ports(n);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "capture")
+                            {
+                                if (! arg.empty())
+                                {
+                                    rc().null_capture_filename(arg);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "inject")
+                            {
+                                if (! arg.empty())
+                                {
+                                    rc().null_inject_filename(arg);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "thru")
+                            {
+                                thru_map routes;
+                                if (routes.parse(arg))
+                                {
+                                    rc().thru_routes(arg);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "histograms")
+                            {
+                                if (arg == "on")
+                                {
+                                    rc().timing_histograms(true);
+                                    result = true;
+                                }
+                                else if (arg == "off")
+                                {
+                                    rc().timing_histograms(false);
+                                    result = true;
+                                }
+                            }
                         }
                         if (! result)
                         {
@@ -1170,6 +1318,9 @@ build_details ()
         << "Event editor on" << std::endl
 #ifdef SEQ64_USE_EVENT_MAP
         << "Event multimap (vs list) on" << std::endl
+#endif
+#ifdef SEQ64_USE_EVENT_ARRAY
+        << "Event sorted array (vs list) on" << std::endl
 #endif
         << "Follow progress bar on" << std::endl
 #ifdef SEQ64_EDIT_SEQUENCE_HIGHLIGHT
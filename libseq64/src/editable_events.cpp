@@ -271,6 +271,7 @@ editable_events::save_events ()
     bool result = count() > 0;
     if (result)
     {
+        sequence::editlock locker(m_sequence);  /* publish only once    */
         m_sequence.events().clear();
         for (const_iterator ei = events().begin(); ei != events().end(); ++ei)
         {
@@ -0,0 +1,343 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_array.cpp
+ *
+ *  This module declares/defines a sorted, block-allocated container of
+ *  events, a third choice of container for the event_list class.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  See the event_array.hpp module.
+ */
+
+#include <algorithm>                    /* std::lower_bound(), etc.         */
+
+#include "event_array.hpp"              /* seq64::event_array               */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.  No block is allocated until an event is added.
+ */
+
+event_array::event_array ()
+ :
+    m_slots         (),
+    m_blocks        (),
+    m_block_used    (SEQ64_EVENT_BLOCK_SIZE),
+    m_free          ()
+{
+    // Empty body
+}
+
+/**
+ *  Copy constructor.  The events are copied in order, into as few blocks as
+ *  needed.  As with the std::list, the note links of the copies still point
+ *  to the original events, until the copy is relinked.
+ *
+ * \param rhs
+ *      The container to copy.
+ */
+
+event_array::event_array (const event_array & rhs)
+ :
+    m_slots         (),
+    m_blocks        (),
+    m_block_used    (SEQ64_EVENT_BLOCK_SIZE),
+    m_free          ()
+{
+    copy(rhs);
+}
+
+/**
+ *  Principal assignment operator.  See the copy constructor.
+ *
+ * \param rhs
+ *      The container to copy.
+ *
+ * \return
+ *      Returns a reference to this container.
+ */
+
+event_array &
+event_array::operator = (const event_array & rhs)
+{
+    if (this != &rhs)
+    {
+        clear();
+        copy(rhs);
+    }
+    return *this;
+}
+
+/**
+ *  Destructor.  Frees the blocks.
+ */
+
+event_array::~event_array ()
+{
+    clear();
+}
+
+/**
+ *  Copies the events of another container, in order, to the end of this
+ *  one.  Used only on an empty container.
+ *
+ * \param rhs
+ *      The container to copy.
+ */
+
+void
+event_array::copy (const event_array & rhs)
+{
+    m_slots.reserve(rhs.m_slots.size());
+    Slots::const_iterator s;
+    for (s = rhs.m_slots.begin(); s != rhs.m_slots.end(); ++s)
+        m_slots.push_back(allocate(**s));
+}
+
+/**
+ *  Stores an event, in a freed place if there is one, else at the end of
+ *  the last block, allocating a new block if it is full.
+ *
+ * \param e
+ *      The event to store.
+ *
+ * \return
+ *      Returns the stable address of the stored event.
+ */
+
+event *
+event_array::allocate (const event & e)
+{
+    event * result;
+    if (! m_free.empty())
+    {
+        result = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        if (m_block_used == SEQ64_EVENT_BLOCK_SIZE)
+        {
+            m_blocks.push_back(new event[SEQ64_EVENT_BLOCK_SIZE]);
+            m_block_used = 0;
+        }
+        result = &m_blocks.back()[m_block_used++];
+    }
+    *result = e;
+    return result;
+}
+
+/**
+ *  Adds an event before any events that compare equal to it, which is where
+ *  event_list::add() puts it with the std::list.
+ *
+ * \param e
+ *      The event to add.
+ *
+ * \return
+ *      Returns the iterator to the event added.
+ */
+
+event_array::iterator
+event_array::insert (const event & e)
+{
+    event * ep = allocate(e);
+    Slots::iterator s = std::lower_bound
+    (
+        m_slots.begin(), m_slots.end(), ep, less
+    );
+    return iterator(m_slots.insert(s, ep));
+}
+
+/**
+ *  Adds an event after any events that compare equal to it, so that events
+ *  added in time order keep the order in which they were added.  This is the
+ *  common case of reading a MIDI file, so it is checked first, and costs no
+ *  search.
+ *
+ * \param e
+ *      The event to add.
+ *
+ * \return
+ *      Returns the iterator to the event added.
+ */
+
+event_array::iterator
+event_array::push_back (const event & e)
+{
+    event * ep = allocate(e);
+    if (m_slots.empty() || ! less(ep, m_slots.back()))
+    {
+        m_slots.push_back(ep);
+        return iterator(m_slots.end() - 1);
+    }
+
+    Slots::iterator s = std::upper_bound
+    (
+        m_slots.begin(), m_slots.end(), ep, less
+    );
+    return iterator(m_slots.insert(s, ep));
+}
+
+/**
+ *  Removes an event.  Its place is kept for reuse.
+ *
+ * \param i
+ *      The iterator to the event.
+ *
+ * \return
+ *      Returns the iterator to the event that followed it.
+ */
+
+event_array::iterator
+event_array::erase (iterator i)
+{
+    event * ep = *i.m_slot;
+    *ep = event();                      /* free any SysEx data now  */
+    m_free.push_back(ep);
+    return iterator(m_slots.erase(i.m_slot));
+}
+
+/**
+ *  Finds a stored event by its address.
+ *
+ * \param ep
+ *      The address of the event, which must be in this container.
+ *
+ * \return
+ *      Returns the iterator to the event, or end() if it is not found.
+ */
+
+event_array::iterator
+event_array::find (const event * ep)
+{
+    Slots::iterator s = std::lower_bound
+    (
+        m_slots.begin(), m_slots.end(), ep, less
+    );
+    for ( ; s != m_slots.end() && ! less(ep, *s); ++s)
+    {
+        if (*s == ep)
+            return iterator(s);
+    }
+    return end();
+}
+
+/**
+ *  Moves the events of a sorted container into this one, leaving it empty.
+ *  As with std::list::merge(), the events of this container come before
+ *  equal events of the other.  The moved events are copied, so their note
+ *  links must be rebuilt, as with the std::multimap.
+ *
+ * \param rhs
+ *      The container to merge, which must be sorted.
+ */
+
+void
+event_array::merge (event_array & rhs)
+{
+    if (&rhs == this || rhs.empty())
+        return;
+
+    std::size_t middle = m_slots.size();
+    m_slots.reserve(middle + rhs.m_slots.size());
+    for (Slots::iterator s = rhs.m_slots.begin(); s != rhs.m_slots.end(); ++s)
+        m_slots.push_back(allocate(**s));
+
+    std::inplace_merge
+    (
+        m_slots.begin(), m_slots.begin() + middle, m_slots.end(), less
+    );
+    rhs.clear();
+}
+
+/**
+ *  Sorts the events, keeping the order of equal events.  Only the pointers
+ *  move.
+ */
+
+void
+event_array::sort ()
+{
+    std::stable_sort(m_slots.begin(), m_slots.end(), less);
+}
+
+/**
+ *  Removes all of the marked events in one pass.
+ *
+ * \return
+ *      Returns true if at least one event was removed.
+ */
+
+bool
+event_array::remove_marked ()
+{
+    Slots::iterator kept = m_slots.begin();
+    for (Slots::iterator s = m_slots.begin(); s != m_slots.end(); ++s)
+    {
+        event * ep = *s;
+        if (ep->is_marked())
+        {
+            *ep = event();
+            m_free.push_back(ep);
+        }
+        else
+            *kept++ = ep;
+    }
+    bool result = kept != m_slots.end();
+    m_slots.erase(kept, m_slots.end());
+    return result;
+}
+
+/**
+ *  Removes all of the events and frees the blocks.
+ */
+
+void
+event_array::clear ()
+{
+    std::vector<event *>::iterator b;
+    for (b = m_blocks.begin(); b != m_blocks.end(); ++b)
+        delete [] *b;
+
+    m_blocks.clear();
+    m_block_used = SEQ64_EVENT_BLOCK_SIZE;
+    m_free.clear();
+    m_slots.clear();
+}
+
+}           // namespace seq64
+
+/*
+ * event_array.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -121,7 +121,8 @@ event_list::event_list ()
     m_events                (),
     m_is_modified           (false),
     m_has_tempo             (false),
-    m_has_time_signature    (false)
+    m_has_time_signature    (false),
+    m_generation            (0)
 {
     // No code needed
 }
@@ -138,7 +139,8 @@ event_list::event_list (const event_list & rhs)
     m_events                (rhs.m_events),
     m_is_modified           (rhs.m_is_modified),
     m_has_tempo             (rhs.m_has_tempo),
-    m_has_time_signature    (rhs.m_has_time_signature)
+    m_has_time_signature    (rhs.m_has_time_signature),
+    m_generation            (0)
 {
     // No code needed
 }
@@ -160,6 +162,7 @@ event_list::operator = (const event_list & rhs)
         m_is_modified           = rhs.m_is_modified;
         m_has_tempo             = rhs.m_has_tempo;
         m_has_time_signature    = rhs.m_has_time_signature;
+        ++m_generation;
     }
     return *this;
 }
@@ -246,6 +249,10 @@ event_list::append (const event & e)
 
     m_events.insert(p);                 /* std::multimap operation  */
 
+#elif defined SEQ64_USE_EVENT_ARRAY
+
+    (void) m_events.insert(e);          /* event_array, sorted      */
+
 #else   // SEQ64_USE_EVENT_MAP
 
     m_events.push_front(e);             /* std::list operation      */
@@ -253,6 +260,7 @@ event_list::append (const event & e)
 #endif
 
     m_is_modified = true;
+    ++m_generation;
     if (e.is_tempo())
         m_has_tempo = true;
 
@@ -309,6 +317,7 @@ event_list::merge (event_list & el, bool /*presort*/ )
     int initialsize = count();
     int addedsize = el.count();
     m_events.insert(el.events().begin(), el.events().end());
+    ++m_generation;
     if (count() != (initialsize + addedsize))
     {
         char tmp[64];
@@ -330,6 +339,7 @@ event_list::merge (event_list & el, bool presort)
         el.sort();                          // el.m_events.sort();
 
     m_events.merge(el.m_events);
+    ++m_generation;
 }
 
 #endif  // SEQ64_USE_EVENT_MAP
@@ -393,6 +403,138 @@ event_list::link_new ()
     }
 }
 
+/**
+ *  Merges a batch of recorded events into the list, then links the new notes
+ *  only.  Replaces adding the recorded events one at a time, each addition
+ *  re-sorting the std::list, followed by a link_new() of the whole list.
+ *  The caller provides the thread-safety.
+ *
+ * \param batch
+ *      The recorded events, in the order received.  With the std::list, they
+ *      are sorted and merged in one pass; the merge splices the nodes, so
+ *      that the iterators to the new notes stay valid.  With the
+ *      std::multimap, each one is inserted at its sorted position.  With the
+ *      event_array, insertions invalidate iterators, so the addresses of the
+ *      new notes, which do not change, are kept instead.
+ */
+
+void
+event_list::merge_recorded (const std::vector<event> & batch)
+{
+    std::vector<iterator> notes;
+    notes.reserve(batch.size());
+
+#ifdef SEQ64_USE_EVENT_MAP
+
+    for
+    (
+        std::vector<event>::const_iterator e = batch.begin();
+        e != batch.end(); ++e
+    )
+    {
+        iterator i = m_events.insert(EventsPair(event_key(*e), *e));
+        if (e->is_note_on() || e->is_note_off())
+            notes.push_back(i);
+    }
+
+#elif defined SEQ64_USE_EVENT_ARRAY
+
+    std::vector<const event *> added;
+    added.reserve(batch.size());
+    for
+    (
+        std::vector<event>::const_iterator e = batch.begin();
+        e != batch.end(); ++e
+    )
+    {
+        iterator i = m_events.push_back(*e);
+        if (e->is_note_on() || e->is_note_off())
+            added.push_back(&*i);
+    }
+    for
+    (
+        std::vector<const event *>::iterator a = added.begin();
+        a != added.end(); ++a
+    )
+    {
+        notes.push_back(m_events.find(*a));
+    }
+
+#else   // SEQ64_USE_EVENT_MAP
+
+    Events recorded(batch.begin(), batch.end());
+    recorded.sort();
+    for (iterator i = recorded.begin(); i != recorded.end(); ++i)
+    {
+        if (i->is_note_on() || i->is_note_off())
+            notes.push_back(i);
+    }
+    m_events.merge(recorded);
+
+#endif  // SEQ64_USE_EVENT_MAP
+
+    m_is_modified = true;
+    ++m_generation;
+    for
+    (
+        std::vector<iterator>::iterator n = notes.begin();
+        n != notes.end(); ++n
+    )
+    {
+        link_recorded(*n);
+    }
+}
+
+/**
+ *  Links a newly-recorded note event.  A Note On is linked to the next
+ *  unlinked Note Off of the same note, wrapping around the end of the list,
+ *  as in link_new().  A Note Off is linked to the nearest unlinked Note On of
+ *  the same note before it, wrapping around the beginning, which is usually
+ *  the one recorded in an earlier batch.  The search stops at the first
+ *  match, which is usually close by, so that the cost does not grow with the
+ *  size of the pattern.
+ *
+ * \param i
+ *      Provides the iterator to the new event.  Other events are ignored.
+ */
+
+void
+event_list::link_recorded (iterator i)
+{
+    event & e = dref(i);
+    bool noteon = e.is_note_on();
+    if (e.is_linked() || (! noteon && ! e.is_note_off()))
+        return;
+
+    iterator j = i;
+    for (;;)
+    {
+        if (noteon)
+        {
+            if (++j == m_events.end())
+                j = m_events.begin();
+        }
+        else
+        {
+            if (j == m_events.begin())
+                j = m_events.end();
+
+            --j;
+        }
+        if (j == i)
+            break;
+
+        event & other = dref(j);
+        bool match = noteon ? other.is_note_off() : other.is_note_on() ;
+        if (match && other.get_note() == e.get_note() && ! other.is_linked())
+        {
+            e.link(&other);
+            other.link(&e);
+            break;
+        }
+    }
+}
+
 /**
  *  This function verifies state: all note-ons have an off, and it links
  *  note-offs with their note-ons.
@@ -678,6 +820,11 @@ event_list::mark_out_of_range (midipulse slength)
 bool
 event_list::remove_marked ()
 {
+#ifdef SEQ64_USE_EVENT_ARRAY
+    bool result = m_events.remove_marked();     /* one pass, no re-search   */
+    if (result)
+        modify();
+#else
     bool result = false;
     Events::iterator i = m_events.begin();
     while (i != m_events.end())
@@ -693,6 +840,7 @@ event_list::remove_marked ()
         else
             ++i;
     }
+#endif
     return result;
 }
 
@@ -62,6 +62,7 @@
 #include "midifile.hpp"                 /* seq64::midifile class        */
 #include "mutex.hpp"                    /* seq64::mutex, automutex      */
 #include "perform.hpp"                  /* seq64::perform class         */
+#include "rt_audit.hpp"                 /* SEQ64_RT_SCOPE()             */
 #include "settings.hpp"                 /* "rc" and "user" settings     */
 
 #undef  SEQ64_USE_DEBUG_OUTPUT          /* define for experiments only  */
@@ -202,6 +203,7 @@ jack_dummy_callback (jack_nframes_t nframes, void * arg)
 int
 jack_transport_callback (jack_nframes_t nframes, void * arg)
 {
+    SEQ64_RT_SCOPE();                   /* a JACK process callback      */
     jack_assistant * j = (jack_assistant *)(arg);
     if (not_nullptr(j))
     {
@@ -1060,17 +1062,34 @@ jack_assistant::position (bool songmode, midipulse tick)
     {
         if (is_null_midipulse(tick))
             tick = 0;
-        else
-            tick *= 10;
     }
     else
         tick = 0;
 
-    int ticks_per_beat = m_ppqn * 10;
-    int beats_per_minute = parent().get_beats_per_minute();
-    uint64_t tick_rate = (uint64_t(m_jack_frame_rate) * tick * 60.0);
-    long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
-    uint64_t jack_frame = tick_rate / tpb_bpm;
+    /*
+     * If the song changes tempo, the time of the tick comes from the tempo
+     * map of the song, rather than from the current tempo.  The same
+     * beat-width scaling is applied in both cases.
+     */
+
+    uint64_t jack_frame;
+    if (parent().tempo_map_active())
+    {
+        double seconds = parent().tick_to_us(double(tick)) / 1000000.0;
+        jack_frame = uint64_t
+        (
+            seconds * m_jack_frame_rate * m_beat_width / 4.0
+        );
+    }
+    else
+    {
+        tick *= 10;
+        int ticks_per_beat = m_ppqn * 10;
+        int beats_per_minute = parent().get_beats_per_minute();
+        uint64_t tick_rate = (uint64_t(m_jack_frame_rate) * tick * 60.0);
+        long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
+        jack_frame = tick_rate / tpb_bpm;
+    }
     if (m_jack_master)
     {
         /*
@@ -1838,6 +1857,7 @@ jack_timebase_callback
     void * arg
 )
 {
+    SEQ64_RT_SCOPE();                   /* a JACK process callback      */
     if (is_nullptr(pos))
     {
         errprint("jack_timebase_callback(): null position pointer");
@@ -33,10 +33,12 @@
  *  buss classes.
  */
 
+#include "app_limits.h"                 /* SEQ64_INPUT_WAKEUP_MS            */
 #include "calculations.hpp"             /* seq64::extract_port_names()      */
 #include "easy_macros.h"
 #include "event.hpp"                    /* seq64::event                     */
 #include "mastermidibase.hpp"           /* seq64::mastermidibase            */
+#include "midi_capture.hpp"             /* seq64::midi_capture              */
 #include "sequence.hpp"                 /* seq64::sequence                  */
 #include "settings.hpp"                 /* seq64::rc()                      */
 
@@ -79,9 +81,14 @@ mastermidibase::mastermidibase
     m_vector_sequence   (),             /* stazed feature                   */
     m_filter_by_channel (false),        /* set based on configuration       */
     m_seq               (nullptr),
+    m_draining          (false),
+    m_play_count        (0),
+    m_capture           (nullptr),
+    m_input_wakeup      (),
+    m_thru_map          (),
     m_mutex             ()
 {
-    // Empty body now
+    (void) m_thru_map.parse(rc().thru_routes());    /* checked by -o thru   */
 }
 
 /**
@@ -172,6 +179,7 @@ void
 mastermidibase::stop ()
 {
     automutex locker(m_mutex);
+    m_outbus_array.drain();                 /* pending notes go out first   */
     m_outbus_array.stop();
     api_stop();
 }
@@ -185,10 +193,14 @@ mastermidibase::stop ()
  *
  * \param tick
  *      Provides the tick value with which to set the buss clock.
+ *
+ * \param schedule
+ *      The delays of the clock pulses up to the tick, or null to send them
+ *      now.  See midibase::clock().
  */
 
 void
-mastermidibase::emit_clock (midipulse tick)
+mastermidibase::emit_clock (midipulse tick, const clock_schedule * schedule)
 {
     automutex locker(m_mutex);
 
@@ -196,7 +208,7 @@ mastermidibase::emit_clock (midipulse tick)
      * Doesn't do anything: api_clock();
      */
 
-    m_outbus_array.clock(tick);
+    m_outbus_array.clock(tick, schedule);
 }
 
 /**
@@ -240,14 +252,34 @@ mastermidibase::set_beats_per_minute (midibpm bpm)
  *  function is called.  For example, ALSA provides a function to "drain" the
  *  output.
  *
+ *  First, the events submitted to the output queues of the busses by play()
+ *  are handed to the MIDI API, in the order submitted.  Only one thread
+ *  drains the queues at a time.  A thread that finds another one draining
+ *  returns at once; the other thread checks the queues again after it is
+ *  done, so that no event is left behind.  The fences order the check of
+ *  the queues with the setting and clearing of m_draining.
+ *
  * \threadsafe
  */
 
 void
 mastermidibase::flush ()
 {
-    automutex locker(m_mutex);
-    api_flush();
+    do
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_draining.exchange(true))
+            break;                          /* the drainer plays our events */
+
+        {
+            automutex locker(m_mutex);
+            m_outbus_array.drain();
+            api_flush();
+        }
+        m_draining.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    } while (m_outbus_array.pending());
 }
 
 /**
@@ -272,6 +304,7 @@ mastermidibase::panic ()
             }
         }
     }
+    flush();
 }
 
 /**
@@ -298,6 +331,12 @@ mastermidibase::sysex (event * ev)
  *  Handle the playing of MIDI events on the MIDI buss given by the
  *  parameter, as long as it is a legal buss number.
  *
+ *  The event is not played here, but submitted to the output queue of the
+ *  buss, without locking, so that the output thread, MIDI thru, and the
+ *  note previews of the user-interface do not block one another.  It goes
+ *  out at the next flush().  If the queue is full, it is drained first.
+ *  During an offline render, the event is captured instead.
+ *
  *  There's currently no implementation-specific API function here.
  *
  * \threadsafe
@@ -312,13 +351,30 @@ mastermidibase::sysex (event * ev)
  *
  * \param channel
  *      The channel on which to play the event.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which the event is to be sent.
+ *      Zero, the default, sends the event immediately.  Used by the
+ *      lookahead rendering of perform::play().
  */
 
 void
-mastermidibase::play (bussbyte bus, event * e24, midibyte channel)
+mastermidibase::play
+(
+    bussbyte bus, event * e24, midibyte channel, long delay_us
+)
 {
-    automutex locker(m_mutex);
-    m_outbus_array.play(bus, e24, channel);
+    if (not_nullptr(m_capture))
+    {
+        m_capture->add(bus, *e24, channel); /* offline render, no output    */
+    }
+    else
+    {
+        while (! m_outbus_array.submit(bus, e24, channel, delay_us))
+            flush();                        /* make room in the queue       */
+    }
+
+    m_play_count.fetch_add(1, std::memory_order_relaxed);
 }
 
 /**
@@ -577,10 +633,12 @@ mastermidibase::poll_for_midi ()
 }
 
 /**
- *  Provides a default implementation of api_poll_for_midi().  This
- *  implementation adds a millisecond of sleep time unless more than two
- *  events are pending.  Some input devices may need to override this
- *  function.
+ *  Provides a default implementation of api_poll_for_midi().  If an input
+ *  port has armed m_input_wakeup, and no input is pending, this function
+ *  blocks until the port posts it, or until SEQ64_INPUT_WAKEUP_MS has
+ *  passed, then polls again.  Otherwise, it adds a millisecond of sleep time
+ *  unless more than two events are pending.  Some input devices may need to
+ *  override this function.
  *
  *  For a quick threadsafe check, call is_more_input() instead.  But see the
  *  warning in the non-API poll_for_midi() function.
@@ -594,7 +652,12 @@ int
 mastermidibase::api_poll_for_midi ()
 {
     int result = m_inbus_array.poll_for_midi();
-    if (result > 0)
+    if (m_input_wakeup.armed())
+    {
+        if (result == 0 && m_input_wakeup.wait(SEQ64_INPUT_WAKEUP_MS))
+            result = m_inbus_array.poll_for_midi();
+    }
+    else if (result > 0)
     {
         if (result <= 2)
             millisleep(1);              /* is this sensible?    */
@@ -693,6 +756,45 @@ mastermidibase::get_midi_event (event * ev)
     return api_get_midi_event(ev);
 }
 
+/**
+ *  Echoes an input event along the MIDI-thru routing table, unless the MIDI
+ *  API has already done so.  Called by the input thread as soon as it gets
+ *  the event, before any other handling.  The input buss of the event is not
+ *  known here, so the input buss of the routes is not checked.
+ *
+ * \threadsafe
+ *
+ * \param ev
+ *      The input event, with the channel kept in its status byte.
+ */
+
+void
+mastermidibase::thru (const event & ev)
+{
+    if (m_thru_map.empty() || api_routes_thru())
+        return;
+
+    midibyte d0, d1;
+    ev.get_data(d0, d1);
+
+    bool played = false;
+    for (int i = 0; i < m_thru_map.count(); ++i)
+    {
+        midibyte status = ev.get_status();
+        midibyte note = d0;
+        if (m_thru_map.apply(i, SEQ64_THRU_ANY, status, note))
+        {
+            event e;
+            e.set_status(status);
+            e.set_data(note, d1);
+            play(m_thru_map.out_bus(i), &e, status & EVENT_GET_CHAN_MASK);
+            played = true;
+        }
+    }
+    if (played)
+        flush();
+}
+
 /**
  *  Set the input sequence object, and set the m_dumping_input value to
  *  the given state.
@@ -822,6 +924,32 @@ mastermidibase::dump_midi_input (event ev)
     }
 }
 
+/**
+ *  Merges the events recorded since the last call into the sequences they
+ *  were recorded into; see sequence::flush_recording().  Called by the input
+ *  thread after each burst of input.  Like dump_midi_input(), it walks the
+ *  recording sequences without locking, since only set_sequence_input()
+ *  changes them.
+ */
+
+void
+mastermidibase::flush_recording ()
+{
+    if (! m_dumping_input)
+        return;
+
+    if (m_filter_by_channel)
+    {
+        for (size_t i = 0; i < m_vector_sequence.size(); ++i)
+        {
+            if (not_nullptr(m_vector_sequence[i]))
+                m_vector_sequence[i]->flush_recording();
+        }
+    }
+    else if (not_nullptr(m_seq))
+        m_seq->flush_recording();
+}
+
 }           // namespace seq64
 
 /*
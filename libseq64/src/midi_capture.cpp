@@ -0,0 +1,133 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_capture.cpp
+ *
+ *  This module declares/defines a timestamped stream of the events played
+ *  to the master buss, for rendering a song to a MIDI file.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-21
+ * \updates       2018-11-21
+ * \license       GNU GPLv2 or above
+ *
+ *  See the midi_capture.hpp module and perform::render_offline().
+ */
+
+#include "midi_capture.hpp"             /* seq64::midi_capture              */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.
+ *
+ * \param bpm
+ *      The tempo in force at the start of the capture.
+ */
+
+midi_capture::midi_capture (midibpm bpm)
+ :
+    m_items     (),
+    m_tick      (0),
+    m_bpm       (bpm)
+{
+    // Empty body
+}
+
+/**
+ *  Records an event, in place of mastermidibase::play().
+ *
+ * \param bus
+ *      The output buss of the event.
+ *
+ * \param ev
+ *      The event.  Only its status, channel, and data bytes are kept.
+ *
+ * \param channel
+ *      The channel of the playback.
+ */
+
+void
+midi_capture::add (bussbyte bus, const event & ev, midibyte channel)
+{
+    item it;
+    it.mc_tick = m_tick;
+    it.mc_tempo = 0.0;
+    midi_out_queue::to_item(ev, channel, 0, it.mc_event);
+    it.mc_bus = bus;
+    m_items.push_back(it);
+}
+
+/**
+ *  Records a tempo change, in place of perform::set_beats_per_minute().
+ *
+ * \param bpm
+ *      The new tempo.
+ */
+
+void
+midi_capture::add_tempo (midibpm bpm)
+{
+    item it;
+    it.mc_tick = m_tick;
+    it.mc_tempo = bpm;
+    it.mc_event.oq_delay_us = 0;
+    it.mc_event.oq_status = 0;
+    it.mc_event.oq_channel = 0;
+    it.mc_event.oq_data[0] = it.mc_event.oq_data[1] = 0;
+    it.mc_event.oq_play_channel = 0;
+    it.mc_bus = 0;
+    m_items.push_back(it);
+}
+
+/**
+ * \return
+ *      Returns one more than the highest buss number of the captured events,
+ *      or 0 if no event was captured.
+ */
+
+int
+midi_capture::bus_count () const
+{
+    int result = 0;
+    for
+    (
+        std::vector<item>::const_iterator i = m_items.begin();
+        i != m_items.end(); ++i
+    )
+    {
+        if (i->mc_tempo == 0.0 && int(i->mc_bus) >= result)
+            result = int(i->mc_bus) + 1;
+    }
+    return result;
+}
+
+}           // namespace seq64
+
+/*
+ * midi_capture.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,202 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_control_map.cpp
+ *
+ *  This module declares/defines the lookup table that dispatches incoming
+ *  events to the MIDI controls they trigger.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  See the midi_control_map.hpp module.
+ */
+
+#include <algorithm>                    /* std::sort(), std::unique()       */
+
+#include "midi_control_map.hpp"         /* seq64::midi_control_map          */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Adds the key of a control setting to a list of keys and controls, if the
+ *  setting is active and its status and data can match a MIDI event.
+ *
+ * \param mc
+ *      The setting.
+ *
+ * \param ctl
+ *      The number of the control.
+ *
+ * \param [out] pairs
+ *      The list, each entry holding the key in the upper bits and the control
+ *      number in the lower byte, so that sorting it sorts by key, then by
+ *      control.
+ *
+ * \param [in,out] count
+ *      The number of entries in the list.
+ */
+
+static void
+add_setting (const midi_control & mc, int ctl, unsigned * pairs, int & count)
+{
+    if (mc.active())
+    {
+        int status = mc.status();
+        int data = mc.data();
+        if (status >= 0 && status <= 0xFF && data >= 0 && data <= 0xFF)
+            pairs[count++] = (unsigned(status) << 16) | (unsigned(data) << 8) |
+                unsigned(ctl);
+    }
+}
+
+/**
+ *  Principal constructor.  The table starts empty, matching no events.
+ */
+
+midi_control_map::midi_control_map ()
+{
+    clear();
+}
+
+/**
+ *  Empties the table.
+ */
+
+void
+midi_control_map::clear ()
+{
+    for (int s = 0; s < SEQ64_MIDI_CONTROL_SLOTS; ++s)
+    {
+        m_slots[s].sl_key = 0;
+        m_slots[s].sl_first = 0;
+        m_slots[s].sl_count = 0;
+    }
+}
+
+/**
+ *  Rebuilds the table from the settings of the MIDI controls.
+ *
+ * \param toggle
+ *      The toggle settings, one per control.
+ *
+ * \param on
+ *      The on settings, one per control.
+ *
+ * \param off
+ *      The off settings, one per control.
+ *
+ * \param count
+ *      The number of controls to map, normally g_midi_control_limit.  It is
+ *      clamped to c_midi_controls_extended.
+ */
+
+void
+midi_control_map::build
+(
+    const midi_control * toggle,
+    const midi_control * on,
+    const midi_control * off,
+    int count
+)
+{
+    if (count > c_midi_controls_extended)
+        count = c_midi_controls_extended;
+
+    unsigned pairs[3 * c_midi_controls_extended];
+    int paircount = 0;
+    for (int ctl = 0; ctl < count; ++ctl)
+    {
+        add_setting(toggle[ctl], ctl, pairs, paircount);
+        add_setting(on[ctl], ctl, pairs, paircount);
+        add_setting(off[ctl], ctl, pairs, paircount);
+    }
+    std::sort(pairs, pairs + paircount);
+    paircount = int(std::unique(pairs, pairs + paircount) - pairs);
+
+    clear();
+    int p = 0;
+    while (p < paircount)
+    {
+        unsigned key = pairs[p] >> 8;
+        int s = hash(key);
+        while (m_slots[s].sl_count > 0)
+            s = (s + 1) & (SEQ64_MIDI_CONTROL_SLOTS - 1);
+
+        m_slots[s].sl_key = key;
+        m_slots[s].sl_first = short(p);
+        for ( ; p < paircount && (pairs[p] >> 8) == key; ++p)
+        {
+            m_controls[p] = short(pairs[p] & 0xFF);
+            ++m_slots[s].sl_count;
+        }
+    }
+}
+
+/**
+ *  Looks up the controls that an event might trigger.
+ *
+ * \param status
+ *      The status byte of the event, including the channel.
+ *
+ * \param d0
+ *      The first data byte of the event.
+ *
+ * \param [out] controls
+ *      Set to the control numbers, in ascending order, if there are any.
+ *
+ * \return
+ *      Returns the number of controls, 0 if the event triggers none.
+ */
+
+int
+midi_control_map::lookup
+(
+    midibyte status, midibyte d0, const short * & controls
+) const
+{
+    unsigned key = make_key(status, d0);
+    int s = hash(key);
+    while (m_slots[s].sl_count > 0)
+    {
+        if (m_slots[s].sl_key == key)
+        {
+            controls = &m_controls[m_slots[s].sl_first];
+            return m_slots[s].sl_count;
+        }
+        s = (s + 1) & (SEQ64_MIDI_CONTROL_SLOTS - 1);
+    }
+    return 0;
+}
+
+}           // namespace seq64
+
+/*
+ * midi_control_map.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
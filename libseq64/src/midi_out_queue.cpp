@@ -0,0 +1,209 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_out_queue.cpp
+ *
+ *  This module declares/defines a lock-free submission queue for the events
+ *  to be sent on an output buss.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-16
+ * \updates       2018-11-16
+ * \license       GNU GPLv2 or above
+ *
+ *  See the midi_out_queue.hpp module and mastermidibase::flush().
+ */
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "midi_out_queue.hpp"           /* seq64::midi_out_queue            */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Constructor.  Allocates the cells, and marks each one as free for the
+ *  producer of its position.
+ *
+ * \param size
+ *      The number of cells.  Must be a power of 2.
+ */
+
+midi_out_queue::midi_out_queue (unsigned size)
+ :
+    m_size          (size),
+    m_cells         (new cell[size]),
+    m_enqueue_pos   (0),
+    m_dequeue_pos   (0)
+{
+    for (unsigned i = 0; i < m_size; ++i)
+        m_cells[i].c_sequence.store(i, std::memory_order_relaxed);
+}
+
+/**
+ *  Destructor.  Frees the cells.
+ */
+
+midi_out_queue::~midi_out_queue ()
+{
+    delete [] m_cells;
+}
+
+/**
+ *  Submits a channel event.  Lock-free, and safe to call from any number of
+ *  threads at once.
+ *
+ * \param e24
+ *      The event to submit.  Only its status, channel, and data bytes are
+ *      copied.
+ *
+ * \param channel
+ *      The channel of the playback, as given to midibase::play().
+ *
+ * \param delay_us
+ *      The delay, as given to midibase::play().
+ *
+ * \return
+ *      Returns false if the queue is full.  The caller must then drain it
+ *      and try again.
+ */
+
+bool
+midi_out_queue::push (const event & e24, midibyte channel, long delay_us)
+{
+    unsigned pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    cell * c;
+    for (;;)
+    {
+        c = &m_cells[pos & (m_size - 1)];
+        unsigned seq = c->c_sequence.load(std::memory_order_acquire);
+        int diff = int(seq - pos);
+        if (diff == 0)
+        {
+            if
+            (
+                m_enqueue_pos.compare_exchange_weak
+                (
+                    pos, pos + 1, std::memory_order_relaxed
+                )
+            )
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+            return false;                               /* the queue is full */
+        else
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    }
+
+    to_item(e24, channel, delay_us, c->c_item);
+    c->c_sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ *  Takes the oldest submitted event out of the queue.  Only one thread at a
+ *  time may call this function.
+ *
+ * \param [out] it
+ *      Receives the event, if any.
+ *
+ * \return
+ *      Returns false if the queue is empty, or if the oldest event is still
+ *      being written by its producer.
+ */
+
+bool
+midi_out_queue::pop (item & it)
+{
+    unsigned pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    cell * c = &m_cells[pos & (m_size - 1)];
+    unsigned seq = c->c_sequence.load(std::memory_order_acquire);
+    if (int(seq - (pos + 1)) < 0)
+        return false;
+
+    it = c->c_item;
+    m_dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    c->c_sequence.store(pos + m_size, std::memory_order_release);
+    return true;
+}
+
+/**
+ *  Fills in an item from a channel event and the arguments of
+ *  midibase::play().  Also used by the render buffers of render_pool.
+ *
+ * \param e24
+ *      The event.  Only its status, channel, and data bytes are copied.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param delay_us
+ *      The delay of the playback.
+ *
+ * \param [out] it
+ *      The item to be filled in.
+ */
+
+void
+midi_out_queue::to_item
+(
+    const event & e24, midibyte channel, long delay_us, item & it
+)
+{
+    midibyte d0, d1;
+    e24.get_data(d0, d1);
+    it.oq_delay_us = delay_us;
+    it.oq_status = e24.get_status();
+    it.oq_channel = e24.get_channel();
+    it.oq_data[0] = d0;
+    it.oq_data[1] = d1;
+    it.oq_play_channel = channel;
+}
+
+/**
+ *  Fills in an event from an item, so that it can be played by the MIDI
+ *  API.  No memory is allocated.
+ *
+ * \param it
+ *      The item taken from the queue.
+ *
+ * \param [out] ev
+ *      The event to be filled in.
+ */
+
+void
+midi_out_queue::to_event (const item & it, event & ev)
+{
+    ev.set_status(it.oq_status, it.oq_channel);
+    ev.set_data(it.oq_data[0], it.oq_data[1]);
+}
+
+}           // namespace seq64
+
+/*
+ * midi_out_queue.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
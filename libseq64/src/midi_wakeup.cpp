@@ -0,0 +1,194 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_wakeup.cpp
+ *
+ *  This module declares/defines the object that wakes the MIDI input thread
+ *  when input arrives.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  See the midi_wakeup.hpp module.
+ */
+
+#include "easy_macros.h"                /* errprint() and the like          */
+#include "midi_wakeup.hpp"              /* seq64::midi_wakeup               */
+#include "midibase.hpp"                 /* seq64::millisleep()              */
+
+#if defined PLATFORM_LINUX
+#include <fcntl.h>                      /* O_NONBLOCK                       */
+#include <poll.h>                       /* ::poll()                         */
+#include <sys/eventfd.h>                /* ::eventfd()                      */
+#include <unistd.h>                     /* ::read(), ::write(), ::close()   */
+#elif defined PLATFORM_UNIX
+#include <fcntl.h>                      /* ::fcntl(), O_NONBLOCK            */
+#include <poll.h>                       /* ::poll()                         */
+#include <unistd.h>                     /* ::pipe(), ::read(), ::write()    */
+#endif
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.  Creates the eventfd or the pipe.  If that fails,
+ *  the wakeup is not valid, can never be armed, and the input thread keeps
+ *  polling.
+ */
+
+midi_wakeup::midi_wakeup ()
+ :
+    m_read_fd   (-1),
+    m_write_fd  (-1),
+    m_armed     (false)
+{
+#if defined PLATFORM_LINUX
+    m_read_fd = m_write_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_read_fd < 0)
+    {
+        errprint("midi_wakeup: could not create the eventfd");
+    }
+#elif defined PLATFORM_UNIX
+    int fds[2];
+    if (::pipe(fds) == 0)
+    {
+        (void) ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        (void) ::fcntl(fds[1], F_SETFL, O_NONBLOCK);
+        m_read_fd = fds[0];
+        m_write_fd = fds[1];
+    }
+    else
+    {
+        errprint("midi_wakeup: could not create the pipe");
+    }
+#endif
+}
+
+/**
+ *  Closes the descriptors.
+ */
+
+midi_wakeup::~midi_wakeup ()
+{
+#if defined PLATFORM_UNIX
+    if (m_write_fd >= 0 && m_write_fd != m_read_fd)
+        (void) ::close(m_write_fd);
+
+    if (m_read_fd >= 0)
+        (void) ::close(m_read_fd);
+#endif
+}
+
+/**
+ *  Wakes the thread waiting in wait(), or the next one to call it.  A single
+ *  non-blocking write, safe to call from a realtime callback.  If the eventfd
+ *  counter or the pipe is full, the wakeup is already pending, and the write
+ *  is simply dropped.
+ */
+
+void
+midi_wakeup::post ()
+{
+#if defined PLATFORM_LINUX
+    if (m_write_fd >= 0)
+    {
+        eventfd_t one = 1;
+        (void) ::write(m_write_fd, &one, sizeof one);
+    }
+#elif defined PLATFORM_UNIX
+    if (m_write_fd >= 0)
+    {
+        char one = 1;
+        (void) ::write(m_write_fd, &one, sizeof one);
+    }
+#endif
+}
+
+/**
+ *  Waits for a post, then clears it.
+ *
+ * \param timeout_ms
+ *      The longest time to wait, in milliseconds.
+ *
+ * \return
+ *      Returns true if the wakeup was posted, false if the wait timed out or
+ *      the wakeup is not valid.  In the latter case, the wait is a sleep of
+ *      one millisecond, as in the old input poll.
+ */
+
+bool
+midi_wakeup::wait (int timeout_ms)
+{
+#if defined PLATFORM_UNIX
+    if (m_read_fd >= 0)
+    {
+        struct pollfd pfd;
+        pfd.fd = m_read_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, timeout_ms) > 0)
+        {
+            drain();
+            return true;
+        }
+        return false;
+    }
+#endif
+    millisleep(1);
+    return false;
+}
+
+/**
+ *  Clears any pending posts without waiting.  Called by wait(), and by code
+ *  that has polled fd() along with descriptors of its own.
+ */
+
+void
+midi_wakeup::drain ()
+{
+#if defined PLATFORM_LINUX
+    if (m_read_fd >= 0)
+    {
+        eventfd_t count;
+        (void) ::read(m_read_fd, &count, sizeof count);
+    }
+#elif defined PLATFORM_UNIX
+    if (m_read_fd >= 0)
+    {
+        char buffer[64];
+        while (::read(m_read_fd, buffer, sizeof buffer) > 0)
+            ;
+    }
+#endif
+}
+
+}           // namespace seq64
+
+/*
+ * midi_wakeup.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
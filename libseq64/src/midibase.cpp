@@ -48,6 +48,7 @@
 
 #include "globals.h"
 #include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
+#include "clock_schedule.hpp"           /* seq64::clock_schedule            */
 #include "event.hpp"                    /* seq64::event (MIDI event)        */
 #include "midibase.hpp"                 /* seq64::midibase for ALSA         */
 #include "settings.hpp"                 /* seq64::rc()                      */
@@ -176,6 +177,7 @@ midibase::midibase
     m_is_virtual_port   (makevirtual),
     m_is_input_port     (isinput),
     m_is_system_port    (makesystem),
+    m_out_queue         (isinput ? nullptr : new midi_out_queue()),
     m_mutex             ()
 {
     if (! makevirtual)
@@ -192,12 +194,12 @@ midibase::midibase
 }
 
 /**
- *  A rote empty destructor.
+ *  A rote destructor.  Deletes the output queue, if any.
  */
 
 midibase::~midibase()
 {
-    // empty body
+    delete m_out_queue;
 }
 
 /**
@@ -574,13 +576,79 @@ midibase::print ()
  *
  * \param channel
  *      The channel of the playback.
+ *
+ * \param delay_us
+ *      If greater than zero, the event is a lookahead event, to be sent
+ *      this many microseconds from now, and it is handed to api_play_at(),
+ *      which lets the backend stamp it with its own clock.
  */
 
 void
-midibase::play (event * e24, midibyte channel)
+midibase::play (event * e24, midibyte channel, long delay_us)
 {
     automutex locker(m_mutex);
-    api_play(e24, channel);
+    if (delay_us > 0)
+        api_play_at(e24, channel, delay_us);
+    else
+        api_play(e24, channel);
+}
+
+/**
+ *  Submits an event to the output queue of this buss, without locking, for
+ *  the next drain().  The port of an input buss has no queue, and so the
+ *  event is played right away.
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.  Only its status, channel, and
+ *      data bytes are queued.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param delay_us
+ *      See play().
+ *
+ * \return
+ *      Returns false if the queue is full.  The caller must then drain it
+ *      and submit the event again.
+ */
+
+bool
+midibase::submit (event * e24, midibyte channel, long delay_us)
+{
+    if (is_nullptr(m_out_queue))
+    {
+        play(e24, channel, delay_us);
+        return true;
+    }
+    return m_out_queue->push(*e24, channel, delay_us);
+}
+
+/**
+ *  Plays all of the events submitted to this buss, in the order in which
+ *  they were submitted.  Only one thread at a time may call this function;
+ *  mastermidibase::flush() sees to that.
+ */
+
+void
+midibase::drain ()
+{
+    if (not_nullptr(m_out_queue))
+    {
+        automutex locker(m_mutex);
+        midi_out_queue::item it;
+        event ev;
+        while (m_out_queue->pop(it))
+        {
+            midi_out_queue::to_event(it, ev);
+            if (it.oq_delay_us > 0)
+                api_play_at(&ev, it.oq_play_channel, it.oq_delay_us);
+            else
+                api_play(&ev, it.oq_play_channel);
+        }
+    }
 }
 
 /**
@@ -750,29 +818,49 @@ midibase::stop ()
 }
 
 /**
- *  Generates the MIDI clock, starting at the given tick value.  The number
- *  of ticks needed is calculated.
+ *  Generates the MIDI clock, starting at the given tick value.  A pulse is
+ *  sent for each multiple of ppqn / 24 passed since the last call, without
+ *  stepping through the ticks in between.
+ *
+ *  If a schedule is given, each pulse is handed to api_clock_at() with the
+ *  delay at which it is due, so that a backend which can schedule its
+ *  output sends the pulses on time, whatever the timing of the output loop.
+ *  Otherwise, or for pulses already due, api_clock() sends them now.
  *
  * \threadsafe
  *
  * \param tick
- *      Provides the starting tick.
+ *      Provides the last tick to be clocked.  With lookahead, this tick is
+ *      at the end of the lookahead window.
+ *
+ * \param schedule
+ *      The delays of the pulses of the pass, or null.
  */
 
 void
-midibase::clock (midipulse tick)
+midibase::clock (midipulse tick, const clock_schedule * schedule)
 {
     automutex locker(m_mutex);
     if (clock_enabled())
     {
-        bool done = m_lasttick >= tick;
-        int ct = clock_ticks_from_ppqn(m_ppqn);         /* ppqn / 24        */
-        while (! done)
+        if (m_lasttick < tick)
         {
-            ++m_lasttick;
-            done = m_lasttick >= tick;
-            if ((m_lasttick % ct) == 0)                 /* tick time yet?   */
-                api_clock(tick);
+            midipulse ct = clock_ticks_from_ppqn(m_ppqn);       /* ppqn / 24 */
+            if (ct < 1)
+                ct = 1;
+
+            midipulse pulse = (m_lasttick + ct) / ct * ct;      /* next one  */
+            for ( ; pulse <= tick; pulse += ct)
+            {
+                long delay = not_nullptr(schedule) ?
+                    schedule->delay_us(pulse) : 0 ;
+
+                if (delay > 0)
+                    api_clock_at(pulse, delay);
+                else
+                    api_clock(pulse);
+            }
+            m_lasttick = tick;
         }
         api_flush();                                    /* and send it out  */
     }
@@ -70,6 +70,7 @@
 #include "file_functions.hpp"           /* seq64::get_full_path()           */
 #include "perform.hpp"                  /* must precede midifile.hpp !      */
 #include "midifile.hpp"                 /* seq64::midifile                  */
+#include "midi_capture.hpp"             /* seq64::midi_capture              */
 #include "midi_vector.hpp"              /* seq64::midi_vector container     */
 #include "sequence.hpp"                 /* seq64::sequence                  */
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
@@ -1514,12 +1515,16 @@ midifile::parse_proprietary_track (perform & p, int file_size)
             midibyte a[6];
             for (int i = 0; i < seqs; ++i)
             {
+                midi_control mc;
                 read_byte_array(a, 6);
-                p.midi_control_toggle(i).set(a);
+                mc.set(a);
+                p.set_midi_control_toggle(i, mc);
                 read_byte_array(a, 6);
-                p.midi_control_on(i).set(a);
+                mc.set(a);
+                p.set_midi_control_on(i, mc);
                 read_byte_array(a, 6);
-                p.midi_control_off(i).set(a);
+                mc.set(a);
+                p.set_midi_control_off(i, mc);
             }
         }
         seqspec = parse_prop_header(file_size);
@@ -2431,6 +2436,174 @@ midifile::write_song (perform & p)
     return result;
 }
 
+/**
+ *  Writes the events captured by perform::render_offline() as a flat SMF 1
+ *  file.  The first track holds the time signature and the tempo changes;
+ *  it is followed by one track for each output buss, up to the highest buss
+ *  used, holding the events played on that buss in the order played.  Each
+ *  event gets the channel it was played on.  Unlike write_song(), which
+ *  copies the events of each exportable pattern, this file holds what the
+ *  song actually plays, so that two renders can be compared.
+ *
+ * \param p
+ *      Provides the performance, for the time signature and the buss names.
+ *
+ * \param cap
+ *      Provides the captured events.
+ *
+ * \return
+ *      Returns true if the write operations succeeded.  If false is returned,
+ *      then m_error_message will contain a description of the error.
+ */
+
+bool
+midifile::write_capture (perform & p, const midi_capture & cap)
+{
+    automutex locker(m_mutex);
+    m_error_message.clear();
+    int buses = cap.bus_count();
+    printf
+    (
+        "[Rendering song as MIDI file, %d ppqn, %d events]\n",
+        m_ppqn, int(cap.items().size())
+    );
+
+    bool result = write_header(buses + 1);
+    if (result)
+    {
+        for (int bus = -1; bus < buses; ++bus)  /* -1 is the tempo track    */
+            write_capture_track(p, cap, bus);
+
+        std::ofstream file
+        (
+            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+        );
+        if (file.is_open())
+        {
+            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
+            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
+
+            std::list<midibyte>::const_iterator it;
+            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
+            {
+                const char c = *it;
+                file.write(&c, 1);
+            }
+        }
+        else
+        {
+            m_error_message = "Error opening MIDI file for rendering";
+            result = false;
+        }
+    }
+    m_char_list.clear();
+    return result;
+}
+
+/**
+ *  Writes one track of write_capture().  The data of the track is written
+ *  to a list of its own first, so that the length of the track, which
+ *  precedes it, is known.
+ *
+ * \param p
+ *      Provides the performance.
+ *
+ * \param cap
+ *      Provides the captured events.
+ *
+ * \param bus
+ *      The buss whose events are written, or -1 for the tempo track.
+ */
+
+void
+midifile::write_capture_track
+(
+    perform & p, const midi_capture & cap, int bus
+)
+{
+    std::list<midibyte> body;
+    body.swap(m_char_list);                     /* keep the file so far     */
+    if (bus < 0)
+    {
+        int bw = p.get_beat_width();
+        int bwlog2 = 0;
+        while (bw > 1)
+        {
+            bw >>= 1;
+            ++bwlog2;
+        }
+        write_track_name("Tempo");
+        write_byte(0x00);                       /* Time Signature           */
+        write_short(0xFF58);
+        write_byte(0x04);
+        write_byte(midibyte(p.get_beats_per_bar()));
+        write_byte(midibyte(bwlog2));
+        write_byte(0x18);                       /* 24 clocks per metronome  */
+        write_byte(0x08);                       /* 8 32nds per quarter      */
+        write_byte(0x00);                       /* Set Tempo                */
+        write_short(0xFF51);
+        write_byte(0x03);
+        write_triple(midilong(tempo_us_from_bpm(cap.bpm())));
+    }
+    else
+    {
+        std::string name;
+        if (not_nullptr(p.m_master_bus))
+            name = p.m_master_bus->get_midi_out_bus_name(bussbyte(bus));
+
+        if (name.empty())
+            name = "Buss " + std::to_string(bus);
+
+        write_track_name(name);
+    }
+
+    midipulse previous = 0;
+    const std::vector<midi_capture::item> & items = cap.items();
+    for
+    (
+        std::vector<midi_capture::item>::const_iterator i = items.begin();
+        i != items.end(); ++i
+    )
+    {
+        const midi_out_queue::item & e = i->mc_event;
+        if (bus < 0)
+        {
+            if (i->mc_tempo > 0.0)
+            {
+                write_varinum(midilong(i->mc_tick - previous));
+                write_short(0xFF51);
+                write_byte(0x03);
+                write_triple(midilong(tempo_us_from_bpm(i->mc_tempo)));
+                previous = i->mc_tick;
+            }
+        }
+        else if
+        (
+            i->mc_tempo == 0.0 && int(i->mc_bus) == bus &&
+            event::is_channel_msg(e.oq_status)
+        )
+        {
+            midibyte channel = e.oq_play_channel == EVENT_NULL_CHANNEL ?
+                e.oq_channel : e.oq_play_channel ;
+
+            write_varinum(midilong(i->mc_tick - previous));
+            write_byte(e.oq_status | (channel & EVENT_GET_CHAN_MASK));
+            write_byte(e.oq_data[0]);
+            if (! event::is_one_byte_msg(e.oq_status))
+                write_byte(e.oq_data[1]);
+
+            previous = i->mc_tick;
+        }
+    }
+    write_byte(0x00);                           /* delta time               */
+    write_track_end();
+
+    body.swap(m_char_list);                     /* body gets the track data */
+    write_long(SEQ64_MTRK_TAG);                 /* magic number 'MTrk'      */
+    write_long(midilong(body.size()));
+    m_char_list.splice(m_char_list.end(), body);
+}
+
 /**
  *  Writes out the final proprietary/SeqSpec section, using the new format if
  *  the legacy format is not in force.
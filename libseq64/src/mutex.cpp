@@ -24,14 +24,17 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-09-03
+ * \updates       2018-11-10
  * \license       GNU GPLv2 or above
  *
  *  Sequencer64 needs a mutex for sequencer operations.
  */
 
+#include <time.h>                       /* CLOCK_MONOTONIC                  */
+
 #include "platform_macros.h"
 #include "mutex.hpp"
+#include "rt_audit.hpp"                 /* SEQ64_RT_CHECK()                 */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -78,15 +81,32 @@ mutex::mutex ()
 }
 
 /**
- *  Lock the mutex.
+ *  Lock the mutex.  In an audit build, a lock in a realtime context is
+ *  reported, whether or not it has to wait this time.
  */
 
 void
 mutex::lock () const
 {
+    SEQ64_RT_CHECK(RT_VIOLATION_MUTEX);
     pthread_mutex_lock(&m_mutex_lock);
 }
 
+/**
+ *  Tries to lock the mutex, without waiting.  Meant for the output thread,
+ *  which must never block on a mutex held by the user-interface.
+ *
+ * \return
+ *      Returns true if the mutex was locked, in which case the caller must
+ *      call unlock().
+ */
+
+bool
+mutex::try_lock () const
+{
+    return pthread_mutex_trylock(&m_mutex_lock) == 0;
+}
+
 /**
  *  Unlock the mutex.
  */
@@ -98,7 +118,9 @@ mutex::unlock () const
 }
 
 /**
- *  Initialize the condition variable with the global variable.
+ *  Initialize the condition variable with the global variable.  If
+ *  SEQ64_CONDVAR_MONOTONIC is defined, it is then re-initialized to measure
+ *  the deadlines of wait_until() with CLOCK_MONOTONIC.
  */
 
 condition_var::condition_var ()
@@ -106,7 +128,13 @@ condition_var::condition_var ()
     mutex   (),                         // @new ca 2016-05-06 (!)
     m_cond  (sm_cond)
 {
-    // Empty body
+#ifdef SEQ64_CONDVAR_MONOTONIC
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&m_cond, &attr);
+    pthread_condattr_destroy(&attr);
+#endif
 }
 
 /**
@@ -119,6 +147,16 @@ condition_var::signal ()
     pthread_cond_signal(&m_cond);
 }
 
+/**
+ *  Signals the condition variable to all of the threads waiting on it.
+ */
+
+void
+condition_var::broadcast ()
+{
+    pthread_cond_broadcast(&m_cond);
+}
+
 /**
  *  Waits for the condition variable.
  */
@@ -126,9 +164,31 @@ condition_var::signal ()
 void
 condition_var::wait ()
 {
+    SEQ64_RT_CHECK(RT_VIOLATION_MUTEX);
     pthread_cond_wait(&m_cond, &m_mutex_lock);
 }
 
+/**
+ *  Waits for the condition variable, but no later than the given deadline.
+ *  The mutex must be locked by the caller, as for wait().
+ *
+ * \param deadline
+ *      The absolute time at which to stop waiting, measured by
+ *      CLOCK_MONOTONIC if SEQ64_CONDVAR_MONOTONIC is defined, and by
+ *      CLOCK_REALTIME otherwise.
+ *
+ * \return
+ *      Returns true if the condition variable was signalled (or the wait was
+ *      spuriously woken), and false if the deadline passed.
+ */
+
+bool
+condition_var::wait_until (const struct timespec & deadline)
+{
+    SEQ64_RT_CHECK(RT_VIOLATION_MUTEX);
+    return pthread_cond_timedwait(&m_cond, &m_mutex_lock, &deadline) == 0;
+}
+
 }           // namespace seq64
 
 /*
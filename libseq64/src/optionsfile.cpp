@@ -1060,9 +1060,13 @@ optionsfile::parse_midi_control_section (const std::string & fname, perform & p)
                 &b[0], &b[1], &b[2], &b[3], &b[4], &b[5],
                 &c[0], &c[1], &c[2], &c[3], &c[4], &c[5]
             );
-            p.midi_control_toggle(i).set(a);
-            p.midi_control_on(i).set(b);
-            p.midi_control_off(i).set(c);
+            midi_control mc;
+            mc.set(a);
+            p.set_midi_control_toggle(i, mc);
+            mc.set(b);
+            p.set_midi_control_on(i, mc);
+            mc.set(c);
+            p.set_midi_control_off(i, mc);
             ok = next_data_line(file);
             if (! ok && i < (sequences - 1))
                 return make_error_message("midi-control", "not enough data");
@@ -161,13 +161,16 @@
 #include "keystroke.hpp"                /* seq64::keystroke class           */
 #include "midibus.hpp"                  /* seq64::midibus class             */
 #include "perform.hpp"                  /* seq64::perform, this class       */
+#include "midifile.hpp"                 /* seq64::midifile, must follow     */
 #include "playlist.hpp"                 /* seq64::playlist, 0.96 and above  */
+#include "rt_audit.hpp"                 /* SEQ64_RT_SCOPE(), etc.           */
 #include "settings.hpp"                 /* seq64::rc()                      */
 
 #if defined PLATFORM_WINDOWS
 #include <windows.h>                    /* Muahhhahahahahah!                */
 #include <mmsystem.h>                   /* Windows timeBeginPeriod()        */
 #else
+#include <errno.h>                      /* EINTR                            */
 #include <time.h>                       /* struct timespec                  */
 #endif
 
@@ -312,6 +315,8 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_midi_cc_toggle            (),         // midi_control []
     m_midi_cc_on                (),         // midi_control []
     m_midi_cc_off               (),         // midi_control []
+    m_midi_control_map          (),
+    m_midi_control_dirty        (true),
     m_control_status            (0),
     m_screenset                 (0),        // vice m_playscreen
     m_screenset_offset          (0),
@@ -321,6 +326,33 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_sequence_count            (0),
     m_sequence_max              (c_max_sequence),
     m_sequence_high             (-1),
+    m_active_seqs               (),
+    m_active_seqs_dirty         (true),
+    m_active_seqs_mode          (false),
+    m_seqs_retired              (),
+    m_seqs_retire               (0),
+    m_seqs_retire_ack           (0),
+    m_wake_lateness_us          (0),
+    m_max_wake_lateness_us      (0),
+    m_lookahead_ticks           (0),
+    m_lookahead_us              (0),
+    m_render_tick               (0),
+    m_render_us_per_tick        (0.0),
+    m_tempo_map                 (nullptr),
+    m_tempo_map_readers         (0),
+    m_tempo_map_retired         (),
+    m_tempo_map_mutex           (),
+    m_render_pool               (nullptr),
+    m_render_parked             (),
+    m_render_play_tick          (0),
+    m_offline_capture           (nullptr),
+    m_timing_stats              (false),
+    m_loop_histogram            (),
+    m_lateness_histogram        (),
+    m_events_histogram          (),
+    m_clock_schedule            (),
+    m_clock_histogram           (),
+    m_underruns                 (0),
 #ifdef SEQ64_EDIT_SEQUENCE_HIGHLIGHT
     m_edit_sequence             (-1),
 #endif
@@ -347,6 +379,7 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_gui_support               (mygui)
 {
     keys().group_max(m_max_groups);
+    m_active_seqs.reserve(size_t(m_sequence_max));  /* no RT allocation */
     for (int i = 0; i < m_sequence_max; ++i)
     {
         m_seqs[i] = nullptr;
@@ -369,8 +402,9 @@ perform::perform (gui_assistant & mygui, int ppqn)
 
 /**
  *  The destructor sets some running flags to false, signals this condition,
- *  then joins the input and output threads if the were launched. Finally, any
- *  active or inactive (but allocated) patterns/sequences are deleted, and
+ *  then joins the input and output threads if the were launched.  The input
+ *  thread may be blocked waiting for input, so it is woken first.  Finally,
+ *  any active or inactive (but allocated) patterns/sequences are deleted, and
  *  their pointers nullified.
  *
  *  Note that we could use m_sequence_high to replace m_sequence_max in the
@@ -385,7 +419,12 @@ perform::~perform ()
         pthread_join(m_out_thread, NULL);
 
     if (m_in_thread_launched)
+    {
+        if (not_nullptr(m_master_bus))
+            m_master_bus->wake_input();             /* end its input wait   */
+
         pthread_join(m_in_thread, NULL);
+    }
 
     for (int seq = 0; seq < m_sequence_high; ++seq) /* m_sequence_max       */
     {
@@ -395,9 +434,13 @@ perform::~perform ()
             m_seqs[seq] = nullptr;                  /* not really necessary */
         }
     }
+    delete_retired_sequences(true);                 /* threads are joined   */
 
     if (not_nullptr(m_master_bus))
         delete m_master_bus;
+
+    delete m_tempo_map.exchange(nullptr);
+    delete_retired_tempo_maps();
 }
 
 /**
@@ -418,6 +461,7 @@ perform::set_ppqn (int p)
 #endif
     m_one_measure = p * 4;                  // simplistic!
     m_right_tick = m_one_measure * 4;       // ditto
+    rebuild_tempo_map();
 }
 
 /**
@@ -1693,8 +1737,9 @@ perform::install_sequence (sequence * seq, int seqnum)
     if (not_nullptr(m_seqs[seqnum]))
     {
         errprintf("m_seqs[%d] not null, deleting old sequence\n", seqnum);
-        delete m_seqs[seqnum];
+        sequence * old = m_seqs[seqnum];
         m_seqs[seqnum] = nullptr;
+        retire_sequence(old);           /* play() might still hold it       */
         if (m_sequence_count > 0)
         {
             --m_sequence_count;
@@ -1706,6 +1751,7 @@ perform::install_sequence (sequence * seq, int seqnum)
         result = true;                  /* a modification occurred  */
     }
     m_seqs[seqnum] = seq;
+    wake_sequences();                   /* rebuild the list of active ones  */
     if (not_nullptr(seq))
     {
         set_active(seqnum, true);
@@ -1716,6 +1762,9 @@ perform::install_sequence (sequence * seq, int seqnum)
 
         result = true;                  /* a modification occurred  */
     }
+    if (result)
+        rebuild_tempo_map();            /* it might hold tempo events       */
+
     return result;
 }
 
@@ -1836,7 +1885,9 @@ perform::new_sequence (int seq)
 /**
  *  Deletes a pattern/sequence by number.  We now also solidify the deletion
  *  by setting the pointer to null after deletion, so it will blow up if
- *  accidentally accessed.  The final act is to raise the "is modified" flag,
+ *  accidentally accessed.  The sequence itself is retired rather than
+ *  deleted at once, since the output thread might still be playing it (see
+ *  retire_sequence()).  The final act is to raise the "is modified" flag,
  *  since deleting an existing sequence is always a significant modification.
  *
  *  Now, this function obviously sets the "active" flag for the sequence to
@@ -1855,9 +1906,11 @@ perform::delete_sequence (int seq)
         set_active(seq, false);
         if (! m_seqs[seq]->get_editing())           /* clarify this!        */
         {
-            m_seqs[seq]->set_playing(false);
-            delete m_seqs[seq];
+            sequence * s = m_seqs[seq];
+            s->set_playing(false);
             m_seqs[seq] = nullptr;
+            retire_sequence(s);                     /* drop it from play()  */
+            rebuild_tempo_map();                    /* drop its tempos      */
             modify();                               /* it is dirty, man     */
         }
     }
@@ -2126,7 +2179,11 @@ perform::set_beats_per_minute (midibpm bpm)
     else if (bpm > SEQ64_MAXIMUM_BPM)
         bpm = SEQ64_MAXIMUM_BPM;
 
-    if (bpm != m_bpm)
+    if (not_nullptr(m_offline_capture))
+    {
+        m_offline_capture->add_tempo(bpm);      /* recorded, not applied    */
+    }
+    else if (bpm != m_bpm)
     {
 
 #ifdef SEQ64_JACK_SUPPORT
@@ -2153,7 +2210,247 @@ perform::set_beats_per_minute (midibpm bpm)
          * Tempo event by user action in the main window (and, later, by
          * incoming MIDI Set Tempo events).
          */
+
+        if (! is_running())
+            rebuild_tempo_map();            /* the base tempo has changed   */
+    }
+}
+
+/**
+ *  Rebuilds the tempo map from the Set Tempo events of all of the active
+ *  patterns, and publishes it.  Called by a sequence that publishes a
+ *  playback snapshot with tempo events in it, or that replaces one that had
+ *  them, and when patterns are installed or deleted, or the PPQN changes.
+ *
+ *  The tempo events are taken as song positions, as they are in a MIDI
+ *  file, which is where a tempo track comes from.  The tempo before the
+ *  first of them is the current beats/minute.  The replaced map is deleted
+ *  once no reader is using it, here or at the next rebuild.
+ *
+ * \threadsafe
+ *      Each sequence snapshot is pinned, not locked, so that this function
+ *      can be called by a sequence that holds its own mutex.
+ */
+
+void
+perform::rebuild_tempo_map ()
+{
+    automutex locker(m_tempo_map_mutex);
+    tempo_map * tm = new tempo_map(get_beats_per_minute(), m_ppqn);
+    for (int s = 0; s < m_sequence_high; ++s)
+    {
+        if (is_active(s))
+            m_seqs[s]->get_tempo_changes(*tm);
+    }
+    tm->finish();
+
+    tempo_map * old = m_tempo_map.exchange(tm);
+    if (not_nullptr(old))
+        m_tempo_map_retired.push_back(old);
+
+    if (m_tempo_map_readers.load() == 0)
+        delete_retired_tempo_maps();
+}
+
+/**
+ *  Deletes the replaced tempo maps.  A reader that starts after the exchange
+ *  in rebuild_tempo_map() sees only the new map.
+ *
+ * \threadunsafe
+ *      The caller must hold m_tempo_map_mutex, or be the destructor.
+ */
+
+void
+perform::delete_retired_tempo_maps ()
+{
+    for
+    (
+        std::vector<tempo_map *>::iterator i = m_tempo_map_retired.begin();
+        i != m_tempo_map_retired.end(); ++i
+    )
+    {
+        delete *i;
     }
+    m_tempo_map_retired.clear();
+}
+
+/**
+ *  Indicates if the song has any tempo event, so that the tempo map, rather
+ *  than the single current tempo, is used to convert ticks to time.
+ */
+
+bool
+perform::tempo_map_active ()
+{
+    ++m_tempo_map_readers;
+    const tempo_map * tm = m_tempo_map.load();
+    bool result = not_nullptr(tm) && tm->active();
+    --m_tempo_map_readers;
+    return result;
+}
+
+/**
+ *  Converts a song position to the time from the start of the song, taking
+ *  all of the tempo changes into account.  Without a tempo map, the current
+ *  tempo is used.
+ *
+ * \param tick
+ *      The song position, which may have a fraction.
+ *
+ * \return
+ *      Returns the time, in microseconds.
+ */
+
+double
+perform::tick_to_us (double tick)
+{
+    ++m_tempo_map_readers;
+    const tempo_map * tm = m_tempo_map.load();
+    double result = (not_nullptr(tm) && tm->active()) ?
+        tm->tick_to_us(tick) :
+        tick * pulse_length_us(get_beats_per_minute(), m_ppqn) ;
+
+    --m_tempo_map_readers;
+    return result;
+}
+
+/**
+ *  Converts a time from the start of the song to a song position.  The
+ *  inverse of tick_to_us().
+ *
+ * \param us
+ *      The time, in microseconds.
+ *
+ * \return
+ *      Returns the song position, with its fraction.
+ */
+
+double
+perform::us_to_tick (double us)
+{
+    ++m_tempo_map_readers;
+    const tempo_map * tm = m_tempo_map.load();
+    double result = (not_nullptr(tm) && tm->active()) ?
+        tm->us_to_tick(us) :
+        us / pulse_length_us(get_beats_per_minute(), m_ppqn) ;
+
+    --m_tempo_map_readers;
+    return result;
+}
+
+/**
+ *  Gets the tempo in force at the given song position.
+ *
+ * \param tick
+ *      The song position.
+ *
+ * \return
+ *      Returns the tempo from the tempo map, or the current tempo if the song
+ *      has no tempo event.
+ */
+
+midibpm
+perform::tempo_at (double tick)
+{
+    ++m_tempo_map_readers;
+    const tempo_map * tm = m_tempo_map.load();
+    midibpm result = (not_nullptr(tm) && tm->active()) ?
+        tm->bpm_at(tick) : get_beats_per_minute() ;
+
+    --m_tempo_map_readers;
+    return result;
+}
+
+/**
+ *  Converts a song position to a time-string for the time displays, taking
+ *  the tempo changes into account.
+ *
+ * \param tick
+ *      The song position.
+ *
+ * \param showus
+ *      If true (the default), shows the microseconds as well.
+ *
+ * \return
+ *      Returns the time-string, as per seq64::pulses_to_timestring().
+ */
+
+std::string
+perform::pulses_to_timestring (midipulse tick, bool showus)
+{
+    std::string result;
+    ++m_tempo_map_readers;
+    const tempo_map * tm = m_tempo_map.load();
+    if (not_nullptr(tm) && tm->active())
+        result = seq64::pulses_to_timestring(tick, *tm, showus);
+    else
+    {
+        result = seq64::pulses_to_timestring
+        (
+            tick, get_beats_per_minute(), m_ppqn, showus
+        );
+    }
+    --m_tempo_map_readers;
+    return result;
+}
+
+/**
+ *  Advances the song time of the output loop through the tempo map, so that
+ *  the ticks follow each tempo change at the tick where it occurs, rather
+ *  than at the next pass of the loop.  The song time is kept in
+ *  microseconds, so that no fraction of a tick is lost between passes.
+ *
+ * \param current
+ *      The current tick of the output loop.
+ *
+ * \param [out] expected
+ *      The tick at which the loop was left by the previous pass.  If the
+ *      current tick differs, the song has been repositioned, and the song
+ *      time is recomputed from the current tick.  Set to -1 when there is no
+ *      map, so that the song time is recomputed once there is one.
+ *
+ * \param [out] map_us
+ *      The song time, in microseconds, advanced by elapsed_us.
+ *
+ * \param elapsed_us
+ *      The time elapsed since the previous pass.
+ *
+ * \param [out] tick
+ *      The new song position, with its fraction.
+ *
+ * \param [out] bpm
+ *      The tempo in force at the new song position.
+ *
+ * \return
+ *      Returns true if the song has a tempo map.  Otherwise, the output
+ *      parameters other than expected are not modified.
+ */
+
+bool
+perform::advance_tempo_map
+(
+    double current, double & expected, double & map_us,
+    long elapsed_us, double & tick, midibpm & bpm
+)
+{
+    bool result = false;
+    ++m_tempo_map_readers;
+    const tempo_map * tm = m_tempo_map.load();
+    if (not_nullptr(tm) && tm->active())
+    {
+        if (current != expected)
+            map_us = tm->tick_to_us(current);   /* repositioned, re-anchor  */
+
+        map_us += double(elapsed_us);
+        tick = tm->us_to_tick(map_us);
+        bpm = tm->bpm_at(tick);
+        result = true;
+    }
+    else
+        expected = -1.0;                        /* re-anchor when in use    */
+
+    --m_tempo_map_readers;
+    return result;
 }
 
 /**
@@ -2456,8 +2753,8 @@ perform::is_sequence_in_edit (int seq) const
  *      reference to sm_mc_dummy otherwise.
  */
 
-midi_control &
-perform::midi_control_toggle (int ctl)
+const midi_control &
+perform::midi_control_toggle (int ctl) const
 {
     return valid_midi_control_seq(ctl) ? m_midi_cc_toggle[ctl] : sm_mc_dummy ;
 }
@@ -2475,8 +2772,8 @@ perform::midi_control_toggle (int ctl)
  *      to sm_mc_dummy otherwise.
  */
 
-midi_control &
-perform::midi_control_on (int ctl)
+const midi_control &
+perform::midi_control_on (int ctl) const
 {
     return valid_midi_control_seq(ctl) ? m_midi_cc_on[ctl] : sm_mc_dummy ;
 }
@@ -2493,12 +2790,74 @@ perform::midi_control_on (int ctl)
  *      to sm_mc_dummy otherwise.
  */
 
-midi_control &
-perform::midi_control_off (int ctl)
+const midi_control &
+perform::midi_control_off (int ctl) const
 {
     return valid_midi_control_seq(ctl) ? m_midi_cc_off[ctl] : sm_mc_dummy ;
 }
 
+/**
+ *  Sets a value in m_midi_cc_toggle[], and tells midi_control_event() to
+ *  rebuild its lookup of the MIDI controls before handling the next event.
+ *
+ * \param ctl
+ *      Provides a control value (such as c_midi_control_bpm_up).  An invalid
+ *      value is ignored.
+ *
+ * \param mc
+ *      Provides the new settings of the control.
+ */
+
+void
+perform::set_midi_control_toggle (int ctl, const midi_control & mc)
+{
+    if (valid_midi_control_seq(ctl))
+    {
+        m_midi_cc_toggle[ctl] = mc;
+        m_midi_control_dirty = true;
+    }
+}
+
+/**
+ *  Sets a value in m_midi_cc_on[].  See set_midi_control_toggle().
+ *
+ * \param ctl
+ *      Provides a control value (such as c_midi_control_bpm_up).
+ *
+ * \param mc
+ *      Provides the new settings of the control.
+ */
+
+void
+perform::set_midi_control_on (int ctl, const midi_control & mc)
+{
+    if (valid_midi_control_seq(ctl))
+    {
+        m_midi_cc_on[ctl] = mc;
+        m_midi_control_dirty = true;
+    }
+}
+
+/**
+ *  Sets a value in m_midi_cc_off[].  See set_midi_control_toggle().
+ *
+ * \param ctl
+ *      Provides a control value (such as c_midi_control_bpm_up).
+ *
+ * \param mc
+ *      Provides the new settings of the control.
+ */
+
+void
+perform::set_midi_control_off (int ctl, const midi_control & mc)
+{
+    if (valid_midi_control_seq(ctl))
+    {
+        m_midi_cc_off[ctl] = mc;
+        m_midi_control_dirty = true;
+    }
+}
+
 /**
  *  Copies the given string into m_screenset_notepad[].
  *
@@ -2557,113 +2916,629 @@ perform::get_screenset_notepad (int screenset) const
 }
 
 /**
- *  Sets the m_screenset value (the index or ID of the current screen-set).
- *  It's not clear that we need to set the "is modified" flag just because we
- *  changed the screen-set, so we don't.
- *
- *  This function is called when incrementing and decrementing the screenset.
- *  Its counterpart, set_playing_screenset(), is called when the hot-key or the
- *  MIDI control for setting the screenset is called.
- *
- *  As a new feature, we would like to queue-mute the previous screenset,
- *  and queue-unmute the newly-selected screenset.  Still working on getting
- *  it right.  Aborted.
- *
- * \param ss
- *      The index of the desired new screen-set.  It is forced to range from
- *      0 to m_max_sets - 1.  The clamping seems weird, but hews to seq24.
- *      What it does is let the user wrap around the screen-sets in the user
- *      interface.  The value set here will represent the "active" screen-set
- *      in multi-window mode.
+ *  Sets the m_screenset value (the index or ID of the current screen-set).
+ *  It's not clear that we need to set the "is modified" flag just because we
+ *  changed the screen-set, so we don't.
+ *
+ *  This function is called when incrementing and decrementing the screenset.
+ *  Its counterpart, set_playing_screenset(), is called when the hot-key or the
+ *  MIDI control for setting the screenset is called.
+ *
+ *  As a new feature, we would like to queue-mute the previous screenset,
+ *  and queue-unmute the newly-selected screenset.  Still working on getting
+ *  it right.  Aborted.
+ *
+ * \param ss
+ *      The index of the desired new screen-set.  It is forced to range from
+ *      0 to m_max_sets - 1.  The clamping seems weird, but hews to seq24.
+ *      What it does is let the user wrap around the screen-sets in the user
+ *      interface.  The value set here will represent the "active" screen-set
+ *      in multi-window mode.
+ *
+ * \return
+ *      Returns the actual final value of the screen-set that was set, i.e. the
+ *      m_screenset member value.
+ */
+
+int
+perform::set_screenset (int ss)
+{
+    if (ss < 0)
+        ss = m_max_sets - 1;
+    else if (ss >= m_max_sets)
+        ss = 0;
+
+    if ((ss != m_screenset) && is_screenset_valid(ss))
+    {
+        m_screenset = ss;
+        m_screenset_offset = screenset_offset(ss);
+        unset_queued_replace();                 /* clear this new feature   */
+    }
+    return m_screenset;
+}
+
+/**
+ *  Sets the screen-set that is active, based on the value of m_screenset.
+ *  This function is called when one of the snapshot keys is pressed.
+ *
+ *  For each value up to m_seqs_in_set (32), the index of the current sequence
+ *  in the current screen-set (m_playscreen) is obtained.  If the sequence
+ *  is active and the sequence actually exists, it is processed; null
+ *  sequences are no longer flagged as an error, they are just ignored.
+ *
+ *  Modifies m_playscreen, m_playscreen_offset, stores the current
+ *  playing-status of each sequence in m_tracks_mute_state[], and then calls
+ *  mute_group_tracks(), turns on unmuted tracks in the current screen-set.
+ *
+ *  Basically, this function retrieves and saves the playing status of the
+ *  sequences in the current play-screen, sets the play-screen to the current
+ *  screen-set, and then mutes the previous play-screen.  It is called via the
+ *  c_midi_control_play_ss value or via the set-playing-screen-set keystroke.
+ */
+
+void
+perform::set_playing_screenset ()
+{
+    for (int s = 0; s < m_seqs_in_set; ++s)
+    {
+        int source = m_playscreen_offset + s;
+        if (is_active(source))
+            m_tracks_mute_state[s] = m_seqs[source]->get_playing();
+    }
+    m_playscreen = m_screenset;
+    m_playscreen_offset = screenset_offset(m_playscreen);
+    mute_group_tracks();
+}
+
+/**
+ *  Starts the playing of all the patterns/sequences.  This function just runs
+ *  down the list of sequences and has them dump their events.  It skips
+ *  sequences that have no playable MIDI events.
+ *
+ *  Note how often the "sp" (sequence) pointer was used.  It was worth
+ *  offloading all these calls to a new sequence function.  Hence the new
+ *  sequence::play_queue() function.
+ *
+ *  Finally, we no longer loop through all patterns up to m_sequence_high.
+ *  Only the patterns in m_active_seqs are played.  A pattern that no longer
+ *  needs to be played on every tick is parked and dropped from the list,
+ *  which is compacted in place, without allocation.  When a parked pattern
+ *  is woken, or the playback mode changes, the list is rebuilt from all of
+ *  the patterns, which are then each played once more before being parked
+ *  again.
+ *
+ *  If rc().lookahead_ms() is not zero, the patterns are played up to the end
+ *  of the lookahead window, rather than up to the current tick, and each
+ *  event is handed to the MIDI buss with the delay at which it is due (see
+ *  render_delay_us()).  The backend then sends it at that time, so that the
+ *  timing of the events no longer depends on when the output thread woke
+ *  up.  The window does not cross the right marker of a song loop, and
+ *  never moves backward.  Mute, queue, and tempo changes apply to the
+ *  window, so they take effect up to one window late.
+ *
+ *  The patterns do not flush the MIDI buss for each event they play.  The
+ *  events of the whole pass are batched in the output buffers of the busses,
+ *  in the order played, and sent with the single flush at the end.
+ *
+ * \param tick
+ *      Provides the tick at which to start playing.  This value is also
+ *      copied to m_tick.
+ */
+
+void
+perform::play (midipulse tick)
+{
+    bool stats = m_timing_stats && not_nullptr(m_master_bus);
+    unsigned long played = stats ? m_master_bus->play_count() : 0 ;
+    bool rebuild = m_active_seqs_dirty.exchange(false);
+    if (rebuild || m_active_seqs_mode != m_playback_mode)
+        rebuild_active_seqs();
+
+    bool forward = tick >= m_tick;
+    set_tick(tick);
+
+    int lookahead_ms = is_nullptr(m_offline_capture) ?
+        rc().lookahead_ms() : 0 ;           /* offline ticks are exact      */
+
+    if (lookahead_ms > 0)
+    {
+        midibpm bpm = m_playback_mode ?
+            tempo_at(tick) : get_beats_per_minute() ;
+
+        m_render_us_per_tick = pulse_length_us(bpm, m_ppqn);
+
+        m_lookahead_us = lookahead_ms * 1000L;
+        m_lookahead_ticks = midipulse(m_lookahead_us / m_render_us_per_tick);
+
+        midipulse render = tick + m_lookahead_ticks;
+        if (m_playback_mode && m_looping && tick < m_right_tick)
+        {
+            if (render >= m_right_tick)
+                render = m_right_tick - 1;
+        }
+        if (forward && render < m_render_tick)
+            render = m_render_tick;         /* the tempo dropped            */
+
+        m_render_tick = tick = render;
+    }
+    else
+    {
+        m_lookahead_ticks = 0;
+        m_lookahead_us = 0;
+    }
+
+    int active = int(m_active_seqs.size());
+    if (not_nullptr(m_render_pool) && active >= SEQ64_RENDER_PARALLEL_MIN)
+    {
+        play_parallel(tick);
+    }
+    else
+    {
+        std::vector<sequence *>::iterator keep = m_active_seqs.begin();
+        for
+        (
+            std::vector<sequence *>::iterator sit = m_active_seqs.begin();
+            sit != m_active_seqs.end(); ++sit
+        )
+        {
+            sequence * s = *sit;
+#ifdef SEQ64_SONG_RECORDING
+            s->play_queue(tick, m_playback_mode, m_resume_note_ons);
+#else
+            s->play_queue(tick, m_playback_mode);
+#endif
+            if (! s->park(m_playback_mode))
+                *keep++ = s;                        /* still active     */
+        }
+        m_active_seqs.erase(keep, m_active_seqs.end());
+    }
+    if (stats)
+        m_events_histogram.record(m_master_bus->play_count() - played);
+
+    if (not_nullptr(m_master_bus))
+        m_master_bus->flush();                      /* one flush a pass */
+}
+
+/**
+ *  Plays the active patterns on the render pool.  Each renderer records
+ *  the events of the patterns it claims in its own buffer (see
+ *  render_sequence()).  The buffers are then merged in an order that does
+ *  not depend on which renderer took which pattern, and the events are put
+ *  on the busses, and the tempo changes applied, by the output thread
+ *  alone.  The parked patterns are dropped from m_active_seqs as in the
+ *  single-threaded loop of play().
+ *
+ * \param tick
+ *      The end tick of the pass, already adjusted for lookahead.
+ */
+
+void
+perform::play_parallel (midipulse tick)
+{
+    int active = int(m_active_seqs.size());
+    m_render_play_tick = tick;
+    m_render_parked.resize(size_t(active));
+    m_render_pool->run(render_thread_func, this, active);
+
+    std::vector<sequence *>::iterator keep = m_active_seqs.begin();
+    for (int i = 0; i < active; ++i)
+    {
+        if (! m_render_parked[i])
+            *keep++ = m_active_seqs[i];             /* still active     */
+    }
+    m_active_seqs.erase(keep, m_active_seqs.end());
+
+    const std::vector<render_item> & merged = m_render_pool->merge();
+    for
+    (
+        std::vector<render_item>::const_iterator ri = merged.begin();
+        ri != merged.end(); ++ri
+    )
+    {
+        if (ri->ri_tempo > 0.0)
+            set_beats_per_minute(ri->ri_tempo);
+        else if (not_nullptr(m_master_bus))
+        {
+            event ev;                               /* allocates nothing    */
+            midi_out_queue::to_event(ri->ri_event, ev);
+            m_master_bus->play
+            (
+                ri->ri_bus, &ev, ri->ri_event.oq_play_channel,
+                ri->ri_event.oq_delay_us
+            );
+        }
+    }
+}
+
+/**
+ *  Renders one pattern of a parallel pass, on a renderer of the render
+ *  pool.  The pattern records its events in the buffer of the renderer
+ *  while it plays.
+ *
+ * \param index
+ *      The position of the pattern in m_active_seqs.
+ *
+ * \param worker
+ *      The index of the renderer.
+ */
+
+void
+perform::render_sequence (int index, int worker)
+{
+    sequence * s = m_active_seqs[index];
+    render_buffer & rb = m_render_pool->buffer(worker);
+    rb.start(index);
+    s->render_to(&rb);
+#ifdef SEQ64_SONG_RECORDING
+    s->play_queue(m_render_play_tick, m_playback_mode, m_resume_note_ons);
+#else
+    s->play_queue(m_render_play_tick, m_playback_mode);
+#endif
+    m_render_parked[index] = s->park(m_playback_mode) ? 1 : 0 ;
+    s->render_to(nullptr);
+}
+
+/**
+ *  Sets the output loop histograms and the underrun count back to zero.
+ *  Can be called from any thread.
+ */
+
+void
+perform::reset_timing_stats ()
+{
+    m_loop_histogram.reset();
+    m_lateness_histogram.reset();
+    m_events_histogram.reset();
+    m_clock_histogram.reset();
+    m_clock_schedule.reset_stats();
+    m_underruns = 0;
+}
+
+/**
+ *  Formats the percentiles of the output loop histograms, one line each,
+ *  plus the underrun count and the MIDI clock skew.  Reads only the atomic
+ *  counts, so it can be called by a user-interface thread at any time,
+ *  without disturbing the output thread.
+ *
+ * \return
+ *      Returns the lines of the report.
+ */
+
+std::string
+perform::timing_report () const
+{
+    char tmp[64];
+    snprintf(tmp, sizeof tmp, "underruns    %lu\n", underruns());
+
+    std::string result = m_loop_histogram.report("loop-us");
+    result += "\n";
+    result += m_lateness_histogram.report("lateness-us");
+    result += "\n";
+    result += m_events_histogram.report("events/pass");
+    result += "\n";
+    result += m_clock_histogram.report("clock-jitter-us");
+    result += "\n";
+    result += tmp;
+    snprintf
+    (
+        tmp, sizeof tmp, "clock-skew   %ld us, max jitter %ld us\n",
+        clock_skew_us(), max_clock_jitter_us()
+    );
+    result += tmp;
+    return result;
+}
+
+/**
+ *  Renders the song to a MIDI file, faster than real time.  The song is
+ *  played in Song mode, from tick 0 to the end of the last trigger, by
+ *  calling play() one tick at a time from a virtual clock, on the calling
+ *  thread.  Triggers, mutes, and transposition apply as in normal playback.
+ *  The events that play() would put on the busses are captured by the
+ *  master buss instead, and stamped with the tick of their pass; the tempo
+ *  changes are captured, but not applied.  The stream is then written by
+ *  midifile::write_capture().
+ *
+ *  Playback must be stopped, and must not be started until this function
+ *  returns.  The patterns are left stopped, as after a Song-mode stop.
+ *
+ * \param filename
+ *      The name of the MIDI file to write.
+ *
+ * \param [out] errmsg
+ *      Receives the reason for a failure.
+ *
+ * \return
+ *      Returns true if the file was written.
+ */
+
+bool
+perform::render_offline (const std::string & filename, std::string & errmsg)
+{
+    if (is_running())
+    {
+        errmsg = "Cannot render the song while it is playing";
+        return false;
+    }
+
+    midipulse end_tick = get_max_trigger();
+    if (end_tick <= 0)
+    {
+        errmsg = "The song has no triggers to render";
+        return false;
+    }
+
+    midi_capture capture(get_beats_per_minute());
+    bool songmode = m_playback_mode;
+    midipulse tick = get_tick();
+    m_offline_capture = &capture;
+    m_master_bus->capture(&capture);
+    playback_mode(true);
+    off_sequences();
+    reset_sequences();                          /* rewinds the patterns     */
+    set_tick(0);
+    m_active_seqs_dirty = true;                 /* play them all again      */
+    for (midipulse t = 0; t <= end_tick; ++t)
+    {
+        capture.tick(t);
+        play(t);
+    }
+    reset_sequences();                          /* final Note Offs          */
+    m_master_bus->capture(nullptr);
+    m_offline_capture = nullptr;
+    playback_mode(songmode);
+    set_tick(tick);
+
+    midifile f(filename, m_ppqn);
+    bool result = f.write_capture(*this, capture);
+    if (! result)
+        errmsg = f.error_message();
+
+    return result;
+}
+
+/**
+ *  Records the lateness of a wake-up of the output thread, and counts an
+ *  underrun if it exceeds the trigger width of the loop.
+ *
+ * \param late_us
+ *      The lateness in microseconds.  Negative values count as 0.
+ */
+
+void
+perform::record_lateness (long late_us)
+{
+    if (late_us < 0)
+        late_us = 0;
+
+    m_lateness_histogram.record((unsigned long)(late_us));
+    if (late_us > c_thread_trigger_width_us)
+        ++m_underruns;
+}
+
+/**
+ *  Rebuilds the list of patterns that play() has to play, putting every
+ *  existing pattern back in it.  The patterns that do not need to be played
+ *  are parked again by play() after one call to sequence::play_queue(), which
+ *  brings their last tick up to date.  Called only by the output thread.
+ */
+
+void
+perform::rebuild_active_seqs ()
+{
+    unsigned long retired = m_seqs_retire.load();   /* before m_seqs[] read */
+    m_active_seqs_mode = m_playback_mode;
+    m_active_seqs.clear();
+    for (int seq = 0; seq < m_sequence_high; ++seq)
+    {
+        sequence * s = get_sequence(seq);
+        if (not_nullptr(s))
+        {
+            s->unpark();
+            m_active_seqs.push_back(s);
+        }
+    }
+    m_seqs_retire_ack = retired;                    /* those are all gone   */
+}
+
+/**
+ *  Retires a pattern that has been removed from m_seqs.  The output thread
+ *  can still be playing it from m_active_seqs, or from the list of the
+ *  current pass, so it cannot be deleted yet.  It is deleted by a later
+ *  call to delete_retired_sequences(), once rebuild_active_seqs() has run
+ *  after its removal.  Until then, it is not playing, and is not reachable
+ *  through m_seqs.  Called only by the user-interface thread.
+ *
+ * \param s
+ *      The pattern, already removed from m_seqs.
+ */
+
+void
+perform::retire_sequence (sequence * s)
+{
+    unsigned long retire = ++m_seqs_retire;         /* after m_seqs[] clear */
+    m_seqs_retired.push_back(std::make_pair(s, retire));
+    wake_sequences();                               /* rebuild the list     */
+    delete_retired_sequences();
+}
+
+/**
+ *  Deletes the retired patterns that the output thread no longer holds,
+ *  that is, those retired at or before the value of m_seqs_retire it saw
+ *  when it last rebuilt m_active_seqs.  The others are kept for a later
+ *  call.
+ *
+ * \param all
+ *      If true, all retired patterns are deleted.  Used by the destructor,
+ *      once the output thread has ended.
+ */
+
+void
+perform::delete_retired_sequences (bool all)
+{
+    unsigned long ack = m_seqs_retire_ack.load();
+    std::vector<std::pair<sequence *, unsigned long>>::iterator keep =
+        m_seqs_retired.begin();
+
+    for
+    (
+        std::vector<std::pair<sequence *, unsigned long>>::iterator i =
+            m_seqs_retired.begin();
+        i != m_seqs_retired.end(); ++i
+    )
+    {
+        if (all || i->second <= ack)
+            delete i->first;
+        else
+            *keep++ = *i;
+    }
+    m_seqs_retired.erase(keep, m_seqs_retired.end());
+}
+
+/**
+ *  Finds the earliest tick, after the given one, at which one of the active
+ *  patterns has something to do.  The list of active patterns is already
+ *  dense, so a linear scan for the minimum is cheaper than maintaining a
+ *  heap that every edit, mute, and queue change would have to update.
+ *  Called only by the output thread.
+ *
+ * \param tick
+ *      The tick just played.
+ *
+ * \return
+ *      Returns the next due tick, or SEQ64_NULL_MIDIPULSE if no pattern has
+ *      anything due.  If the list must be rebuilt, the next tick is
+ *      returned.
+ */
+
+midipulse
+perform::next_due_tick (midipulse tick)
+{
+    if (m_active_seqs_dirty || m_active_seqs_mode != m_playback_mode)
+        return tick + 1;
+
+    midipulse result = SEQ64_NULL_MIDIPULSE;
+    for
+    (
+        std::vector<sequence *>::iterator sit = m_active_seqs.begin();
+        sit != m_active_seqs.end(); ++sit
+    )
+    {
+        midipulse t = (*sit)->next_due_tick(tick, m_playback_mode);
+        if (! is_null_midipulse(t))
+        {
+            if (is_null_midipulse(result) || t < result)
+                result = t;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Indicates if any output buss sends MIDI clock.
  *
  * \return
- *      Returns the actual final value of the screen-set that was set, i.e. the
- *      m_screenset member value.
+ *      Returns true if the clock of an output buss is set to "pos" or "mod".
  */
 
-int
-perform::set_screenset (int ss)
+bool
+perform::sends_clock ()
 {
-    if (ss < 0)
-        ss = m_max_sets - 1;
-    else if (ss >= m_max_sets)
-        ss = 0;
-
-    if ((ss != m_screenset) && is_screenset_valid(ss))
+    int buses = m_master_bus->get_num_out_buses();
+    for (int bus = 0; bus < buses; ++bus)
     {
-        m_screenset = ss;
-        m_screenset_offset = screenset_offset(ss);
-        unset_queued_replace();                 /* clear this new feature   */
+        clock_e ce = m_master_bus->get_clock(bussbyte(bus));
+        if (ce == e_clock_pos || ce == e_clock_mod)
+            return true;
     }
-    return m_screenset;
+    return false;
 }
 
 /**
- *  Sets the screen-set that is active, based on the value of m_screenset.
- *  This function is called when one of the snapshot keys is pressed.
+ *  Calculates how long the event-driven scheduler can sleep, from the
+ *  current position of the output loop:  until the next due pattern tick,
+ *  the next MIDI clock pulse (if any output buss sends clock), or the end
+ *  of the song loop, whichever comes first.  The fraction of a tick carried
+ *  in js_delta_tick_frac is subtracted, so that the output thread wakes as
+ *  the due tick begins.
  *
- *  For each value up to m_seqs_in_set (32), the index of the current sequence
- *  in the current screen-set (m_playscreen) is obtained.  If the sequence
- *  is active and the sequence actually exists, it is processed; null
- *  sequences are no longer flagged as an error, they are just ignored.
+ * \param pad
+ *      The scratchpad of the output loop, which holds the current tick and
+ *      the clock tick.
  *
- *  Modifies m_playscreen, m_playscreen_offset, stores the current
- *  playing-status of each sequence in m_tracks_mute_state[], and then calls
- *  mute_group_tracks(), turns on unmuted tracks in the current screen-set.
+ * \param bpm
+ *      The current tempo.
  *
- *  Basically, this function retrieves and saves the playing status of the
- *  sequences in the current play-screen, sets the play-screen to the current
- *  screen-set, and then mutes the previous play-screen.  It is called via the
- *  c_midi_control_play_ss value or via the set-playing-screen-set keystroke.
+ * \return
+ *      Returns the sleep time in microseconds, at most
+ *      c_scheduler_max_sleep_us.
  */
 
-void
-perform::set_playing_screenset ()
+long
+perform::scheduler_sleep_us (const jack_scratchpad & pad, midibpm bpm)
 {
-    for (int s = 0; s < m_seqs_in_set; ++s)
+    midipulse now = midipulse(pad.js_current_tick);
+    midipulse due = next_due_tick(now + m_lookahead_ticks);
+    midipulse ticks = is_null_midipulse(due) ? 0 : due - now ;
+    if (m_lookahead_ticks > 0 && ! is_null_midipulse(due))
     {
-        int source = m_playscreen_offset + s;
-        if (is_active(source))
-            m_tracks_mute_state[s] = m_seqs[source]->get_playing();
+        ticks -= m_lookahead_ticks;         /* rendered ahead, so due early */
+        if (ticks < 1)
+            ticks = 1;
     }
-    m_playscreen = m_screenset;
-    m_playscreen_offset = screenset_offset(m_playscreen);
-    mute_group_tracks();
+    if (sends_clock())
+    {
+        /*
+         * The pulses up to the end of the lookahead window have already
+         * been scheduled, so the next one to send is beyond it.
+         */
+
+        midipulse ct = clock_ticks_from_ppqn(m_ppqn);
+        midipulse clk = midipulse(pad.js_clock_tick) + m_lookahead_ticks;
+        midipulse delta = (clk / ct + 1) * ct - clk;
+        if (ticks == 0 || delta < ticks)
+            ticks = delta;
+    }
+
+    bool perfloop = m_looping;
+    if (perfloop)
+        perfloop = m_playback_mode || start_from_perfedit() || song_start_mode();
+
+    if (perfloop)
+    {
+        midipulse delta = get_right_tick() - now;
+        if (delta > 0 && (ticks == 0 || delta < ticks))
+            ticks = delta;
+    }
+
+    long result = c_scheduler_max_sleep_us;
+    if (ticks > 0 && bpm > 0.0)
+    {
+        double us = (double(ticks) * 60000000.0 - pad.js_delta_tick_frac) /
+            (bpm * m_ppqn);
+
+        if (us < double(result))
+            result = long(us);
+    }
+    return result;
 }
 
 /**
- *  Starts the playing of all the patterns/sequences.  This function just runs
- *  down the list of sequences and has them dump their events.  It skips
- *  sequences that have no playable MIDI events.
- *
- *  Note how often the "sp" (sequence) pointer was used.  It was worth
- *  offloading all these calls to a new sequence function.  Hence the new
- *  sequence::play_queue() function.
- *
- *  Finally, we stop the looping at m_sequence_high rather than
- *  m_sequence_max, to save a little time.
- *
- * \param tick
- *      Provides the tick at which to start playing.  This value is also
- *      copied to m_tick.
+ *  Wakes the output thread if it is sleeping in the event-driven
+ *  scheduler, so that it recomputes the next due tick.  Called when a
+ *  pattern is woken, or its events are edited.  The condition-variable
+ *  mutex is held while signalling, so that a wake-up issued while the
+ *  output thread computes its deadline is not lost.
  */
 
 void
-perform::play (midipulse tick)
+perform::wake_output ()
 {
-    set_tick(tick);
-    for (int seq = 0; seq < m_sequence_high; ++seq)
+    if (rc().output_scheduler() == e_scheduler_event)
     {
-        sequence * s = get_sequence(seq);
-        if (not_nullptr(s))
-#ifdef SEQ64_SONG_RECORDING
-            s->play_queue(tick, m_playback_mode, m_resume_note_ons);
-#else
-            s->play_queue(tick, m_playback_mode);
-#endif
+        m_condition_var.lock();
+        m_condition_var.signal();
+        m_condition_var.unlock();
     }
-    if (not_nullptr(m_master_bus))
-        m_master_bus->flush();                      /* flush MIDI buss  */
 }
 
 /**
@@ -3580,6 +4455,133 @@ perform::get_max_trigger () const
     return result;
 }
 
+#ifndef PLATFORM_WINDOWS
+
+/**
+ *  Reads CLOCK_MONOTONIC, which is not slewed by NTP or set by the user, for
+ *  the absolute-deadline timing of the output thread.
+ *
+ * \return
+ *      Returns the current monotonic time in microseconds.
+ */
+
+static long long
+monotonic_us ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)(ts.tv_sec) * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ *  Sleeps until the given absolute monotonic time, resuming the sleep if a
+ *  signal interrupts it.
+ *
+ * \param deadline_us
+ *      The wake-up time, in microseconds of CLOCK_MONOTONIC.
+ */
+
+static void
+sleep_until_us (long long deadline_us)
+{
+    struct timespec ts;
+    ts.tv_sec = time_t(deadline_us / 1000000LL);
+    ts.tv_nsec = long(deadline_us % 1000000LL) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+        // Empty body
+    }
+}
+
+/**
+ *  Converts a CLOCK_MONOTONIC time to a deadline for
+ *  condition_var::wait_until().  If the condition variable uses
+ *  CLOCK_MONOTONIC (SEQ64_CONDVAR_MONOTONIC), the time is passed as is.
+ *  Otherwise it is moved to CLOCK_REALTIME, which a clock step can then
+ *  distort.
+ *
+ * \param deadline_us
+ *      The wake-up time, in microseconds of CLOCK_MONOTONIC.
+ *
+ * \return
+ *      Returns the deadline in the clock of the condition variable.
+ */
+
+static struct timespec
+condvar_deadline (long long deadline_us)
+{
+#ifndef SEQ64_CONDVAR_MONOTONIC
+    struct timespec rt;
+    clock_gettime(CLOCK_REALTIME, &rt);
+    deadline_us += (long long)(rt.tv_sec) * 1000000LL + rt.tv_nsec / 1000 -
+        monotonic_us();
+#endif
+
+    struct timespec ts;
+    ts.tv_sec = time_t(deadline_us / 1000000LL);
+    ts.tv_nsec = long(deadline_us % 1000000LL) * 1000;
+    return ts;
+}
+
+/**
+ *  Sends the MIDI clock pulses of a pass of the output loop, each at its
+ *  exact time on the 24-PPQN grid.  The delay of each pulse from now is
+ *  computed from the tempo map, from the tick position and its fraction,
+ *  corrected for the time spent since the ticks were computed.  With
+ *  lookahead, the pulses up to the end of the window are handed to the
+ *  busses with their delays, so that a backend which can schedule its
+ *  output sends them on time, however late the output thread is.  Without
+ *  lookahead, the pulses due are sent now, as before.  The pulses sent are
+ *  then measured, for clock_skew_us() and the clock-jitter histogram.
+ *
+ * \param pad
+ *      The scratchpad of the output loop, which holds the clock tick, the
+ *      current tick, and the fraction of a tick.
+ *
+ * \param pass_us
+ *      The monotonic time at which the ticks of the pass were computed.
+ */
+
+void
+perform::emit_scheduled_clock (const jack_scratchpad & pad, long long pass_us)
+{
+    midipulse endtick = midipulse(pad.js_clock_tick) + m_lookahead_ticks;
+    if (! sends_clock())
+    {
+        m_master_bus->emit_clock(endtick);      /* updates the busses only */
+        return;
+    }
+
+    long long now_us = monotonic_us();
+    double fraction = double(pad.js_delta_tick_frac) / 60000000.0;
+    double songtick = pad.js_current_tick + fraction;
+    midibpm bpm = m_playback_mode ?
+        tempo_at(songtick) : get_beats_per_minute() ;
+
+    double ahead = 0.0;
+    if (bpm > 0.0 && now_us > pass_us)
+        ahead = double(now_us - pass_us) / pulse_length_us(bpm, m_ppqn);
+
+    ++m_tempo_map_readers;
+    const tempo_map * tm = m_tempo_map.load();
+    if (! m_playback_mode || is_nullptr(tm) || ! tm->active())
+        tm = nullptr;
+
+    m_clock_schedule.build
+    (
+        pad.js_clock_tick + fraction + ahead, songtick + ahead, endtick, tm, bpm
+    );
+    --m_tempo_map_readers;
+
+    m_master_bus->emit_clock(endtick, &m_clock_schedule);
+    (void) m_clock_schedule.measure
+    (
+        now_us, m_timing_stats ? &m_clock_histogram : nullptr
+    );
+}
+
+#endif  // ! PLATFORM_WINDOWS
+
 /**
  *  Set up the performance, set the process to realtime privileges, and then
  *  start the output function.
@@ -3628,6 +4630,27 @@ output_thread_func (void * myperf)
     return nullptr;
 }
 
+/**
+ *  The render function of the render pool.  Renders one pattern of a
+ *  parallel pass of perform::play().
+ *
+ * \param myperf
+ *      Provides the perform object instance.  Not validated, for speed.
+ *
+ * \param index
+ *      The position of the pattern in the list of active patterns.
+ *
+ * \param worker
+ *      The index of the renderer, which selects its render buffer.
+ */
+
+void
+render_thread_func (void * myperf, int index, int worker)
+{
+    perform * p = (perform *) myperf;
+    p->render_sequence(index, worker);
+}
+
 /**
  *  Initializes JACK support, if SEQ64_JACK_SUPPORT is defined.  Who calls
  *  this routine?  The main() routine of the application [via launch()],
@@ -3694,6 +4717,19 @@ perform::deinit_jack_transport ()
 void
 perform::output_func ()
 {
+    /*
+     * The render workers are created here, so that they inherit the
+     * scheduling priority of the output thread.
+     */
+
+    if (rc().render_threads() > 1)
+    {
+        m_render_pool = new render_pool(rc().render_threads());
+        m_render_parked.reserve(size_t(SEQ64_SEQUENCE_MAXIMUM));
+    }
+    if (rc().timing_histograms())
+        m_timing_stats = true;
+
     while (m_outputing)         /* PERHAPS we should LOCK this variable */
     {
         m_condition_var.lock();
@@ -3831,6 +4867,35 @@ perform::output_func ()
 
 #endif  // SEQ64_STATISTICS_SUPPORT
 
+#ifndef PLATFORM_WINDOWS
+
+        /*
+         * Absolute timing.  The ticks are computed from the time elapsed
+         * since anchor_us, rather than by adding up loop deltas, and the
+         * thread sleeps until absolute deadlines.  When the tempo changes,
+         * the anchor moves to the time of the last whole tick, so that the
+         * tick fraction is kept.
+         */
+
+        bool absolute_timing = rc().absolute_timing();
+        long long anchor_us = monotonic_us();
+        long long anchor_ticks = 0;         /* whole ticks since anchor_us  */
+        midibpm anchor_bpm = m_master_bus->get_beats_per_minute();
+        long long tick_time_us = anchor_us; /* when the ticks were computed */
+        long long deadline_us = anchor_us;  /* the last wake-up deadline    */
+
+        /*
+         * Song time from the tempo map, when the song has tempo events.  See
+         * advance_tempo_map().
+         */
+
+        double map_us = 0.0;                /* song time of the ticks       */
+        double map_expected = -1.0;         /* tick left by the last pass   */
+        long long map_time_us = anchor_us;  /* when map_us was advanced     */
+        m_wake_lateness_us = 0;
+        m_max_wake_lateness_us = 0;
+#endif
+
         while (is_running())
         {
             /**
@@ -3841,6 +4906,8 @@ perform::output_func ()
              * -# Play from current tick to prebuffer.
              */
 
+            SEQ64_RT_ENTER();               /* the work, not the sleep      */
+
 #ifdef SEQ64_STATISTICS_SUPPORT
             if (rc().stats())
             {
@@ -3883,6 +4950,58 @@ perform::output_func ()
 
             long delta_tick = long(delta_tick_num / delta_tick_denom);
             pad.js_delta_tick_frac = long(delta_tick_num % delta_tick_denom);
+#ifndef PLATFORM_WINDOWS
+            if (absolute_timing && bpm > 0.0)
+            {
+                tick_time_us = monotonic_us();
+                if (bpm != anchor_bpm)
+                {
+                    anchor_us += (long long)
+                    (
+                        anchor_ticks * 60000000.0 / (anchor_bpm * ppqn)
+                    );
+                    anchor_ticks = 0;
+                    anchor_bpm = bpm;
+                }
+
+                double units = double(tick_time_us - anchor_us) * bpm * ppqn;
+                long long total = (long long)(units / 60000000.0);
+                delta_tick = long(total - anchor_ticks);
+                anchor_ticks = total;
+                pad.js_delta_tick_frac = long(units - total * 60000000.0);
+            }
+
+            /*
+             * In song mode, with tempo events in the song, the ticks follow
+             * the tempo map, so that a tempo change takes effect at its own
+             * tick, and the MIDI clock and the scheduler use the tempo in
+             * force at the new tick.
+             */
+
+            long long map_now_us = monotonic_us();
+            long map_elapsed_us = long(map_now_us - map_time_us);
+            map_time_us = map_now_us;
+            if (m_playback_mode && ! m_usemidiclock && ! is_jack_running())
+            {
+                double exact;
+                bool mapped = advance_tempo_map
+                (
+                    pad.js_current_tick, map_expected, map_us,
+                    map_elapsed_us, exact, bpm
+                );
+                if (mapped)
+                {
+                    delta_tick = long(exact) - long(pad.js_current_tick);
+                    if (delta_tick < 0)
+                        delta_tick = 0;
+
+                    pad.js_delta_tick_frac =
+                        long((exact - long(exact)) * 60000000.0);
+                }
+            }
+            else
+                map_expected = -1.0;
+#endif
             if (m_usemidiclock)
             {
                 delta_tick = m_midiclocktick;       /* int to double */
@@ -3898,6 +5017,7 @@ perform::output_func ()
                     m_midiclockpos;
 
                 m_midiclockpos = -1;
+                m_clock_schedule.restart(m_ppqn);
             }
 
 #ifdef SEQ64_JACK_SUPPORT
@@ -3974,6 +5094,7 @@ perform::output_func ()
             if (pad.js_init_clock)
             {
                 m_master_bus->init_clock(midipulse(pad.js_clock_tick));
+                m_clock_schedule.restart(m_ppqn);
                 pad.js_init_clock = false;
             }
             if (pad.js_dumping)
@@ -4055,6 +5176,9 @@ perform::output_func ()
                  */
 
                 set_jack_tick(pad.js_current_tick);
+#ifndef PLATFORM_WINDOWS
+                map_expected = pad.js_current_tick;
+#endif
 
                 /*
                  * ca 2017-04-03 issue #67.
@@ -4064,7 +5188,11 @@ perform::output_func ()
                  * m_master_bus->clock(midipulse(pad.js_clock_tick));
                  */
 
+#ifdef PLATFORM_WINDOWS
                 m_master_bus->emit_clock(midipulse(pad.js_clock_tick));
+#else
+                emit_scheduled_clock(pad, map_time_us);
+#endif
 
 #ifdef SEQ64_STATISTICS_SUPPORT
                 if (rc().stats())
@@ -4101,6 +5229,8 @@ perform::output_func ()
 #endif  // SEQ64_STATISTICS_SUPPORT
             }
 
+            SEQ64_RT_LEAVE();
+
             /**
              *  Figure out how much time we need to sleep, and do it.
              */
@@ -4117,6 +5247,13 @@ perform::output_func ()
             delta.tv_nsec = current.tv_nsec - last.tv_nsec;
             long elapsed_us = (delta.tv_sec * 1000000) + (delta.tv_nsec / 1000);
 #endif
+            if (m_timing_stats)
+            {
+                long work_us = elapsed_us > 0 ? elapsed_us : 0 ;
+                m_loop_histogram.record((unsigned long)(work_us));
+                if (work_us > c_thread_trigger_width_us)
+                    ++m_underruns;
+            }
 
             /**
              * Now we want to trigger every c_thread_trigger_width_us, and it
@@ -4140,15 +5277,104 @@ perform::output_func ()
             if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
                 delta_us = long(next_clock_delta_us);
 
+#ifndef PLATFORM_WINDOWS
+
+            /*
+             * The event-driven scheduler sleeps until the next due tick, or
+             * until woken by a change in the patterns.  It needs the ticks
+             * to follow the system clock, so it is not used when slaved to
+             * JACK transport or to MIDI clock.
+             */
+
+            bool event_scheduler =
+                rc().output_scheduler() == e_scheduler_event &&
+                ! m_usemidiclock && ! is_jack_running();
+
+            if (absolute_timing)
+            {
+                /*
+                 * The deadline is absolute: the previous deadline plus the
+                 * trigger width, or the due time computed from the moment
+                 * the ticks were computed.  If the deadline has already
+                 * passed, the loop runs again at once, and the deadlines
+                 * start over from now, rather than trying to catch up.
+                 */
+
+                long long now_us = monotonic_us();
+                bool woken = false;
+                if (event_scheduler)
+                {
+                    m_condition_var.lock();
+                    deadline_us = tick_time_us + scheduler_sleep_us(pad, bpm);
+                    long long wait_us = deadline_us - monotonic_us();
+                    if (wait_us > 0 && is_running())
+                    {
+                        woken = m_condition_var.wait_until
+                        (
+                            condvar_deadline(deadline_us)
+                        );
+                    }
+                    m_condition_var.unlock();
+                }
+                else
+                {
+                    deadline_us += c_thread_trigger_width_us;
+                    if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
+                        deadline_us = tick_time_us + long(next_clock_delta_us);
+
+                    if (deadline_us > now_us)
+                        sleep_until_us(deadline_us);
+                }
+
+                long long late = monotonic_us() - deadline_us;
+                if (late < 0 || woken)
+                    late = 0;                       /* woken early, on purpose */
+                else if (late > c_thread_trigger_width_us)
+                    deadline_us = monotonic_us();   /* overrun, resynchronize  */
+
+                m_wake_lateness_us = long(late);
+                if (late > m_max_wake_lateness_us)
+                    m_max_wake_lateness_us = long(late);
+
+                if (m_timing_stats && ! woken)
+                    record_lateness(long(late));
+            }
+            else if (event_scheduler)
+            {
+                m_condition_var.lock();
+                delta_us = scheduler_sleep_us(pad, bpm) - elapsed_us;
+                if (delta_us > 0 && is_running())
+                {
+                    long long wait_start_us = monotonic_us();
+                    bool woken = m_condition_var.wait_until
+                    (
+                        condvar_deadline(wait_start_us + delta_us)
+                    );
+                    if (m_timing_stats && ! woken)
+                    {
+                        long long slept = monotonic_us() - wait_start_us;
+                        record_lateness(long(slept - delta_us));
+                    }
+                }
+                m_condition_var.unlock();
+            }
+            else
+#endif
             if (delta_us > 0)
             {
 #ifdef PLATFORM_WINDOWS
                 delta = delta_us / 1000;
                 Sleep(delta);
 #else
+                long long sleep_start_us = monotonic_us();
                 delta.tv_sec = delta_us / 1000000;
                 delta.tv_nsec = (delta_us % 1000000) * 1000;
                 nanosleep(&delta, NULL);    /* nanosleep() is Linux */
+                if (m_timing_stats)
+                {
+                    long long slept = monotonic_us() - sleep_start_us;
+                    record_lateness(long(slept - delta_us));
+                }
 #endif
             }
 #ifdef SEQ64_STATISTICS_SUPPORT
@@ -4225,6 +5451,16 @@ perform::output_func ()
             {
                 printf("[%3d][%8ld]\n", i * 300, stats_clock[i]);
             }
+#ifndef PLATFORM_WINDOWS
+            if (absolute_timing)
+            {
+                printf
+                (
+                    "\n\n-- max wake lateness: [%ld us]\n",
+                    max_wake_lateness_us()
+                );
+            }
+#endif
         }
 #endif  // SEQ64_STATISTICS_SUPPORT
 
@@ -4277,6 +5513,11 @@ perform::output_func ()
 #endif
 
     }
+    if (not_nullptr(m_render_pool))
+    {
+        delete m_render_pool;
+        m_render_pool = nullptr;
+    }
     pthread_exit(0);
 }
 
@@ -5018,6 +6259,11 @@ perform::set_thru (bool thru_active, int seq, bool toggle)
  *      support playlist controls and to reserve a much larger set of MIDI
  *      controls, including reserved values, bringing the number up to 96.
  *
+ *  Rather than checking every control, the event's status and first data
+ *  byte are looked up in m_midi_control_map, which yields the controls that
+ *  can match it, in ascending order.  The map is rebuilt here if the
+ *  settings have changed since the last event.
+ *
  * \param ev
  *      Provides the MIDI event to potentially trigger a control action.
  *
@@ -5028,10 +6274,27 @@ perform::set_thru (bool thru_active, int seq, bool toggle)
 bool
 perform::midi_control_event (const event & ev)
 {
+    if (m_midi_control_dirty.exchange(false))
+    {
+        m_midi_control_map.build
+        (
+            m_midi_cc_toggle, m_midi_cc_on, m_midi_cc_off,
+            g_midi_control_limit
+        );
+    }
+
     bool result = false;
-    int offset = m_screenset_offset;
-    for (int ctl = 0; ctl < g_midi_control_limit; ++ctl, ++offset)
+    midibyte d0 = 0, d1 = 0;
+    ev.get_data(d0, d1);
+
+    const short * controls = nullptr;
+    int count = m_midi_control_map.lookup(ev.get_status(), d0, controls);
+    int screenset_offset = m_screenset_offset;
+    for (int c = 0; c < count; ++c)
     {
+        int ctl = controls[c];
+        int offset = screenset_offset + ctl;
+
         /*
          * \change ca 2018-10-28 GitHub issue #170.
          *      Breaking after success prevents a MIDI control from handling
@@ -5362,6 +6625,14 @@ perform::handle_playlist_control (int ctl, midi_control::action a, int v)
  *  For events less than or equal to SysEx, we call midi_control_event()
  *  to handle the MIDI controls that Sequencer64 supports.  (These are
  *  configurable in the "rc" configuration file.)
+ *
+ *  Recorded events are buffered by the sequences that record them, and are
+ *  merged into them after each burst of input.  See
+ *  mastermidibase::flush_recording().
+ *
+ *  Before any of that, each event is echoed along the MIDI-thru routing
+ *  table (the "-o thru" option), unless the MIDI API did so in its input
+ *  callback.  See mastermidibase::thru().
  */
 
 void
@@ -5372,10 +6643,13 @@ perform::input_func ()
     {
         if (m_master_bus->poll_for_midi() > 0)
         {
+            SEQ64_RT_SCOPE();               /* the handling, not the poll   */
             do
             {
                 if (m_master_bus->get_midi_event(&ev))
                 {
+                    m_master_bus->thru(ev);         /* thru routes first    */
+
                     /*
                      * Used when starting from the beginning of the song.
                      * Obey the MIDI time clock.  Comments moved to the
@@ -5513,6 +6787,7 @@ perform::input_func ()
                     }
                 }
             } while (m_master_bus->is_more_input());
+            m_master_bus->flush_recording();        /* merge what came in   */
         }
     }
     pthread_exit(0);
@@ -0,0 +1,169 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playback_events.cpp
+ *
+ *  This module declares/defines a read-only snapshot of the playable events
+ *  of a sequence, for use by the output thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-10
+ * \updates       2018-11-10
+ * \license       GNU GPLv2 or above
+ *
+ *  See the playback_events.hpp module and sequence::publish_playback().
+ */
+
+#include "playback_events.hpp"          /* seq64::playback_events       */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  Creates the empty snapshot that a new sequence
+ *  publishes.
+ */
+
+playback_events::playback_events ()
+ :
+    m_items         (),
+    m_generation    (0),
+    m_length        (0),
+    m_tempo_count   (0)
+{
+    // Empty body
+}
+
+/**
+ *  Principal constructor.  Copies the playable events of the event list,
+ *  which must already be sorted.  This constructor allocates, and so is
+ *  meant to be called only by the editing side of the sequence, never by
+ *  the output thread.
+ *
+ * \threadunsafe
+ *      The caller must hold the sequence mutex, so that the event list does
+ *      not change while it is copied.
+ *
+ * \param evl
+ *      Provides the event list to be copied.
+ *
+ * \param generation
+ *      Provides the generation of the event list, to be saved as the
+ *      identity of the snapshot.
+ *
+ * \param len
+ *      Provides the length of the sequence, which is published with the
+ *      events.
+ */
+
+playback_events::playback_events
+(
+    const event_list & evl,
+    unsigned long generation,
+    midipulse len
+) :
+    m_items         (),
+    m_generation    (generation),
+    m_length        (len),
+    m_tempo_count   (0)
+{
+    m_items.reserve(size_t(evl.count()));
+    for (event_list::const_iterator i = evl.begin(); i != evl.end(); ++i)
+    {
+        const event & e = DREF(i);
+        bool tempo = e.is_tempo();
+        if (tempo || ! e.is_ex_data())
+        {
+            midibyte d0, d1;
+            item it;
+            e.get_data(d0, d1);
+            it.pe_timestamp = e.get_timestamp();
+            it.pe_tempo = tempo ? e.tempo() : 0.0 ;
+            it.pe_status = e.get_status();
+            it.pe_channel = e.get_channel();
+            it.pe_data[0] = d0;
+            it.pe_data[1] = d1;
+            m_items.push_back(it);
+            if (tempo)
+                ++m_tempo_count;
+        }
+    }
+}
+
+/**
+ *  Finds the first item whose time-stamp is not less than the given tick.
+ *  A binary search, used to re-seek the playback cursor.
+ *
+ * \param tick
+ *      The time-stamp to look for.
+ *
+ * \return
+ *      Returns the index of the item found, or count() if all of the items
+ *      are earlier than the tick.
+ */
+
+int
+playback_events::lower_bound (midipulse tick) const
+{
+    int low = 0;
+    int high = count();
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (m_items[middle].pe_timestamp < tick)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+/**
+ *  Fills in an event from a (non-tempo) item, so that it can be put on the
+ *  MIDI buss.  No memory is allocated, since the event's SysEx container is
+ *  left empty.
+ *
+ * \param index
+ *      The index of the item.  Not validated.
+ *
+ * \param [out] ev
+ *      The event to be filled in.
+ */
+
+void
+playback_events::to_event (int index, event & ev) const
+{
+    const item & it = m_items[index];
+    ev.set_timestamp(it.pe_timestamp);
+    ev.set_status(it.pe_status, it.pe_channel);
+    ev.set_data(it.pe_data[0], it.pe_data[1]);
+}
+
+}           // namespace seq64
+
+/*
+ * playback_events.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
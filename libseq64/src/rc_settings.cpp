@@ -100,6 +100,13 @@ rc_settings::rc_settings ()
     m_show_midi                 (false),
     m_priority                  (false),
     m_stats                     (false),
+    m_output_scheduler          (e_scheduler_poll),
+    m_absolute_timing           (false),
+    m_lookahead_ms              (0),
+    m_input_queue_size          (SEQ64_INPUT_QUEUE_SIZE),
+    m_render_threads            (1),
+    m_timing_histograms         (false),
+    m_null_midi_ports           (0),
     m_pass_sysex                (false),
     m_with_jack_transport       (false),
     m_with_jack_master          (false),
@@ -118,6 +125,10 @@ rc_settings::rc_settings ()
     m_mute_group_saving         (e_mute_group_preserve),
     m_filename                  (),
     m_jack_session_uuid         (),
+    m_render_filename           (),
+    m_null_capture_filename     (),
+    m_null_inject_filename      (),
+    m_thru_routes               (),
     m_last_used_dir             (),
     m_config_directory          (),
     m_config_filename           (),
@@ -155,6 +166,13 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_show_midi                 (rhs.m_show_midi),
     m_priority                  (rhs.m_priority),
     m_stats                     (rhs.m_stats),
+    m_output_scheduler          (rhs.m_output_scheduler),
+    m_absolute_timing           (rhs.m_absolute_timing),
+    m_lookahead_ms              (rhs.m_lookahead_ms),
+    m_input_queue_size          (rhs.m_input_queue_size),
+    m_render_threads            (rhs.m_render_threads),
+    m_timing_histograms         (rhs.m_timing_histograms),
+    m_null_midi_ports           (rhs.m_null_midi_ports),
     m_pass_sysex                (rhs.m_pass_sysex),
     m_with_jack_transport       (rhs.m_with_jack_transport),
     m_with_jack_master          (rhs.m_with_jack_master),
@@ -169,6 +187,10 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_mute_group_saving         (rhs.m_mute_group_saving),
     m_filename                  (rhs.m_filename),
     m_jack_session_uuid         (rhs.m_jack_session_uuid),
+    m_render_filename           (rhs.m_render_filename),
+    m_null_capture_filename     (rhs.m_null_capture_filename),
+    m_null_inject_filename      (rhs.m_null_inject_filename),
+    m_thru_routes               (rhs.m_thru_routes),
     m_last_used_dir             (rhs.m_last_used_dir),
     m_config_directory          (rhs.m_config_directory),
     m_config_filename           (rhs.m_config_filename),
@@ -212,6 +234,13 @@ rc_settings::operator = (const rc_settings & rhs)
         m_show_midi                 = rhs.m_show_midi;
         m_priority                  = rhs.m_priority;
         m_stats                     = rhs.m_stats;
+        m_output_scheduler          = rhs.m_output_scheduler;
+        m_absolute_timing           = rhs.m_absolute_timing;
+        m_lookahead_ms              = rhs.m_lookahead_ms;
+        m_input_queue_size          = rhs.m_input_queue_size;
+        m_render_threads            = rhs.m_render_threads;
+        m_timing_histograms         = rhs.m_timing_histograms;
+        m_null_midi_ports           = rhs.m_null_midi_ports;
         m_pass_sysex                = rhs.m_pass_sysex;
         m_with_jack_transport       = rhs.m_with_jack_transport;
         m_with_jack_master          = rhs.m_with_jack_master;
@@ -225,6 +254,10 @@ rc_settings::operator = (const rc_settings & rhs)
         m_mute_group_saving         = rhs.m_mute_group_saving;
         m_filename                  = rhs.m_filename;
         m_jack_session_uuid         = rhs.m_jack_session_uuid;
+        m_render_filename           = rhs.m_render_filename;
+        m_null_capture_filename     = rhs.m_null_capture_filename;
+        m_null_inject_filename      = rhs.m_null_inject_filename;
+        m_thru_routes               = rhs.m_thru_routes;
         m_last_used_dir             = rhs.m_last_used_dir;
         m_config_directory          = rhs.m_config_directory;
         m_config_filename           = rhs.m_config_filename;
@@ -267,6 +300,13 @@ rc_settings::set_defaults ()
     m_show_midi                 = false;
     m_priority                  = false;
     m_stats                     = false;
+    m_output_scheduler          = e_scheduler_poll;
+    m_absolute_timing           = false;
+    m_lookahead_ms              = 0;
+    m_input_queue_size          = SEQ64_INPUT_QUEUE_SIZE;
+    m_render_threads            = 1;
+    m_timing_histograms         = false;
+    m_null_midi_ports           = 0;
     m_pass_sysex                = false;
 #ifdef SEQ64_RTMIDI_SUPPORT
     m_with_jack_midi            = true;
@@ -284,6 +324,10 @@ rc_settings::set_defaults ()
     m_device_ignore_num         = e_seq24_interaction;
     m_filename.clear();
     m_jack_session_uuid.clear();
+    m_render_filename.clear();
+    m_null_capture_filename.clear();
+    m_null_inject_filename.clear();
+    m_thru_routes.clear();
 #if defined PLATFORM_WINDOWS            /* but see home_config_directory()  */
     m_last_used_dir             = "";
     m_config_directory          = "sequencer64";
@@ -0,0 +1,132 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          record_buffer.cpp
+ *
+ *  This module declares/defines the buffer that holds the events recorded
+ *  into a pattern until they are merged into it.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  See the record_buffer.hpp module and sequence::flush_recording().
+ */
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "record_buffer.hpp"            /* seq64::record_buffer             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Constructor.  Allocates the slots.
+ *
+ * \param size
+ *      The number of slots.  Must be a power of 2.
+ */
+
+record_buffer::record_buffer (unsigned size)
+ :
+    m_size      (size),
+    m_events    (new event[size]),
+    m_front     (0),
+    m_back      (0)
+{
+    // Empty body
+}
+
+/**
+ *  Destructor.  Frees the slots, and any events left in them.
+ */
+
+record_buffer::~record_buffer ()
+{
+    delete [] m_events;
+}
+
+/**
+ *  Adds a recorded event.  Called only by the producer; never blocks.
+ *
+ * \param ev
+ *      The event to add, copied into the buffer.
+ *
+ * \return
+ *      Returns false if the buffer is full, in which case the caller must
+ *      flush the recording and try again.
+ */
+
+bool
+record_buffer::push (const event & ev)
+{
+    unsigned back = m_back.load(std::memory_order_relaxed);
+    if (back - m_front.load(std::memory_order_acquire) == m_size)
+        return false;
+
+    m_events[back & (m_size - 1)] = ev;
+    m_back.store(back + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ *  Takes the oldest recorded event.  Called only by the consumer.
+ *
+ * \param [out] ev
+ *      Set to the event, if there is one.
+ *
+ * \return
+ *      Returns false if the buffer is empty.
+ */
+
+bool
+record_buffer::pop (event & ev)
+{
+    unsigned front = m_front.load(std::memory_order_relaxed);
+    if (front == m_back.load(std::memory_order_acquire))
+        return false;
+
+    ev = m_events[front & (m_size - 1)];
+    m_front.store(front + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ *  Discards the recorded events.  Called only by the consumer.
+ */
+
+void
+record_buffer::clear ()
+{
+    unsigned back = m_back.load(std::memory_order_acquire);
+    m_front.store(back, std::memory_order_release);
+}
+
+}           // namespace seq64
+
+/*
+ * record_buffer.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
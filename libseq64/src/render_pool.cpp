@@ -0,0 +1,381 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          render_pool.cpp
+ *
+ *  This module declares/defines a pool of worker threads that render the
+ *  patterns of a playback pass in parallel.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-19
+ * \updates       2018-11-19
+ * \license       GNU GPLv2 or above
+ *
+ *  See the render_pool.hpp module and perform::play().
+ */
+
+#include <algorithm>                    /* std::sort()                      */
+#include <sched.h>                      /* sched_yield()                    */
+
+#include "app_limits.h"                 /* SEQ64_RENDER_BUFFER_SIZE         */
+#include "easy_macros.h"                /* errprint()                       */
+#include "render_pool.hpp"              /* seq64::render_pool               */
+#include "rt_audit.hpp"                 /* SEQ64_RT_SCOPE()                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Orders two render items for merge():  by delay, then buss, then the
+ *  position of the pattern in the pass, then the order of play.  No two
+ *  items compare equal, so the order is fully determined.
+ */
+
+static bool
+render_item_less (const render_item & a, const render_item & b)
+{
+    if (a.ri_event.oq_delay_us != b.ri_event.oq_delay_us)
+        return a.ri_event.oq_delay_us < b.ri_event.oq_delay_us;
+
+    if (a.ri_bus != b.ri_bus)
+        return a.ri_bus < b.ri_bus;
+
+    if (a.ri_order != b.ri_order)
+        return a.ri_order < b.ri_order;
+
+    return a.ri_index < b.ri_index;
+}
+
+/**
+ *  Default constructor.  Reserves the storage of the buffer, so that a
+ *  normal pass does not allocate.
+ */
+
+render_buffer::render_buffer ()
+ :
+    m_items     (),
+    m_order     (0),
+    m_owner     (pthread_self())
+{
+    m_items.reserve(SEQ64_RENDER_BUFFER_SIZE);
+}
+
+/**
+ *  Starts the rendering of a pattern into this buffer, by the calling
+ *  thread.
+ *
+ * \param order
+ *      The position of the pattern in the pass.
+ */
+
+void
+render_buffer::start (int order)
+{
+    m_order = order;
+    m_owner = pthread_self();
+}
+
+/**
+ *  Indicates if the calling thread is the one rendering into this buffer.
+ */
+
+bool
+render_buffer::is_owner () const
+{
+    return pthread_equal(m_owner, pthread_self()) != 0;
+}
+
+/**
+ *  Records an event, in place of midibase::play().
+ *
+ * \param bus
+ *      The output buss of the event.
+ *
+ * \param ev
+ *      The event.  Only its status, channel, and data bytes are kept.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param delay_us
+ *      The delay of the playback.
+ */
+
+void
+render_buffer::add
+(
+    bussbyte bus, const event & ev, midibyte channel, long delay_us
+)
+{
+    render_item ri;
+    midi_out_queue::to_item(ev, channel, delay_us, ri.ri_event);
+    ri.ri_tempo = 0.0;
+    ri.ri_order = m_order;
+    ri.ri_index = int(m_items.size());
+    ri.ri_bus = bus;
+    m_items.push_back(ri);
+}
+
+/**
+ *  Records a Set Tempo event, to be applied once the pass is merged.
+ *
+ * \param bpm
+ *      The new tempo.
+ */
+
+void
+render_buffer::add_tempo (midibpm bpm)
+{
+    render_item ri;
+    ri.ri_event.oq_delay_us = 0;
+    ri.ri_event.oq_status = 0;
+    ri.ri_event.oq_channel = 0;
+    ri.ri_event.oq_data[0] = ri.ri_event.oq_data[1] = 0;
+    ri.ri_event.oq_play_channel = 0;
+    ri.ri_tempo = bpm;
+    ri.ri_order = m_order;
+    ri.ri_index = int(m_items.size());
+    ri.ri_bus = 0;
+    m_items.push_back(ri);
+}
+
+/**
+ *  Principal constructor.  Creates the buffers and the worker threads.
+ *  It is meant to be called by the output thread, so that the workers
+ *  inherit its scheduling priority.  If a worker cannot be created, the
+ *  pool does with fewer.
+ *
+ * \param renderers
+ *      The number of renderers, including the thread that calls run().
+ */
+
+render_pool::render_pool (int renderers)
+ :
+    m_renderers     (renderers > 1 ? renderers : 1),
+    m_threads       (),
+    m_workers       (size_t(m_renderers)),
+    m_buffers       (size_t(m_renderers)),
+    m_merged        (),
+    m_condition     (),
+    m_quit          (false),
+    m_claim         (0),
+    m_count         (0),
+    m_completed     (0),
+    m_pass          (0),
+    m_func          (nullptr),
+    m_context       (nullptr)
+{
+    m_merged.reserve(size_t(m_renderers) * SEQ64_RENDER_BUFFER_SIZE);
+    for (int w = 1; w < m_renderers; ++w)
+    {
+        m_workers[w].w_pool = this;
+        m_workers[w].w_index = w;
+
+        pthread_t t;
+        int err = pthread_create(&t, NULL, worker_func, &m_workers[w]);
+        if (err == 0)
+            m_threads.push_back(t);
+        else
+        {
+            errprint("render_pool: could not create a worker thread");
+        }
+    }
+}
+
+/**
+ *  Destructor.  Stops and joins the worker threads.  Must not be called
+ *  during run().
+ */
+
+render_pool::~render_pool ()
+{
+    m_condition.lock();
+    m_quit = true;
+    m_condition.broadcast();
+    m_condition.unlock();
+    for
+    (
+        std::vector<pthread_t>::iterator t = m_threads.begin();
+        t != m_threads.end(); ++t
+    )
+    {
+        pthread_join(*t, NULL);
+    }
+}
+
+/**
+ *  The function of a worker thread.
+ *
+ * \param arg
+ *      The worker structure of the thread.
+ */
+
+void *
+render_pool::worker_func (void * arg)
+{
+    worker * w = static_cast<worker *>(arg);
+    w->w_pool->work(w->w_index);
+    return nullptr;
+}
+
+/**
+ *  The loop of a worker thread.  Sleeps until a new pass is published, then
+ *  renders the patterns it can claim.
+ *
+ * \param worker
+ *      The renderer index of the thread.
+ */
+
+void
+render_pool::work (int worker)
+{
+    unsigned seen = 0;
+    for (;;)
+    {
+        m_condition.lock();
+        while (! m_quit && unsigned(m_claim.load() >> 32) == seen)
+            m_condition.wait();
+
+        m_condition.unlock();
+        if (m_quit)
+            break;
+
+        seen = unsigned(m_claim.load() >> 32);
+
+        SEQ64_RT_SCOPE();               /* renders for the output thread    */
+        render_claimed(seen, worker);
+    }
+}
+
+/**
+ *  Claims and renders patterns of the given pass, until there are none
+ *  left, or the pass is over.
+ *
+ * \param pass
+ *      The number of the pass.
+ *
+ * \param worker
+ *      The renderer index of the calling thread.
+ */
+
+void
+render_pool::render_claimed (unsigned pass, int worker)
+{
+    for (;;)
+    {
+        unsigned long long c = m_claim.load(std::memory_order_acquire);
+        if (unsigned(c >> 32) != pass)
+            break;
+
+        int index = int(c & 0xFFFFFFFFULL);
+        if (index >= m_count.load(std::memory_order_relaxed))
+            break;
+
+        if (m_claim.compare_exchange_weak(c, c + 1))
+        {
+            m_func(m_context, index, worker);
+            m_completed.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+/**
+ *  Renders a pass:  calls the function once for each index from 0 to
+ *  count - 1, on the workers and on the calling thread, and returns once
+ *  all of the calls are done.  The render buffers are emptied first.
+ *
+ * \param f
+ *      The function that renders one pattern.
+ *
+ * \param context
+ *      The first argument of the function.
+ *
+ * \param count
+ *      The number of patterns in the pass.
+ */
+
+void
+render_pool::run (render_func f, void * context, int count)
+{
+    for
+    (
+        std::vector<render_buffer>::iterator b = m_buffers.begin();
+        b != m_buffers.end(); ++b
+    )
+    {
+        b->clear();
+    }
+    if (count <= 0)
+        return;
+
+    m_func = f;
+    m_context = context;
+    m_count.store(count, std::memory_order_relaxed);
+    m_completed.store(0, std::memory_order_relaxed);
+    ++m_pass;
+
+    m_condition.lock();
+    m_claim.store
+    (
+        (unsigned long long)(m_pass) << 32, std::memory_order_release
+    );
+    m_condition.broadcast();
+    m_condition.unlock();
+
+    render_claimed(m_pass, 0);
+    while (m_completed.load(std::memory_order_acquire) < count)
+        sched_yield();                      /* the last patterns are busy   */
+}
+
+/**
+ *  Merges the render buffers of the last pass into one list, in a fixed
+ *  order.  See render_item_less().
+ *
+ * \return
+ *      Returns the merged list, valid until the next call to run().
+ */
+
+const std::vector<render_item> &
+render_pool::merge ()
+{
+    m_merged.clear();
+    for
+    (
+        std::vector<render_buffer>::const_iterator b = m_buffers.begin();
+        b != m_buffers.end(); ++b
+    )
+    {
+        m_merged.insert(m_merged.end(), b->items().begin(), b->items().end());
+    }
+    std::sort(m_merged.begin(), m_merged.end(), render_item_less);
+    return m_merged;
+}
+
+}           // namespace seq64
+
+/*
+ * render_pool.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
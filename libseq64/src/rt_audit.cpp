@@ -0,0 +1,591 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          rt_audit.cpp
+ *
+ *  This module declares/defines a debug mode that detects calls that are not
+ *  realtime-safe in the realtime threads.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-21
+ * \updates       2018-11-21
+ * \license       GNU GPLv2 or above
+ *
+ *  See the rt_audit.hpp module.  The interception replaces the allocation
+ *  and stdio functions of the C library for the whole program, so this
+ *  module must only be built into a debug build.  The replacements check a
+ *  thread-local depth, and otherwise pass straight through to glibc:
+ *  __libc_malloc() and friends for the allocator, and the next definition,
+ *  found with dlsym(RTLD_NEXT), for stdio.
+ *
+ *  The recording itself must not recurse into the audit.  A thread-local
+ *  flag turns the checks off while a violation is recorded, and the records
+ *  live in a fixed table of atomics, so that recording does not allocate.
+ *  backtrace() loads libgcc the first time it is called, which allocates, so
+ *  it is called once at static initialization.
+ */
+
+#ifdef _FORTIFY_SOURCE                  /* we define printf() and friends   */
+#undef _FORTIFY_SOURCE
+#endif
+
+#include "easy_macros.h"                /* is_nullptr()                     */
+#include "rt_audit.hpp"                 /* seq64::rt_audit_enter(), etc.    */
+
+#ifdef SEQ64_RT_AUDIT
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <execinfo.h>                   /* backtrace(), etc.                */
+#include <stdarg.h>                     /* va_list                          */
+#include <stdio.h>                      /* snprintf(), FILE                 */
+#include <stdlib.h>                     /* malloc(), free()                 */
+#include <unistd.h>                     /* write()                          */
+
+#ifdef __GLIBC__
+#include <dlfcn.h>                      /* dlsym(), RTLD_NEXT               */
+#endif
+
+#endif  // SEQ64_RT_AUDIT
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+#ifdef SEQ64_RT_AUDIT
+
+/**
+ *  The size of the record table, and the deepest backtrace kept.
+ */
+
+static const int c_records_max = 128;
+static const int c_frames_max = 24;
+
+/**
+ *  Provides a violation recorded at one call stack.  The hash is zero while
+ *  the record is unused; a thread claims a record by setting it.
+ */
+
+struct rt_record
+{
+    std::atomic<unsigned long> rr_hash;     /**< The hash of the stack.     */
+    std::atomic<unsigned long> rr_count;    /**< The calls at this stack.   */
+    std::atomic<bool> rr_ready;             /**< Set once filled in.        */
+    rt_violation rr_kind;                   /**< The kind of violation.     */
+    int rr_depth;                           /**< The number of frames.      */
+    void * rr_frames[c_frames_max];         /**< The backtrace.             */
+};
+
+/*
+ *  The state of the audit.  These have static storage, and so are zeroed
+ *  before any allocation can reach the audit.
+ */
+
+static rt_record s_records[c_records_max];
+static std::atomic<unsigned long> s_counts[RT_VIOLATION_MAX];
+static std::atomic<unsigned long> s_dropped;
+static bool s_backtrace_ready = false;
+
+/**
+ *  The depth of the realtime scopes of the calling thread, and a flag that
+ *  turns off the checks while the audit itself is at work.
+ */
+
+static thread_local int s_rt_depth = 0;
+static thread_local int s_rt_busy = 0;
+
+/**
+ *  The names of the kinds of violations, for the report.
+ */
+
+static const char * const s_kind_names[RT_VIOLATION_MAX] =
+{
+    "malloc", "free", "mutex", "stdio"
+};
+
+/**
+ *  Hashes a call stack and its kind, never returning 0.
+ */
+
+static unsigned long
+stack_hash (rt_violation kind, void * const * frames, int depth)
+{
+    unsigned long h = 14695981039346656037UL;       /* FNV-1a               */
+    h = (h ^ (unsigned long)(kind + 1)) * 1099511628211UL;
+    for (int f = 0; f < depth; ++f)
+        h = (h ^ (unsigned long)(frames[f])) * 1099511628211UL;
+
+    return h != 0 ? h : 1 ;
+}
+
+/**
+ *  Writes a string to a file descriptor, for the report, which does not use
+ *  stdio.
+ */
+
+static void
+write_string (int fd, const char * s, int length)
+{
+    while (length > 0)
+    {
+        ssize_t n = write(fd, s, size_t(length));
+        if (n <= 0)
+            break;
+
+        s += n;
+        length -= int(n);
+    }
+}
+
+/**
+ *  Primes the audit before main():  loads the unwinder used by
+ *  backtrace(), and writes the report at exit.
+ */
+
+class rt_audit_init
+{
+
+public:
+
+    rt_audit_init ()
+    {
+        void * frames[4];
+        ++s_rt_busy;
+        (void) backtrace(frames, 4);
+        --s_rt_busy;
+        s_backtrace_ready = true;
+    }
+
+    ~rt_audit_init ()
+    {
+        rt_audit_report(STDERR_FILENO);
+    }
+
+};
+
+static rt_audit_init s_rt_audit_init;
+
+#endif  // SEQ64_RT_AUDIT
+
+/**
+ *  Marks the calling thread as being in a realtime context.  Calls nest,
+ *  and must be balanced by rt_audit_leave().
+ */
+
+void
+rt_audit_enter ()
+{
+#ifdef SEQ64_RT_AUDIT
+    ++s_rt_depth;
+#endif
+}
+
+/**
+ *  Leaves a realtime context entered with rt_audit_enter().
+ */
+
+void
+rt_audit_leave ()
+{
+#ifdef SEQ64_RT_AUDIT
+    if (s_rt_depth > 0)
+        --s_rt_depth;
+#endif
+}
+
+/**
+ * \return
+ *      Returns true if the calling thread is in a realtime context, and not
+ *      busy recording a violation.  Always false in a normal build.
+ */
+
+bool
+rt_audit_active ()
+{
+#ifdef SEQ64_RT_AUDIT
+    return s_rt_depth > 0 && s_rt_busy == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ *  Records a violation:  counts it by kind, and counts it in the record of
+ *  its call stack, creating the record the first time the stack is seen.
+ *  If the table is full, the violation is only counted by kind.  Lock-free,
+ *  and allocation-free once backtrace() is primed.
+ *
+ * \param kind
+ *      The kind of the violation.
+ */
+
+void
+rt_audit_violation (rt_violation kind)
+{
+#ifdef SEQ64_RT_AUDIT
+    if (s_rt_busy > 0 || kind < 0 || kind >= RT_VIOLATION_MAX)
+        return;
+
+    ++s_rt_busy;
+    s_counts[kind].fetch_add(1, std::memory_order_relaxed);
+
+    void * frames[c_frames_max];
+    int depth = s_backtrace_ready ? backtrace(frames, c_frames_max) : 0 ;
+    unsigned long hash = stack_hash(kind, frames, depth);
+    bool recorded = false;
+    for (int probe = 0; probe < c_records_max && ! recorded; ++probe)
+    {
+        rt_record & r = s_records[(hash + probe) % c_records_max];
+        unsigned long h = r.rr_hash.load(std::memory_order_acquire);
+        if (h == 0)
+        {
+            if (r.rr_hash.compare_exchange_strong(h, hash))
+            {
+                r.rr_kind = kind;
+                r.rr_depth = depth;
+                for (int f = 0; f < depth; ++f)
+                    r.rr_frames[f] = frames[f];
+
+                r.rr_ready.store(true, std::memory_order_release);
+                h = hash;
+            }
+        }
+        if (h == hash)
+        {
+            r.rr_count.fetch_add(1, std::memory_order_relaxed);
+            recorded = true;
+        }
+    }
+    if (! recorded)
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+
+    --s_rt_busy;
+#else
+    (void) kind;
+#endif
+}
+
+/**
+ * \param kind
+ *      The kind of violation.
+ *
+ * \return
+ *      Returns the number of violations of that kind.
+ */
+
+unsigned long
+rt_audit_count (rt_violation kind)
+{
+#ifdef SEQ64_RT_AUDIT
+    if (kind >= 0 && kind < RT_VIOLATION_MAX)
+        return s_counts[kind].load(std::memory_order_relaxed);
+#else
+    (void) kind;
+#endif
+    return 0;
+}
+
+/**
+ * \return
+ *      Returns the number of violations of all kinds.
+ */
+
+unsigned long
+rt_audit_total ()
+{
+    unsigned long result = 0;
+    for (int k = 0; k < RT_VIOLATION_MAX; ++k)
+        result += rt_audit_count(rt_violation(k));
+
+    return result;
+}
+
+/**
+ *  Zeroes the counts, for example after start-up, so that only the
+ *  violations of the playback are reported.  The records themselves are
+ *  kept, but their counts are zeroed, and they are not reported again until
+ *  seen again.
+ */
+
+void
+rt_audit_reset ()
+{
+#ifdef SEQ64_RT_AUDIT
+    for (int k = 0; k < RT_VIOLATION_MAX; ++k)
+        s_counts[k].store(0, std::memory_order_relaxed);
+
+    for (int r = 0; r < c_records_max; ++r)
+        s_records[r].rr_count.store(0, std::memory_order_relaxed);
+
+    s_dropped.store(0, std::memory_order_relaxed);
+#endif
+}
+
+/**
+ *  Writes the counts by kind, then each recorded call stack with its count
+ *  and backtrace.  Does not use stdio, so that it can be called from a
+ *  signal handler or at exit.  Writes nothing in a normal build.
+ *
+ * \param fd
+ *      The file descriptor, such as STDERR_FILENO.
+ */
+
+void
+rt_audit_report (int fd)
+{
+#ifdef SEQ64_RT_AUDIT
+    char tmp[160];
+    ++s_rt_busy;
+    int n = snprintf
+    (
+        tmp, sizeof tmp,
+        "RT audit: malloc %lu, free %lu, mutex %lu, stdio %lu (%lu unrecorded)\n",
+        rt_audit_count(RT_VIOLATION_MALLOC), rt_audit_count(RT_VIOLATION_FREE),
+        rt_audit_count(RT_VIOLATION_MUTEX), rt_audit_count(RT_VIOLATION_STDIO),
+        s_dropped.load(std::memory_order_relaxed)
+    );
+    write_string(fd, tmp, n);
+    for (int r = 0; r < c_records_max; ++r)
+    {
+        const rt_record & rec = s_records[r];
+        unsigned long count = rec.rr_count.load(std::memory_order_relaxed);
+        if (count > 0 && rec.rr_ready.load(std::memory_order_acquire))
+        {
+            n = snprintf
+            (
+                tmp, sizeof tmp, "RT audit: %s x %lu at:\n",
+                s_kind_names[rec.rr_kind], count
+            );
+            write_string(fd, tmp, n);
+            backtrace_symbols_fd(rec.rr_frames, rec.rr_depth, fd);
+        }
+    }
+    --s_rt_busy;
+#else
+    (void) fd;
+#endif
+}
+
+}           // namespace seq64
+
+/*
+ *  The replacements of the C library functions.  Each one checks the audit,
+ *  then calls the glibc function.
+ */
+
+#if defined SEQ64_RT_AUDIT && defined __GLIBC__
+
+/**
+ *  Checks one call against the audit.
+ */
+
+#define SEQ64_RT_INTERCEPT(kind)                                            \
+    do { if (seq64::rt_audit_active()) seq64::rt_audit_violation(kind); }   \
+    while (0)
+
+/**
+ *  Defines next_name(), which finds the next definition of a stdio
+ *  function the first time it is needed.  dlsym() may allocate, which goes
+ *  to glibc as usual.
+ */
+
+#define SEQ64_RT_NEXT(name)                                                 \
+    static name##_t s_next_##name = nullptr;                                \
+    static inline name##_t next_##name ()                                   \
+    {                                                                       \
+        if (is_nullptr(s_next_##name))                                      \
+            s_next_##name = (name##_t) dlsym(RTLD_NEXT, #name);             \
+                                                                            \
+        return s_next_##name;                                               \
+    }
+
+extern "C"
+{
+
+extern void * __libc_malloc (size_t size);
+extern void * __libc_calloc (size_t count, size_t size);
+extern void * __libc_realloc (void * ptr, size_t size);
+extern void __libc_free (void * ptr);
+extern int __vfprintf_chk (FILE * f, int flag, const char * fmt, va_list ap);
+
+typedef int (* vfprintf_t) (FILE *, const char *, va_list);
+typedef int (* __vfprintf_chk_t) (FILE *, int, const char *, va_list);
+typedef int (* fputs_t) (const char *, FILE *);
+typedef int (* puts_t) (const char *);
+typedef int (* fputc_t) (int, FILE *);
+typedef int (* putchar_t) (int);
+typedef size_t (* fwrite_t) (const void *, size_t, size_t, FILE *);
+typedef int (* fflush_t) (FILE *);
+
+SEQ64_RT_NEXT(vfprintf)
+SEQ64_RT_NEXT(__vfprintf_chk)
+SEQ64_RT_NEXT(fputs)
+SEQ64_RT_NEXT(puts)
+SEQ64_RT_NEXT(fputc)
+SEQ64_RT_NEXT(putchar)
+SEQ64_RT_NEXT(fwrite)
+SEQ64_RT_NEXT(fflush)
+
+void *
+malloc (size_t size) __THROW
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_MALLOC);
+    return __libc_malloc(size);
+}
+
+void *
+calloc (size_t count, size_t size) __THROW
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_MALLOC);
+    return __libc_calloc(count, size);
+}
+
+void *
+realloc (void * ptr, size_t size) __THROW
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_MALLOC);
+    return __libc_realloc(ptr, size);
+}
+
+void
+free (void * ptr) __THROW
+{
+    if (ptr != nullptr)
+        SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_FREE);
+
+    __libc_free(ptr);
+}
+
+int
+vfprintf (FILE * f, const char * fmt, va_list ap)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_vfprintf()(f, fmt, ap);
+}
+
+int
+vprintf (const char * fmt, va_list ap)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_vfprintf()(stdout, fmt, ap);
+}
+
+int
+fprintf (FILE * f, const char * fmt, ...)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    va_list ap;
+    va_start(ap, fmt);
+    int result = next_vfprintf()(f, fmt, ap);
+    va_end(ap);
+    return result;
+}
+
+int
+printf (const char * fmt, ...)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    va_list ap;
+    va_start(ap, fmt);
+    int result = next_vfprintf()(stdout, fmt, ap);
+    va_end(ap);
+    return result;
+}
+
+/*
+ *  The fortified variants, which the other modules call in place of
+ *  printf() and fprintf() when built with _FORTIFY_SOURCE.
+ */
+
+int
+__fprintf_chk (FILE * f, int flag, const char * fmt, ...)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    va_list ap;
+    va_start(ap, fmt);
+    int result = next___vfprintf_chk()(f, flag, fmt, ap);
+    va_end(ap);
+    return result;
+}
+
+int
+__printf_chk (int flag, const char * fmt, ...)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    va_list ap;
+    va_start(ap, fmt);
+    int result = next___vfprintf_chk()(stdout, flag, fmt, ap);
+    va_end(ap);
+    return result;
+}
+
+int
+fputs (const char * s, FILE * f)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_fputs()(s, f);
+}
+
+int
+puts (const char * s)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_puts()(s);
+}
+
+int
+fputc (int c, FILE * f)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_fputc()(c, f);
+}
+
+int
+putchar (int c)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_putchar()(c);
+}
+
+size_t
+fwrite (const void * p, size_t size, size_t count, FILE * f)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_fwrite()(p, size, count, f);
+}
+
+int
+fflush (FILE * f)
+{
+    SEQ64_RT_INTERCEPT(seq64::RT_VIOLATION_STDIO);
+    return next_fflush()(f);
+}
+
+}           // extern "C"
+
+#endif  // SEQ64_RT_AUDIT && __GLIBC__
+
+/*
+ * rt_audit.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -53,6 +53,7 @@
 #include "calculations.hpp"
 #include "mastermidibus.hpp"
 #include "perform.hpp"
+#include "render_pool.hpp"              /* seq64::render_buffer             */
 #include "scales.h"
 #include "sequence.hpp"
 #include "settings.hpp"                 /* seq64::rc()                      */
@@ -110,6 +111,18 @@ sequence::sequence (int ppqn)
     m_events_undo               (),
     m_events_redo               (),
     m_iterator_draw             (m_events.begin()),
+    m_draw_index                (0),
+    m_draw_generation           (m_events.generation()),
+    m_playback                  (new playback_events()),
+    m_playback_readers          (0),
+    m_playback_retired          (),
+    m_edit_depth                (0),
+    m_render_buffer             (nullptr),
+    m_play_cursor_index         (0),
+    m_play_cursor_base          (0),
+    m_play_cursor_tick          (SEQ64_NULL_MIDIPULSE),
+    m_play_cursor_length        (0),
+    m_play_cursor_generation    (0),
     m_channel_match             (false),        // stazed
     m_midi_channel              (0),
     m_bus                       (0),
@@ -123,6 +136,8 @@ sequence::sequence (int ppqn)
     m_recording                 (false),
     m_expanded_recording        (false),
     m_quantized_rec             (false),
+    m_record_buffer             (),
+    m_record_batch              (),
     m_thru                      (false),
     m_queued                    (false),
 #ifdef SEQ64_SONG_RECORDING
@@ -150,6 +165,7 @@ sequence::sequence (int ppqn)
     m_name                      (),
     m_last_tick                 (0),
     m_queued_tick               (0),            /* used by perform::play()  */
+    m_parked                    (false),
     m_trigger_offset            (0),            /* for record-keeping       */
     m_maxbeats                  (c_maxbeats),
     m_ppqn                      (choose_ppqn(ppqn)),
@@ -174,6 +190,7 @@ sequence::sequence (int ppqn)
 {
     m_triggers.set_ppqn(int(m_ppqn));
     m_triggers.set_length(m_length);
+    publish_playback();                         /* snapshot with the length */
     for (int i = 0; i < c_midi_notes; ++i)      /* no notes are playing now */
         m_playing_notes[i] = 0;
 }
@@ -184,7 +201,8 @@ sequence::sequence (int ppqn)
 
 sequence::~sequence ()
 {
-    // Empty body
+    delete m_playback.exchange(nullptr);
+    delete_retired_playback();
 }
 
 /**
@@ -222,7 +240,7 @@ sequence::partial_assign (const sequence & rhs)
 {
     if (this != &rhs)
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         m_parent        = rhs.m_parent;             /* a pointer, careful!  */
         m_events        = rhs.m_events;
         m_triggers      = rhs.m_triggers;
@@ -334,7 +352,7 @@ sequence::push_undo (bool hold)
 void
 sequence::pop_undo ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (! m_events_undo.empty())                // stazed: m_list_undo
     {
         m_events_redo.push(m_events);           // move to triggers module?
@@ -359,7 +377,7 @@ sequence::pop_undo ()
 void
 sequence::pop_redo ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (! m_events_redo.empty())                // move to triggers module?
     {
         m_events_undo.push(m_events);
@@ -678,7 +696,7 @@ sequence::select_note_events
 )
 {
     int result = 0;
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -1115,11 +1133,12 @@ sequence::toggle_queued ()
 {
     automutex locker(m_mutex);
     m_queued = ! m_queued;
-    m_queued_tick = m_last_tick - mod_last_tick() + m_length;
+    m_queued_tick = last_tick() - mod_last_tick() + m_length;
 #ifdef SEQ64_SONG_RECORDING
     m_off_from_snap = true;
 #endif
     set_dirty_mp();
+    wake_playback();
 }
 
 /**
@@ -1142,6 +1161,31 @@ sequence::toggle_queued ()
  *  function.  Its return value and side-effects tell if there's a change in
  *  playing based on triggers, and provides the ticks that bracket it.
  *
+ *  The event list used to be walked from its beginning on every call, so
+ *  that the cost of each frame grew with the length of the pattern.  Now the
+ *  position at which the previous frame stopped is kept in a playback
+ *  cursor (m_play_cursor_index and m_play_cursor_base), and the walk resumes
+ *  from there when the new frame starts exactly where the last one ended.
+ *  Any change in length, loop reset, repositioning, or newly-published
+ *  snapshot invalidates the cursor, which is then re-seeked with a binary
+ *  search.
+ *
+ *  The events are not read from m_events, but from the playback snapshot
+ *  published by the editing side (see publish_playback()), so that the
+ *  output thread never waits for an edit to finish.  The sequence mutex is
+ *  only tried, to process mute and triggers.  If an edit holds it, the
+ *  trigger processing is skipped for this frame; the trigger state catches
+ *  up on the next frame, since triggers::play() works from the tick span.
+ *  The length used is the one published with the snapshot, so that it
+ *  always matches the events; the trigger offset, which only this thread
+ *  sets, is wrapped to it.  Without the mutex, m_last_tick is advanced only
+ *  if set_last_tick() has not changed it in the meantime.
+ *
+ *  The events of the frame are not flushed one by one.  They accumulate in
+ *  the output buffer of each buss, in the order played, and perform::play()
+ *  flushes the master buss once, after all of the patterns have been played.
+ *  This function is called only from there, by play_queue().
+ *
  * \param tick
  *      Provides the current end-tick value.  The tick comes in as a global
  *      tick.
@@ -1169,11 +1213,18 @@ sequence::play
 #endif
 )
 {
-    automutex locker(m_mutex);
+    bool locked = m_mutex.try_lock();       /* never wait for an edit       */
     bool trigger_turning_off = false;       /* turn off after in-frame play */
     midipulse start_tick = m_last_tick;     /* modified in triggers::play() */
     midipulse end_tick = tick;
-    if (m_song_mute)
+    if (! locked)
+    {
+        /*
+         *  An edit is in progress; the mute and trigger state is left as it
+         *  is until the next frame.
+         */
+    }
+    else if (m_song_mute)
     {
         set_playing(false);
     }
@@ -1197,54 +1248,164 @@ sequence::play
             trigger_turning_off = m_triggers.play(start_tick, end_tick);
         }
     }
-    if (m_playing)                          /* play notes in frame          */
+    ++m_playback_readers;                   /* pin the current snapshot     */
+
+    const playback_events & pe = *m_playback.load();
+    midipulse len = pe.length();            /* published with the events    */
+    if (m_playing && len > 0)               /* play notes in frame          */
     {
-        midipulse offset = m_length - m_trigger_offset;
+        midipulse offset = len - wrap_trigger_offset(len);
         midipulse start_tick_offset = start_tick + offset;
         midipulse end_tick_offset = end_tick + offset;
-        midipulse times_played = m_last_tick / m_length;
-        midipulse offset_base = times_played * m_length;
         int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
-        event_list::iterator e = m_events.begin();
-        while (e != m_events.end())
+        int count = pe.count();
+        if (! play_cursor_valid(pe, start_tick_offset))
+        {
+            midipulse times_played = m_last_tick / len;
+            m_play_cursor_base = times_played * len;
+            m_play_cursor_index = pe.lower_bound
+            (
+                start_tick_offset - m_play_cursor_base
+            );
+            while (m_play_cursor_index == count && count > 0)
+            {
+                m_play_cursor_base += len;          /* re-seek the cursor   */
+                m_play_cursor_index = pe.lower_bound
+                (
+                    start_tick_offset - m_play_cursor_base
+                );
+            }
+        }
+
+        midipulse offset_base = m_play_cursor_base;
+        int i = m_play_cursor_index;
+        while (i < count)
         {
-            event & er = DREF(e);
-            midipulse stamp = er.get_timestamp() + offset_base;
+            const playback_events::item & it = pe.at(i);
+            midipulse stamp = it.pe_timestamp + offset_base;
             if (stamp >= start_tick_offset && stamp <= end_tick_offset)
             {
-                if (transpose != 0 && er.is_note()) /* includes Aftertouch  */
+                if (it.is_tempo())
                 {
-                    event transposed_event = er;    /* assign ALL members   */
-                    transposed_event.transpose_note(transpose);
-                    put_event_on_bus(transposed_event);
+                    render_buffer * rb = m_render_buffer.load();
+                    if (not_nullptr(rb))
+                        rb->add_tempo(it.pe_tempo);     /* set after merge  */
+                    else if (not_nullptr(m_parent))
+                        m_parent->set_beats_per_minute(it.pe_tempo);
                 }
                 else
                 {
-                    if (er.is_tempo())
-                    {
-                        if (not_nullptr(m_parent))
-                            m_parent->set_beats_per_minute(er.tempo());
-                    }
-                    else if (! er.is_ex_data())
-                        put_event_on_bus(er);       /* frame still going    */
+                    event ev;                       /* allocates nothing    */
+                    pe.to_event(i, ev);
+                    if (transpose != 0 && it.is_note()) /* incl. Aftertouch */
+                        ev.transpose_note(transpose);
+
+                    long delay_us = not_nullptr(m_parent) ?
+                        m_parent->render_delay_us(stamp - offset) : 0 ;
+
+                    put_event_on_bus(ev, delay_us, false);  /* batched  */
                 }
             }
             else if (stamp > end_tick_offset)
                 break;                              /* frame is done        */
 
-            ++e;                                    /* go to next event     */
-            if (e == m_events.end())                /* did we hit the end ? */
+            ++i;                                    /* go to next event     */
+            if (i == count)                         /* did we hit the end ? */
             {
-                e = m_events.begin();               /* yes, start over      */
-                offset_base += m_length;            /* for another go at it */
+                i = 0;                              /* yes, start over      */
+                offset_base += len;                 /* for another go at it */
             }
         }
+        m_play_cursor_index = i;                    /* save the cursor      */
+        m_play_cursor_base = offset_base;
+        m_play_cursor_tick = end_tick_offset + 1;
+        m_play_cursor_length = len;
+        m_play_cursor_generation = pe.generation();
     }
+    else
+        reset_play_cursor();
+
+    --m_playback_readers;                           /* unpin the snapshot   */
     if (trigger_turning_off)                        /* triggers: "turn off" */
         set_playing(false);
 
-    m_last_tick = end_tick + 1;                     /* for next frame       */
+    if (locked)
+        m_last_tick = end_tick + 1;                 /* for next frame       */
+    else                                            /* unless it was reset  */
+        m_last_tick.compare_exchange_strong(start_tick, end_tick + 1);
+
     m_was_playing = m_playing;
+    if (locked)
+        m_mutex.unlock();
+}
+
+/**
+ *  Builds a new playback snapshot from the event list and publishes it to
+ *  the output thread, if the event list or the length has changed since the
+ *  last snapshot.  Called when the outermost editlock is released, so that a
+ *  compound edit (such as a paste followed by a sort) publishes only once.
+ *  The replaced snapshot cannot be deleted until no reader is using it; it
+ *  is kept in the retired list, which is emptied here, or by the next
+ *  publication, once the reader count is zero.
+ *
+ * \threadunsafe
+ *      The caller must hold m_mutex.
+ */
+
+void
+sequence::publish_playback ()
+{
+    playback_events * current = m_playback.load();
+    bool changed = is_nullptr(current) ||
+        current->generation() != m_events.generation() ||
+        current->length() != m_length;
+
+    if (changed)
+    {
+        playback_events * pe = new playback_events
+        (
+            m_events, m_events.generation(), m_length
+        );
+        playback_events * old = m_playback.exchange(pe);
+        if (not_nullptr(old))
+            m_playback_retired.push_back(old);
+
+        if (not_nullptr(m_parent))
+        {
+            bool tempos = pe->tempo_count() > 0 ||
+                (not_nullptr(old) && old->tempo_count() > 0);
+
+            if (tempos)
+                m_parent->rebuild_tempo_map();  /* tempo events changed     */
+
+            m_parent->wake_output();        /* new events might be due      */
+        }
+    }
+    if (m_playback_readers.load() == 0)
+        delete_retired_playback();
+}
+
+/**
+ *  Deletes the replaced playback snapshots.  A reader that starts after the
+ *  exchange in publish_playback() sees only the new snapshot, so once the
+ *  reader count has been seen to be zero, the retired ones are unreachable.
+ *
+ * \threadunsafe
+ *      The caller must hold m_mutex, or be the destructor.
+ */
+
+void
+sequence::delete_retired_playback ()
+{
+    for
+    (
+        std::vector<playback_events *>::iterator i = m_playback_retired.begin();
+        i != m_playback_retired.end(); ++i
+    )
+    {
+        delete *i;
+    }
+    m_playback_retired.clear();
 }
 
 /**
@@ -1257,7 +1418,7 @@ sequence::play
 void
 sequence::verify_and_link ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.verify_and_link(m_length);
 }
 
@@ -1270,7 +1431,7 @@ sequence::verify_and_link ()
 void
 sequence::link_new ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.link_new();
 }
 
@@ -1344,7 +1505,7 @@ sequence::remove (event & e)
 bool
 sequence::remove_marked ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
 
 #ifdef LAYK_PULL_REQUEST_95
 
@@ -1403,7 +1564,7 @@ sequence::mark_selected ()
 void
 sequence::remove_selected ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (m_events.mark_selected())
     {
         m_events_undo.push(m_events);           /* push_undo() without lock */
@@ -1672,7 +1833,7 @@ sequence::select_note_events
 )
 {
     int result = 0;
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -1878,7 +2039,7 @@ sequence::select_events
 )
 {
     int result = 0;
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -2006,7 +2167,8 @@ sequence::move_selected_notes (midipulse delta_tick, int delta_note)
 {
     if (mark_selected())                            /* locked recursively   */
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
+        event_list moved_events;
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
@@ -2025,13 +2187,16 @@ sequence::move_selected_notes (midipulse delta_tick, int delta_note)
 
                     e.set_timestamp(newts);
                     e.select();                     /* keep it selected     */
-                    add_event(e);
-                    modify();
+                    moved_events.append(e);         /* sorted by merge()    */
                 }
             }
         }
-        if (remove_marked())
-            verify_and_link();
+        (void) remove_marked();                     /* remove originals     */
+        m_events.merge(moved_events);               /* events get presorted */
+        verify_and_link();
+        reset_draw_marker();
+        set_dirty();
+        modify();
     }
 }
 
@@ -2159,7 +2324,7 @@ sequence::stretch_selected (midipulse delta_tick)
 {
     if (mark_selected())
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         unsigned first_ev = 0x7fffffff;             /* timestamp lower limit */
         unsigned last_ev = 0x00000000;              /* timestamp upper limit */
         m_events_undo.push(m_events);               /* push_undo(), no lock  */
@@ -2181,6 +2346,7 @@ sequence::stretch_selected (midipulse delta_tick)
         if (new_len > 1)
         {
             float ratio = float(new_len) / float(old_len);
+            event_list stretched_events;
             mark_selected();                        /* locked recursively   */
             for
             (
@@ -2195,11 +2361,14 @@ sequence::stretch_selected (midipulse delta_tick)
                     midipulse t = er.get_timestamp();
                     n.set_timestamp(midipulse(ratio * (t - first_ev)) + first_ev);
                     n.unmark();
-                    add_event(n);
+                    stretched_events.append(n);     /* sorted by merge()    */
                 }
             }
-            if (remove_marked())
-                verify_and_link();
+            (void) remove_marked();                 /* remove originals     */
+            m_events.merge(stretched_events);       /* presorts the events  */
+            verify_and_link();
+            reset_draw_marker();
+            set_dirty();
         }
     }
 }
@@ -2250,7 +2419,8 @@ sequence::grow_selected (midipulse delta)
 {
     if (mark_selected())                            /* locked recursively   */
     {
-        automutex locker(m_mutex);                  /* lock it again, dude  */
+        editlock locker(*this);                     /* lock it again, dude  */
+        event_list grown_events;
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
@@ -2274,8 +2444,7 @@ sequence::grow_selected (midipulse delta)
                     er.unmark();                    /* keep old on event    */
                     e.unmark();                     /* keep new off event   */
                     e.set_timestamp(newtime);       /* new off-time         */
-                    add_event(e);                   /* add fixed off event  */
-                    modify();
+                    grown_events.append(e);         /* fixed off event      */
                 }
             }
             else if (er.is_marked())                /* non-Note event?      */
@@ -2284,12 +2453,15 @@ sequence::grow_selected (midipulse delta)
                 midipulse ontime = er.get_timestamp();
                 midipulse newtime = clip_timestamp(ontime, ontime + delta);
                 e.set_timestamp(newtime);           /* adjust time-stamp    */
-                add_event(e);                       /* add adjusted event   */
-                modify();
+                grown_events.append(e);             /* adjusted event       */
             }
         }
-        if (remove_marked())
-            verify_and_link();
+        (void) remove_marked();                     /* remove originals     */
+        m_events.merge(grown_events);               /* events get presorted */
+        verify_and_link();
+        reset_draw_marker();
+        set_dirty();
+        modify();
     }
 }
 
@@ -2305,7 +2477,7 @@ sequence::randomize_selected
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events_undo.push(m_events);               /* push_undo(), no lock  */
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -2339,6 +2511,7 @@ sequence::randomize_selected
 
             data[datidx] = datitem;
             e.set_data(data[0], data[1]);
+            m_events.modify();                      /* for playback         */
         }
     }
 }
@@ -2349,7 +2522,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -2375,6 +2548,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
 
             data[datidx] = datitem;
             e.set_data(data[0], data[1]);
+            m_events.modify();                      /* for playback         */
         }
     }
 }
@@ -2405,7 +2579,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
 void
 sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -2417,6 +2591,8 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
                     er.increment_data2();
                 else if (event::is_one_byte_msg(astat))
                     er.increment_data1();
+
+                m_events.modify();                  /* for playback         */
             }
         }
     }
@@ -2448,7 +2624,7 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 void
 sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -2460,6 +2636,8 @@ sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
                     er.decrement_data2();
                 else if (event::is_one_byte_msg(astat))
                     er.decrement_data1();
+
+                m_events.modify();                  /* for playback         */
             }
         }
     }
@@ -2615,7 +2793,7 @@ sequence::paste_selected (midipulse tick, int note)
 {
     if (! m_events_clipboard.empty())
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         event_list clipbd = m_events_clipboard;     /* copy the clipboard   */
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
@@ -2735,7 +2913,7 @@ sequence::change_event_data_range
     int data_s, int data_f, bool useundo
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     bool have_selection = m_events.any_selected_events(status, cc);
     if (useundo)
@@ -2821,6 +2999,7 @@ sequence::change_event_data_range
 
                 er.set_data(d0, d1);
             }
+            m_events.modify();                          /* for playback     */
             result = true;
         }
     }
@@ -2865,7 +3044,7 @@ sequence::change_event_data_relative
     int newval, bool useundo
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     bool have_selection = m_events.any_selected_events(status, cc);
     if (useundo)
@@ -2946,6 +3125,7 @@ sequence::change_event_data_relative
                 d1 = newdata;
 
             er.set_data(d0, d1);
+            m_events.modify();                          /* for playback     */
         }
     }
     return result;
@@ -2997,7 +3177,7 @@ sequence::change_event_data_lfo
     wave_type_t wave, midibyte status, midibyte cc, bool useundo
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     double dlength = double(m_length);
     double dbw = double(m_time_beat_width);
     bool have_selection = m_events.any_selected_events(status, cc);
@@ -3051,6 +3231,7 @@ sequence::change_event_data_lfo
                 d0 = newdata;
 
             e.set_data(d0, d1);
+            m_events.modify();                          /* for playback     */
         }
     }
 }
@@ -3122,7 +3303,7 @@ sequence::add_note
     bool result = false;
     if (tick >= 0 && note >= 0 && note < c_num_keys)
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         bool hardwire = velocity == SEQ64_PRESERVE_VELOCITY;
         bool ignore = false;
         if (paint)                        /* see the banner above */
@@ -3273,7 +3454,7 @@ sequence::add_chord (int chord, midipulse tick, midipulse len, int note)
 bool
 sequence::add_event (const event & er)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = m_events.add(er);     /* post/auto-sorts by time & rank   */
     if (result)
     {
@@ -3340,7 +3521,7 @@ sequence::add_event
     midibyte d0, midibyte d1, bool paint
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     if (tick >= 0)
     {
@@ -3402,9 +3583,12 @@ sequence::check_loop_reset ()
  *  Streams the given event.  The event's timestamp is adjusted, if needed.
  *  If recording:
  *
- *      -   If the pattern is playing, the event is added.
+ *      -   If the pattern is playing, the event is pushed into the record
+ *          buffer, without locking the pattern.  It is added to the pattern
+ *          by flush_recording(), which the input thread calls after each
+ *          burst of input, or here if the buffer is full.
  *      -   If the pattern is playing and quantized record is in force, the
- *          note's timestamp is altered.
+ *          note's timestamp is altered when it is flushed.
  *      -   If not playing, but the event is a Note On or Note Off, we add it
  *          and keep track of it.
  *
@@ -3441,24 +3625,29 @@ sequence::check_loop_reset ()
 bool
 sequence::stream_event (event & ev)
 {
-    automutex locker(m_mutex);
     bool result = channels_match(ev);           /* set if channel matches   */
     if (result)
     {
         /**
          * If in overwrite loop-record mode, any events after reset should
-         * clear the old items from the previous pass through the loop.
+         * clear the old items from the previous pass through the loop,
+         * including those still waiting in the record buffer.
          *
          * \todo
          *      If the last event was a Note Off, we should clear it here, and
          *      how?
          */
 
-        if (overwrite_recording() && loop_reset())
+        if (overwrite_recording())
         {
-            loop_reset(false);
-            remove_all();                       /* clear old items          */
-            // set_dirty(); ???
+            editlock locker(*this);
+            if (loop_reset())
+            {
+                loop_reset(false);
+                m_record_buffer.clear();
+                remove_all();                   /* clear old items          */
+                // set_dirty(); ???
+            }
         }
         ev.set_status(ev.get_status());         /* clear the channel nybble */
         ev.mod_timestamp(m_length);             /* adjust tick re length    */
@@ -3469,11 +3658,15 @@ sequence::stream_event (event & ev)
                 if (ev.is_note_on() && m_rec_vol > SEQ64_PRESERVE_VELOCITY)
                     ev.set_note_velocity(m_rec_vol);    /* modify incoming  */
 
-                add_event(ev);                          /* more locking     */
-                set_dirty();
+                if (! m_record_buffer.push(ev))         /* no locking       */
+                {
+                    flush_recording();
+                    (void) m_record_buffer.push(ev);
+                }
             }
             else
             {
+                editlock locker(*this);
                 /*
                  * Supports the step-edit feature, where we are entering notes
                  * without playback occurring, so we set the generic default
@@ -3507,25 +3700,68 @@ sequence::stream_event (event & ev)
                     --m_notes_on;
 
                 if (m_notes_on <= 0)
-                    m_last_tick += m_snap_tick;
+                    set_last_tick(last_tick() + m_snap_tick);
+
+                link_new();                             /* more locking     */
             }
         }
         if (m_thru)
-            put_event_on_bus(ev);                       /* more locking     */
+        {
+            automutex locker(m_mutex);                  /* m_playing_notes  */
+            put_event_on_bus(ev);
+        }
+    }
+    return result;
+}
+
+/**
+ *  Merges the events waiting in the record buffer into the pattern, in one
+ *  sorted batch, and links only the new notes.  If quantized record is in
+ *  force, each recorded Note Off then has its note quantized, as
+ *  stream_event() used to do for each one.
+ *
+ *  Called by the input thread after each burst of input, by stream_event()
+ *  when the buffer is full, and when recording is turned off.  The lock of
+ *  the pattern makes the caller the only consumer of the buffer.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::flush_recording ()
+{
+    if (m_record_buffer.empty())
+        return;
+
+    editlock locker(*this);
+    event ev;
+    m_record_batch.clear();
+    while (m_record_buffer.pop(ev))
+        m_record_batch.push_back(ev);
+
+    if (m_record_batch.empty())
+        return;
 
-        link_new();                                     /* more locking     */
-        if (m_quantized_rec && m_parent->is_pattern_playing())
+    m_events.merge_recorded(m_record_batch);
+    reset_draw_marker();
+    set_dirty();
+    if (m_quantized_rec && m_parent->is_pattern_playing())
+    {
+        for
+        (
+            std::vector<event>::const_iterator i = m_record_batch.begin();
+            i != m_record_batch.end(); ++i
+        )
         {
-            if (ev.is_note_off())
+            if (i->is_note_off())
             {
-                midipulse timestamp = ev.get_timestamp();
-                midibyte note = ev.get_note();
+                midipulse timestamp = i->get_timestamp();
+                midibyte note = i->get_note();
                 select_note_events(timestamp, note, timestamp, note, e_select);
                 quantize_events(EVENT_NOTE_ON, 0, m_snap_tick, 1, true);
             }
         }
     }
-    return result;
 }
 
 /**
@@ -3952,8 +4188,10 @@ sequence::delete_trigger (midipulse tick)
 }
 
 /**
- *  Sets m_trigger_offset and wraps it to m_length.  If m_length is 0, then
- *  m_trigger_offset is simply set to the parameter.
+ *  Sets m_trigger_offset.  The offset is stored as given, and wrapped to a
+ *  length only when it is used (see wrap_trigger_offset()), since play()
+ *  must wrap it to the length published with the playback snapshot, which
+ *  can differ from m_length while an edit is in progress.
  *
  * \threadsafe
  *
@@ -3965,17 +4203,32 @@ void
 sequence::set_trigger_offset (midipulse trigger_offset)
 {
     automutex locker(m_mutex);
-    if (m_length > 0)
-    {
-        m_trigger_offset = trigger_offset % m_length;
-        m_trigger_offset += m_length;
-        m_trigger_offset %= m_length;
-    }
-    else
+    m_trigger_offset = trigger_offset;
+}
+
+/**
+ *  Wraps m_trigger_offset to the given length.  If the length is 0, the
+ *  offset is returned unchanged.
+ *
+ * \param len
+ *      The length of the sequence, either m_length or the length of the
+ *      playback snapshot.
+ *
+ * \return
+ *      Returns the trigger offset, from 0 to len - 1.
+ */
+
+midipulse
+sequence::wrap_trigger_offset (midipulse len) const
+{
+    midipulse offset = m_trigger_offset;
+    if (len > 0)
     {
-        errprint("set_trigger_offset(): seq length = 0");
-        m_trigger_offset = trigger_offset;
+        offset %= len;
+        offset += len;
+        offset %= len;
     }
+    return offset;
 }
 
 /**
@@ -4381,6 +4634,8 @@ sequence::reset_draw_marker ()
 {
     automutex locker(m_mutex);
     m_iterator_draw = m_events.begin();
+    m_draw_index = 0;
+    m_draw_generation = m_events.generation();
 }
 
 /**
@@ -4397,7 +4652,39 @@ void
 sequence::inc_draw_marker ()
 {
     automutex locker(m_mutex);
-    ++m_iterator_draw;
+    seek_draw_marker();
+    if (m_iterator_draw != m_events.end())
+    {
+        ++m_iterator_draw;
+        ++m_draw_index;
+    }
+}
+
+/**
+ *  Puts the draw marker back in place if the events have changed since it
+ *  was set, as play() does with its cursor.  The marker is moved to the same
+ *  number of events from the start, or to the end, so a drawing pass that
+ *  is interrupted by an edit or a recording at worst draws an event twice or
+ *  skips one, and the next pass is right.  The caller must hold m_mutex.
+ *
+ * \threadunsafe
+ */
+
+void
+sequence::seek_draw_marker ()
+{
+    if (m_draw_generation != m_events.generation())
+    {
+        int count = m_events.count();
+        if (m_draw_index > count)
+            m_draw_index = count;
+
+        m_iterator_draw = m_events.begin();
+        for (int i = 0; i < m_draw_index; ++i)
+            ++m_iterator_draw;
+
+        m_draw_generation = m_events.generation();
+    }
 }
 
 /**
@@ -4517,8 +4804,10 @@ sequence::get_next_note_event
     int & note, bool & selected, int & velocity
 )
 {
+    automutex locker(m_mutex);
+    seek_draw_marker();
     tick_f = 0;
-    while (m_iterator_draw != m_events.end())   /* not threadsafe           */
+    while (m_iterator_draw != m_events.end())
     {
         event & drawevent = DREF(m_iterator_draw);
         bool isnoteon = drawevent.is_note_on();
@@ -4583,7 +4872,9 @@ sequence::get_next_note_event
 bool
 sequence::get_next_event (midibyte & status, midibyte & cc)
 {
-    while (m_iterator_draw != m_events.end())       /* NOT THREADSAFE!!!    */
+    automutex locker(m_mutex);
+    seek_draw_marker();
+    while (m_iterator_draw != m_events.end())
     {
         midibyte d1;
         event & drawevent = DREF(m_iterator_draw);
@@ -4770,7 +5061,7 @@ sequence::get_next_trigger
 void
 sequence::remove_all ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.clear();
     m_events.unmodify();
 }
@@ -4787,7 +5078,10 @@ void
 sequence::set_last_tick (midipulse tick)
 {
     automutex locker(m_mutex);
+    bool parked = m_parked.exchange(false);
     m_last_tick = tick;
+    if (parked && not_nullptr(m_parent))
+        m_parent->wake_sequences();         /* play() must update the tick  */
 }
 
 /**
@@ -4802,10 +5096,248 @@ sequence::set_last_tick (midipulse tick)
 midipulse
 sequence::get_last_tick () const
 {
+    midipulse lt = last_tick();
     if (m_length > 0)
-        return (m_last_tick + m_length - m_trigger_offset) % m_length;
+        return (lt + m_length - wrap_trigger_offset(m_length)) % m_length;
+    else
+        return lt - m_trigger_offset;
+}
+
+/**
+ *  Provides the value of m_last_tick, which, while the sequence is parked
+ *  by the perform object, is not updated by play().  It is then the tick
+ *  following the last one played by the perform object, which is what
+ *  play() would have set.
+ */
+
+midipulse
+sequence::last_tick () const
+{
+    if (m_parked && not_nullptr(m_parent))
+        return m_parent->get_tick() + 1;
     else
-        return m_last_tick - m_trigger_offset;
+        return m_last_tick;
+}
+
+/**
+ *  Brings m_last_tick up to date and clears the parked flag, so that play()
+ *  can be called again.  Called by the perform object when it rebuilds its
+ *  list of active patterns.
+ */
+
+void
+sequence::unpark ()
+{
+    if (m_parked)
+    {
+        m_last_tick = last_tick();
+        m_parked = false;
+    }
+}
+
+/**
+ *  Indicates if perform::play() must call play_queue() for this sequence on
+ *  every tick.  That is the case if the sequence is playing, queued,
+ *  one-shot, or song-recording, or if in song mode it has triggers at or
+ *  after the current position.  A muted, idle pattern needs only its last
+ *  tick kept up to date, which last_tick() does without calling play().
+ *
+ *  This function is called by the output thread, and so only tries the
+ *  mutex, which protects the trigger list.  If an edit holds it, the
+ *  sequence is kept in the list, to be checked again on the next tick.
+ *
+ * \param songmode
+ *      True if the perform object is in song (playback) mode.
+ *
+ * \return
+ *      Returns true if play() still needs to be called.
+ */
+
+bool
+sequence::needs_play (bool songmode) const
+{
+    if (m_playing || m_queued)
+        return true;
+
+#ifdef SEQ64_SONG_RECORDING
+    if (m_one_shot || m_song_recording)
+        return true;
+#endif
+
+    bool result = true;
+    if (m_mutex.try_lock())
+    {
+        result = songmode && m_triggers.count() > 0 &&
+            m_triggers.get_maximum() >= m_last_tick;
+
+        m_mutex.unlock();
+    }
+    return result;
+}
+
+/**
+ *  Finds the next tick, after the given one, at which play_queue() has
+ *  something to do for this sequence:  the next event to be played (read
+ *  from the playback cursor), the queued or one-shot tick, or in song mode
+ *  the next trigger start or end.  Used by the event-driven output
+ *  scheduler of the perform object, which sleeps until the earliest of these
+ *  ticks.  Called by the output thread, right after play().
+ *
+ *  When the answer cannot be known cheaply (the playback cursor must be
+ *  re-seeked, an edit holds the mutex, or song-recording is growing a
+ *  trigger), the next tick is returned, so that the scheduler falls back to
+ *  playing on the next tick.
+ *
+ * \param tick
+ *      The tick just played, a global tick.
+ *
+ * \param songmode
+ *      True if the perform object is in song (playback) mode.
+ *
+ * \return
+ *      Returns the next due tick, or SEQ64_NULL_MIDIPULSE if nothing is due.
+ */
+
+midipulse
+sequence::next_due_tick (midipulse tick, bool songmode)
+{
+    midipulse result = SEQ64_NULL_MIDIPULSE;
+    if (m_queued)
+        result = m_queued_tick;
+
+#ifdef SEQ64_SONG_RECORDING
+    if (m_song_recording)
+        return tick + 1;
+
+    if (m_one_shot)
+    {
+        if (is_null_midipulse(result) || m_one_shot_tick < result)
+            result = m_one_shot_tick;
+    }
+#endif
+
+    if (songmode)
+    {
+        if (m_mutex.try_lock())
+        {
+            midipulse t = m_triggers.next_change(tick);
+            m_mutex.unlock();
+            if (is_null_midipulse(result) || (! is_null_midipulse(t) && t < result))
+                result = t;
+        }
+        else
+            return tick + 1;
+    }
+    if (m_playing)
+    {
+        if (m_song_mute)
+            return tick + 1;                /* play() will turn it off      */
+
+        ++m_playback_readers;               /* pin the current snapshot     */
+
+        const playback_events & pe = *m_playback.load();
+        midipulse len = pe.length();
+        midipulse offset = len - wrap_trigger_offset(len);
+        midipulse t = SEQ64_NULL_MIDIPULSE;
+        if (len > 0)                        /* else nothing can be played   */
+        {
+            if (! play_cursor_valid(pe, m_last_tick + offset))
+                t = tick + 1;
+            else if (m_play_cursor_index < pe.count())
+            {
+                const playback_events::item & it = pe.at(m_play_cursor_index);
+                t = it.pe_timestamp + m_play_cursor_base - offset;
+            }
+        }
+        --m_playback_readers;
+        if (is_null_midipulse(result) || (! is_null_midipulse(t) && t < result))
+            result = t;
+    }
+    if (! is_null_midipulse(result) && result <= tick)
+        result = tick + 1;
+
+    return result;
+}
+
+/**
+ *  Adds the Set Tempo events of the sequence to a tempo map.  The
+ *  time-stamps are used as song positions, as they are in the tempo track of
+ *  a MIDI file.  Called by perform::rebuild_tempo_map().
+ *
+ * \threadsafe
+ *      The playback snapshot is pinned, rather than m_mutex locked, since
+ *      the caller might be another sequence publishing its own snapshot.
+ *
+ * \param [out] tm
+ *      The tempo map to which the tempo events are added.
+ */
+
+void
+sequence::get_tempo_changes (tempo_map & tm)
+{
+    ++m_playback_readers;                   /* pin the current snapshot     */
+
+    const playback_events & pe = *m_playback.load();
+    if (pe.tempo_count() > 0)
+    {
+        for (int i = 0; i < pe.count(); ++i)
+        {
+            const playback_events::item & it = pe.at(i);
+            if (it.is_tempo())
+                tm.add(it.pe_timestamp, it.pe_tempo);
+        }
+    }
+    --m_playback_readers;
+}
+
+/**
+ *  Parks the sequence, if it no longer needs to be played on every tick.
+ *  Called by perform::play() right after play(), so that m_last_tick is
+ *  then the parent's tick plus one, as last_tick() assumes.
+ *
+ *  The need is checked again after the flag is set.  A change made by
+ *  another thread in the meantime either is seen by that second check, or
+ *  sees the flag set and calls wake_playback().  This works because the
+ *  flags involved are all sequentially-consistent atomics:  the store to
+ *  m_parked cannot be ordered after the loads of needs_play(), nor the
+ *  store of a setter after its load of m_parked.  The triggers are checked
+ *  under the mutex, which their editors hold while changing them.
+ *
+ * \param songmode
+ *      True if the perform object is in song (playback) mode.
+ *
+ * \return
+ *      Returns true if the sequence was parked, and can be dropped from the
+ *      list of active patterns.
+ */
+
+bool
+sequence::park (bool songmode)
+{
+    if (needs_play(songmode))
+        return false;
+
+    m_parked = true;
+    if (needs_play(songmode))
+    {
+        m_parked = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ *  Tells the parent that this parked sequence might need to be played on
+ *  every tick again, after a change in its playing, queuing, or trigger
+ *  status.  The perform object then rebuilds its list of active patterns on
+ *  the next tick.  Must be called after the change is made.
+ */
+
+void
+sequence::wake_playback ()
+{
+    if (m_parked && not_nullptr(m_parent))
+        m_parent->wake_sequences();
 }
 
 /**
@@ -4894,7 +5426,7 @@ sequence::set_midi_bus (char mb, bool user_change)
 void
 sequence::set_length (midipulse len, bool adjust_triggers, bool verify)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool was_playing = get_playing();
     set_playing(false);                 /* turn everything off              */
     if (len > 0)
@@ -5008,6 +5540,7 @@ sequence::set_playing (bool p)
 #endif
 
         set_dirty();
+        wake_playback();
     }
     m_queued = false;
 #ifdef SEQ64_SONG_RECORDING
@@ -5030,6 +5563,9 @@ sequence::set_recording (bool r)
     automutex locker(m_mutex);
     if (r != m_recording)
     {
+        if (! r)
+            flush_recording();  /* merge what was recorded before stopping */
+
         m_notes_on = 0;         // is there a more robust way to do this?
         m_recording = r;
     }
@@ -5303,18 +5839,32 @@ sequence::print_triggers () const
 /**
  *  Takes an event that this sequence is holding, and places it on the MIDI
  *  buss.  This function does not bother checking if m_master_bus is a null
- *  pointer.
+ *  pointer.  It no longer locks the sequence mutex, since it is called by
+ *  play() while an edit may hold it; the note counts are atomic.
+ *
+ *  In a parallel pass of perform::play(), the event is recorded in the
+ *  render buffer of the worker instead, and put on the buss when the pass
+ *  is merged.
  *
  * \param ev
  *      The event to put on the buss.
  *
+ * \param delay_us
+ *      The time from now, in microseconds, at which the event is due.  Zero
+ *      unless perform::play() is rendering ahead of the playback position.
+ *
+ * \param flush
+ *      If true (the default), the master buss is flushed, so that the event
+ *      goes out right away.  The output thread passes false, and flushes
+ *      once per pass of perform::play(), so that a busy tick costs one
+ *      drain of the output, rather than one per event.
+ *
  * \threadsafe
  */
 
 void
-sequence::put_event_on_bus (event & ev)
+sequence::put_event_on_bus (event & ev, long delay_us, bool flush)
 {
-    automutex locker(m_mutex);
     midibyte note = ev.get_note();
     bool skip = false;
     if (ev.is_note_on())
@@ -5335,8 +5885,15 @@ sequence::put_event_on_bus (event & ev)
          *      actually playing an event?
          */
 
-        m_master_bus->play(m_bus, &ev, m_midi_channel);
-        m_master_bus->flush();
+        render_buffer * rb = m_render_buffer.load();
+        if (not_nullptr(rb))
+            rb->add(m_bus, ev, m_midi_channel, delay_us);
+        else
+        {
+            m_master_bus->play(m_bus, &ev, m_midi_channel, delay_us);
+            if (flush)
+                m_master_bus->flush();
+        }
     }
 }
 
@@ -5344,6 +5901,12 @@ sequence::put_event_on_bus (event & ev)
  *  Sends a note-off event for all active notes.  This function does not
  *  bother checking if m_master_bus is a null pointer.
  *
+ *  If perform::play() renders ahead, some of the active notes may not have
+ *  been sent yet, so the note-offs are delayed by the lookahead window, to
+ *  make sure they follow the note-ons.  If the worker rendering the sequence
+ *  in a parallel pass turns it off, the note-offs are recorded in its render
+ *  buffer, after the notes of the pass.
+ *
  * \threadsafe
  */
 
@@ -5351,6 +5914,11 @@ void
 sequence::off_playing_notes ()
 {
     automutex locker(m_mutex);
+    long delay_us = not_nullptr(m_parent) ? m_parent->lookahead_us() : 0 ;
+    render_buffer * rb = m_render_buffer.load();
+    if (not_nullptr(rb) && ! rb->is_owner())
+        rb = nullptr;                           /* not the renderer thread  */
+
     event e;
     for (int x = 0; x < c_midi_notes; ++x)
     {
@@ -5358,12 +5926,17 @@ sequence::off_playing_notes ()
         {
             e.set_status(EVENT_NOTE_OFF);
             e.set_data(x, midibyte(127));               /* or is 0 better?  */
-            m_master_bus->play(m_bus, &e, m_midi_channel);
+            if (not_nullptr(rb))
+                rb->add(m_bus, e, m_midi_channel, delay_us);
+            else
+                m_master_bus->play(m_bus, &e, m_midi_channel, delay_us);
+
             if (m_playing_notes[x] > 0)
                 m_playing_notes[x]--;
         }
     }
-    m_master_bus->flush();
+    if (is_nullptr(rb))
+        m_master_bus->flush();
 }
 
 /**
@@ -5396,7 +5969,7 @@ sequence::select_events
     midibyte status, midibyte cc, bool inverse
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     midibyte d0, d1;
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -5453,7 +6026,7 @@ sequence::transpose_notes (int steps, int scale)
 {
     if (mark_selected())                            /* mark original notes  */
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         event_list transposed_events;
         const int * transpose_table;
         m_events_undo.push(m_events);               /* push_undo(), no lock  */
@@ -5508,7 +6081,7 @@ sequence::shift_notes (midipulse ticks)
 {
     if (mark_selected())
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         event_list shifted_events;
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
@@ -5554,7 +6127,7 @@ sequence::apply_song_transpose ()
     int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
     if (transpose != 0)
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
@@ -5562,6 +6135,7 @@ sequence::apply_song_transpose ()
             if (er.is_note())                       /* also aftertouch      */
                 er.transpose_note(transpose);
         }
+        m_events.modify();                          /* for playback         */
         set_dirty();
     }
 }
@@ -5617,7 +6191,7 @@ sequence::quantize_events
     midipulse snap_tick, int divide, bool linked
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (mark_selected())
     {
         /*
@@ -5740,7 +6314,7 @@ sequence::push_quantize
     midipulse snap_tick, int divide, bool linked
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events_undo.push(m_events);
     quantize_events(status, cc, snap_tick, divide, linked);
 }
@@ -5750,7 +6324,7 @@ sequence::push_quantize
 void
 sequence::multiply_pattern (double multiplier)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events_undo.push(m_events);               /* push_undo(), no lock */
     midipulse orig_length = get_length();
     midipulse new_length = midipulse(orig_length * multiplier);
@@ -5771,6 +6345,7 @@ sequence::multiply_pattern (double multiplier)
         timestamp %= m_length;
         er.set_timestamp(timestamp);
     }
+    m_events.modify();                  /* for playback                 */
     verify_and_link();
     if (new_length < orig_length)
         set_length(new_length);
@@ -5828,7 +6403,7 @@ sequence::show_events () const
 void
 sequence::copy_events (const event_list & newevents)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.clear();
     m_events = newevents;
     if (m_events.empty())
@@ -5841,7 +6416,7 @@ sequence::copy_events (const event_list & newevents)
         // WTF?
     }
 
-    m_iterator_draw = m_events.begin();     /* same as in reset_draw_marker */
+    reset_draw_marker();
     if (! m_events.empty())                 /* need at least 1 (2?) events  */
     {
         /*
@@ -5986,8 +6561,9 @@ sequence::toggle_one_shot ()
     automutex locker(m_mutex);
     set_dirty_mp();
     m_one_shot = ! m_one_shot;
-    m_one_shot_tick = m_last_tick - mod_last_tick() + m_length;
+    m_one_shot_tick = last_tick() - mod_last_tick() + m_length;
     m_off_from_snap = true;
+    wake_playback();
 }
 
 /**
@@ -6028,6 +6604,7 @@ sequence::song_recording_start (midipulse tick, bool snap)
     m_song_recording_snap = snap;
     m_song_record_tick = tick;
     m_song_recording = true;
+    wake_playback();
 
     /*
      * Do we need to add this setting?
@@ -6077,15 +6654,16 @@ sequence::resume_note_ons (midipulse tick)
         event_list::iterator ei = m_events.begin(); ei != m_events.end(); ++ei
     )
     {
-        if (ei->is_note_on())
+        event & er = DREF(ei);
+        if (er.is_note_on())
         {
-            event * link = ei->get_linked();
+            event * link = er.get_linked();
             if (not_nullptr(link))
             {
-                midipulse on = ei->get_timestamp();      /* see banner notes */
+                midipulse on = er.get_timestamp();       /* see banner notes */
                 midipulse off = link->get_timestamp();
                 if (on < (tick % m_length) && off > (tick % m_length))
-                    put_event_on_bus(*ei);
+                    put_event_on_bus(er, 0, false);     /* batched      */
             }
         }
     }
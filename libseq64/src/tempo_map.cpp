@@ -0,0 +1,251 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempo_map.cpp
+ *
+ *  This module declares/defines a song-wide map of the tempo changes, for
+ *  converting between ticks and microseconds.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-18
+ * \updates       2018-11-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the tempo_map.hpp module.
+ */
+
+#include <algorithm>                    /* std::stable_sort()               */
+
+#include "calculations.hpp"             /* seq64::pulse_length_us()         */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Orders two segments by tick, for std::stable_sort().
+ */
+
+static bool
+segment_less (const tempo_map::segment & a, const tempo_map::segment & b)
+{
+    return a.tm_tick < b.tm_tick;
+}
+
+/**
+ *  Principal constructor.  Creates a map with the base tempo only.
+ *
+ * \param bpm
+ *      The tempo in force until the first tempo event, unless that event is
+ *      at tick 0.
+ *
+ * \param ppqn
+ *      The pulses-per-quarter-note of the song.
+ */
+
+tempo_map::tempo_map (midibpm bpm, int ppqn)
+ :
+    m_segments  (),
+    m_changes   (0),
+    m_ppqn      (ppqn > 0 ? ppqn : SEQ64_DEFAULT_PPQN)
+{
+    segment s;
+    s.tm_tick = 0;
+    s.tm_bpm = bpm > 0.0 ? bpm : SEQ64_DEFAULT_BPM ;
+    s.tm_us = 0.0;
+    m_segments.push_back(s);
+}
+
+/**
+ *  Adds a tempo event to the map.  The events can be added in any order;
+ *  finish() must be called once they are all added.
+ *
+ * \param tick
+ *      The song position of the tempo event.
+ *
+ * \param bpm
+ *      The new tempo.  A value that is not positive is ignored.
+ */
+
+void
+tempo_map::add (midipulse tick, midibpm bpm)
+{
+    if (bpm > 0.0 && tick >= 0)
+    {
+        segment s;
+        s.tm_tick = tick;
+        s.tm_bpm = bpm;
+        s.tm_us = 0.0;
+        m_segments.push_back(s);
+        ++m_changes;
+    }
+}
+
+/**
+ *  Sorts the segments, keeps only the last of the tempos set at the same
+ *  tick, and computes the starting time of each segment.  A tempo event at
+ *  tick 0 replaces the base tempo.
+ */
+
+void
+tempo_map::finish ()
+{
+    std::stable_sort(m_segments.begin(), m_segments.end(), segment_less);
+
+    std::vector<segment>::iterator out = m_segments.begin();
+    for
+    (
+        std::vector<segment>::iterator i = m_segments.begin() + 1;
+        i != m_segments.end(); ++i
+    )
+    {
+        if (i->tm_tick == out->tm_tick)
+            out->tm_bpm = i->tm_bpm;            /* the later one wins       */
+        else if (i->tm_bpm != out->tm_bpm)
+            *++out = *i;                        /* a real change of tempo   */
+    }
+    m_segments.erase(out + 1, m_segments.end());
+
+    m_segments[0].tm_us = 0.0;
+    for (int i = 1; i < count(); ++i)
+    {
+        const segment & prev = m_segments[i - 1];
+        m_segments[i].tm_us = prev.tm_us +
+            double(m_segments[i].tm_tick - prev.tm_tick) *
+            pulse_length_us(prev.tm_bpm, m_ppqn);
+    }
+}
+
+/**
+ *  Finds the segment in force at the given tick, with a binary search.
+ *
+ * \param tick
+ *      The song position, which may have a fraction.
+ *
+ * \return
+ *      Returns the index of the segment.
+ */
+
+int
+tempo_map::segment_at_tick (double tick) const
+{
+    int low = 0;
+    int high = count() - 1;
+    while (low < high)
+    {
+        int middle = high - (high - low) / 2;
+        if (double(m_segments[middle].tm_tick) <= tick)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+/**
+ *  Finds the segment in force at the given time, with a binary search.
+ *
+ * \param us
+ *      The time from the start of the song, in microseconds.
+ *
+ * \return
+ *      Returns the index of the segment.
+ */
+
+int
+tempo_map::segment_at_us (double us) const
+{
+    int low = 0;
+    int high = count() - 1;
+    while (low < high)
+    {
+        int middle = high - (high - low) / 2;
+        if (m_segments[middle].tm_us <= us)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+/**
+ *  Gets the tempo in force at the given tick.
+ *
+ * \param tick
+ *      The song position.
+ *
+ * \return
+ *      Returns the tempo, in beats per minute.
+ */
+
+midibpm
+tempo_map::bpm_at (double tick) const
+{
+    return m_segments[segment_at_tick(tick)].tm_bpm;
+}
+
+/**
+ *  Converts a song position to the time from the start of the song.
+ *
+ * \param tick
+ *      The song position, which may have a fraction.
+ *
+ * \return
+ *      Returns the time, in microseconds.
+ */
+
+double
+tempo_map::tick_to_us (double tick) const
+{
+    const segment & s = m_segments[segment_at_tick(tick)];
+    double us_per_tick = pulse_length_us(s.tm_bpm, m_ppqn);
+    return s.tm_us + (tick - double(s.tm_tick)) * us_per_tick;
+}
+
+/**
+ *  Converts a time from the start of the song to a song position.  The
+ *  inverse of tick_to_us().
+ *
+ * \param us
+ *      The time, in microseconds.
+ *
+ * \return
+ *      Returns the song position, with its fraction.
+ */
+
+double
+tempo_map::us_to_tick (double us) const
+{
+    const segment & s = m_segments[segment_at_us(us)];
+    double us_per_tick = pulse_length_us(s.tm_bpm, m_ppqn);
+    return double(s.tm_tick) + (us - s.tm_us) / us_per_tick;
+}
+
+}           // namespace seq64
+
+/*
+ * tempo_map.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
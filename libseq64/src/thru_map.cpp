@@ -0,0 +1,274 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          thru_map.cpp
+ *
+ *  This module declares/defines the MIDI-thru routing table.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  See the thru_map.hpp module.
+ */
+
+#include <stdlib.h>                     /* C::strtol()                      */
+
+#include "easy_macros.h"                /* errprintf()                      */
+#include "event.hpp"                    /* seq64::event::is_note_msg()      */
+#include "thru_map.hpp"                 /* seq64::thru_map                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Parses a buss or channel number.
+ *
+ * \param text
+ *      The number, or "*" if wildcard is allowed.
+ *
+ * \param lo
+ *      The lowest legal value.
+ *
+ * \param hi
+ *      The highest legal value.
+ *
+ * \param wildcard
+ *      True if "*" is allowed.
+ *
+ * \param [out] value
+ *      Set to the number, or to SEQ64_THRU_ANY for "*".
+ *
+ * \return
+ *      Returns true if the text is legal.
+ */
+
+static bool
+parse_number
+(
+    const std::string & text, int lo, int hi, bool wildcard, int & value
+)
+{
+    if (text == "*")
+    {
+        value = SEQ64_THRU_ANY;
+        return wildcard;
+    }
+    if (text.empty())
+        return false;
+
+    char * end = nullptr;
+    long n = strtol(text.c_str(), &end, 10);
+    if (*end != 0 || n < lo || n > hi)
+        return false;
+
+    value = int(n);
+    return true;
+}
+
+/**
+ *  Principal constructor.  The table starts empty.
+ */
+
+thru_map::thru_map ()
+ :
+    m_routes    (),
+    m_count     (0)
+{
+    // Empty body
+}
+
+/**
+ *  Replaces the table with the routes given.
+ *
+ * \param spec
+ *      The comma-separated list of routes, as described in the banner of
+ *      thru_map.hpp.  An empty string empties the table.
+ *
+ * \return
+ *      Returns true if all the routes were legal.  If not, the table is left
+ *      empty, and an error is printed.
+ */
+
+bool
+thru_map::parse (const std::string & spec)
+{
+    m_count = 0;
+    std::string::size_type start = 0;
+    while (start < spec.length())
+    {
+        std::string::size_type comma = spec.find(',', start);
+        if (comma == std::string::npos)
+            comma = spec.length();
+
+        std::string text = spec.substr(start, comma - start);
+        route r;
+        if (m_count == SEQ64_THRU_ROUTES_MAX || ! parse_route(text, r))
+        {
+            errprintf("bad or too many thru routes at '%s'\n", text.c_str());
+            m_count = 0;
+            return false;
+        }
+        m_routes[m_count++] = r;
+        start = comma + 1;
+    }
+    return true;
+}
+
+/**
+ *  Parses one route, "inbus[.inchannel]:outbus[.outchannel][+/-transpose]".
+ *
+ * \param text
+ *      The route.
+ *
+ * \param [out] r
+ *      The route parsed.
+ *
+ * \return
+ *      Returns true if the route is legal.
+ */
+
+bool
+thru_map::parse_route (const std::string & text, route & r)
+{
+    std::string::size_type colon = text.find(':');
+    if (colon == std::string::npos)
+        return false;
+
+    std::string in = text.substr(0, colon);
+    std::string out = text.substr(colon + 1);
+    int transpose = 0;
+    std::string::size_type sign = out.find_first_of("+-");
+    if (sign != std::string::npos)
+    {
+        int semitones;
+        std::string amount = out.substr(sign + 1);
+        int most = SEQ64_MIDI_COUNT_MAX - 1;
+        if (! parse_number(amount, 0, most, false, semitones))
+            return false;
+
+        transpose = out[sign] == '-' ? -semitones : semitones ;
+        out = out.substr(0, sign);
+    }
+
+    int inbus, inchannel = SEQ64_THRU_ANY, outbus, outchannel = SEQ64_THRU_ANY;
+    int busmax = SEQ64_DEFAULT_BUSS_MAX - 1;
+    std::string::size_type dot = in.find('.');
+    if (! parse_number(in.substr(0, dot), 0, busmax, true, inbus))
+        return false;
+
+    if (dot != std::string::npos)
+    {
+        std::string ch = in.substr(dot + 1);
+        if (! parse_number(ch, 1, SEQ64_MIDI_CHANNEL_MAX, true, inchannel))
+            return false;
+    }
+    dot = out.find('.');
+    if (! parse_number(out.substr(0, dot), 0, busmax, false, outbus))
+        return false;
+
+    if (dot != std::string::npos)
+    {
+        std::string ch = out.substr(dot + 1);
+        if (! parse_number(ch, 1, SEQ64_MIDI_CHANNEL_MAX, false, outchannel))
+            return false;
+    }
+    r.tr_in_bus = bussbyte(inbus);
+    r.tr_in_channel = midibyte(inchannel == SEQ64_THRU_ANY ?
+        inchannel : inchannel - 1);
+    r.tr_out_bus = bussbyte(outbus);
+    r.tr_out_channel = midibyte(outchannel == SEQ64_THRU_ANY ?
+        outchannel : outchannel - 1);
+    r.tr_transpose = transpose;
+    return true;
+}
+
+/**
+ *  Applies a route to a message.  Only channel messages are routed.  Safe to
+ *  call from the JACK process callback.
+ *
+ * \param index
+ *      The index of the route, from 0 to count() - 1.
+ *
+ * \param inbus
+ *      The input buss of the message, or SEQ64_THRU_ANY if it is not known,
+ *      in which case the input buss of the route is not checked.
+ *
+ * \param [in,out] status
+ *      The status byte of the message.  Set to the status byte to send if
+ *      the route applies.
+ *
+ * \param [in,out] d0
+ *      The first data byte of the message.  Set to the transposed note if
+ *      the route applies and the message carries a note.
+ *
+ * \return
+ *      Returns true if the route applies to the message, in which case it is
+ *      to be sent on out_bus(index).  A note transposed out of range is not
+ *      sent.
+ */
+
+bool
+thru_map::apply
+(
+    int index, bussbyte inbus, midibyte & status, midibyte & d0
+) const
+{
+    const route & r = m_routes[index];
+    if (status < EVENT_NOTE_OFF || status >= EVENT_MIDI_SYSEX)
+        return false;
+
+    if (inbus != SEQ64_THRU_ANY && r.tr_in_bus != SEQ64_THRU_ANY)
+    {
+        if (inbus != r.tr_in_bus)
+            return false;
+    }
+
+    midibyte channel = status & EVENT_GET_CHAN_MASK;
+    if (r.tr_in_channel != SEQ64_THRU_ANY && channel != r.tr_in_channel)
+        return false;
+
+    midibyte type = status & EVENT_CLEAR_CHAN_MASK;
+    if (r.tr_transpose != 0 && event::is_note_msg(type))
+    {
+        int note = int(d0) + r.tr_transpose;
+        if (note < 0 || note >= SEQ64_MIDI_COUNT_MAX)
+            return false;
+
+        d0 = midibyte(note);
+    }
+    if (r.tr_out_channel != SEQ64_THRU_ANY)
+        status = type | r.tr_out_channel;
+
+    return true;
+}
+
+}           // namespace seq64
+
+/*
+ * thru_map.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,232 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          timing_histogram.cpp
+ *
+ *  This module declares/defines a lock-free, log-scale histogram for the
+ *  timing measurements of the output loop.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-20
+ * \updates       2018-11-20
+ * \license       GNU GPLv2 or above
+ *
+ *  See the timing_histogram.hpp module.
+ */
+
+#include <stdio.h>                      /* C::snprintf()                    */
+
+#include "timing_histogram.hpp"         /* seq64::timing_histogram          */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  All counts start at zero.
+ */
+
+timing_histogram::timing_histogram ()
+ :
+    m_count     (0),
+    m_sum       (0),
+    m_max       (0)
+{
+    for (int b = 0; b < c_bucket_count; ++b)
+        m_buckets[b].store(0, std::memory_order_relaxed);
+}
+
+/**
+ *  Records a value.  Lock-free and allocation-free, for the output thread.
+ *
+ * \param value
+ *      The value, in whatever unit the histogram counts.
+ */
+
+void
+timing_histogram::record (unsigned long value)
+{
+    m_buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    if (value > m_max.load(std::memory_order_relaxed))
+        m_max.store(value, std::memory_order_relaxed);  /* one recorder */
+}
+
+/**
+ *  Sets all of the counts back to zero.  A value recorded at the same time
+ *  may be partly counted.
+ */
+
+void
+timing_histogram::reset ()
+{
+    for (int b = 0; b < c_bucket_count; ++b)
+        m_buckets[b].store(0, std::memory_order_relaxed);
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+/**
+ *  Computes the mean of the values recorded.
+ *
+ * \return
+ *      Returns the mean, or 0 if no value has been recorded.
+ */
+
+double
+timing_histogram::mean () const
+{
+    unsigned long n = count();
+    return n > 0 ?
+        double(m_sum.load(std::memory_order_relaxed)) / double(n) : 0.0 ;
+}
+
+/**
+ *  Computes a percentile from the bucket counts.
+ *
+ * \param fraction
+ *      The fraction of the values, such as 0.5 for the median, or 0.999.
+ *
+ * \return
+ *      Returns the upper bound of the bucket holding the percentile, but no
+ *      more than the largest value recorded.  Returns 0 if no value has
+ *      been recorded.
+ */
+
+unsigned long
+timing_histogram::percentile (double fraction) const
+{
+    unsigned long counts[c_bucket_count];
+    unsigned long total = 0;
+    for (int b = 0; b < c_bucket_count; ++b)
+    {
+        counts[b] = m_buckets[b].load(std::memory_order_relaxed);
+        total += counts[b];
+    }
+    if (total == 0)
+        return 0;
+
+    unsigned long target = (unsigned long)(fraction * double(total) + 0.5);
+    if (target < 1)
+        target = 1;
+    else if (target > total)
+        target = total;
+
+    unsigned long sum = 0;
+    int b = 0;
+    for ( ; b < c_bucket_count - 1; ++b)
+    {
+        sum += counts[b];
+        if (sum >= target)
+            break;
+    }
+
+    unsigned long result = bucket_value(b);
+    unsigned long largest = maximum();
+    return result > largest ? largest : result ;
+}
+
+/**
+ *  Formats the count, mean, median, 99th and 99.9th percentiles, and
+ *  maximum, on one line.
+ *
+ * \param name
+ *      The name of the measurement, placed at the start of the line.
+ *
+ * \return
+ *      Returns the line, without a newline.
+ */
+
+std::string
+timing_histogram::report (const std::string & name) const
+{
+    char tmp[160];
+    snprintf
+    (
+        tmp, sizeof tmp,
+        "%-12s n=%lu mean=%.1f p50=%lu p99=%lu p99.9=%lu max=%lu",
+        name.c_str(), count(), mean(), percentile(0.50), percentile(0.99),
+        percentile(0.999), maximum()
+    );
+    return std::string(tmp);
+}
+
+/**
+ *  Finds the bucket of a value.
+ *
+ * \param value
+ *      The value.  Values of 2^32 and above go to the last bucket.
+ *
+ * \return
+ *      Returns the bucket index.
+ */
+
+int
+timing_histogram::bucket_of (unsigned long value)
+{
+    if (value < 16)
+        return int(value);
+
+    if (value > 0xFFFFFFFFUL)
+        value = 0xFFFFFFFFUL;
+
+    int power = 4;
+    while (power < 31 && (value >> (power + 1)) != 0)
+        ++power;
+
+    int sub = int(value >> (power - 3)) & 7;
+    return 16 + (power - 4) * 8 + sub;
+}
+
+/**
+ *  Provides the largest value that goes into a bucket.
+ *
+ * \param bucket
+ *      The bucket index, not validated.
+ *
+ * \return
+ *      Returns the upper bound of the bucket.
+ */
+
+unsigned long
+timing_histogram::bucket_value (int bucket)
+{
+    if (bucket < 16)
+        return (unsigned long)(bucket);
+
+    int power = 4 + (bucket - 16) / 8;
+    unsigned long sub = (unsigned long)((bucket - 16) % 8);
+    unsigned long width = 1UL << (power - 3);
+    return (8 + sub) * width + width - 1;
+}
+
+}           // namespace seq64
+
+/*
+ * timing_histogram.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -59,6 +59,7 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>                    /* std::upper_bound(), etc.     */
 
 #include "sequence.hpp"                 /* the "parent" of the triggers */
 #include "settings.hpp"                 /* seq64::rc() settings access  */
@@ -87,8 +88,8 @@ triggers::triggers (sequence & parent)
     m_clipboard                 (),
     m_undo_stack                (),
     m_redo_stack                (),
-    m_iterator_play_trigger     (),
-    m_iterator_draw_trigger     (),
+    m_play_trigger              (0),
+    m_draw_trigger              (0),
     m_trigger_copied            (false),
     m_paste_tick                (SEQ64_NO_PASTE_TRIGGER),   // stazed
     m_ppqn                      (0),
@@ -135,11 +136,12 @@ triggers::operator = (const triggers & rhs)
         m_clipboard = rhs.m_clipboard;
         m_undo_stack = rhs.m_undo_stack;
         m_redo_stack = rhs.m_redo_stack;
-        m_iterator_play_trigger = rhs.m_iterator_play_trigger;
-        m_iterator_draw_trigger = rhs.m_iterator_draw_trigger;
+        m_play_trigger = rhs.m_play_trigger;
+        m_draw_trigger = rhs.m_draw_trigger;
         m_trigger_copied = rhs.m_trigger_copied;
         m_ppqn = rhs.m_ppqn;
         m_length = rhs.m_length;
+        m_parent.wake_playback();
     }
     return *this;
 }
@@ -177,6 +179,7 @@ triggers::pop_undo ()
         m_redo_stack.push(m_triggers);
         m_triggers = m_undo_stack.top();
         m_undo_stack.pop();
+        m_parent.wake_playback();
     }
 }
 
@@ -194,6 +197,7 @@ triggers::pop_redo ()
         m_undo_stack.push(m_triggers);
         m_triggers = m_redo_stack.top();
         m_redo_stack.pop();
+        m_parent.wake_playback();
     }
 }
 
@@ -223,6 +227,14 @@ triggers::pop_redo ()
  *  If the trigger state has changed, then the start/end ticks are passed back
  *  to the sequence, and the trigger offset is adjusted.
  *
+ *  The walk used to start from the first trigger on every call, so that a
+ *  long song cost more on every tick.  Since the triggers do not overlap,
+ *  the walk always stopped at the first trigger that ends after the end
+ *  tick, and the state comes from that trigger or the one before it.  That
+ *  trigger is now found from the playback cursor, m_play_trigger, which
+ *  normally needs to move ahead by one trigger at most, or by a binary
+ *  search if playback was repositioned or the triggers were edited.
+ *
  * \param start_tick
  *      Provides the starting tick value, and returns the modified value as a
  *      side-effect.
@@ -257,32 +269,41 @@ triggers::play
     midipulse trigger_offset = 0;
     midipulse trigger_tick = 0;
     bool trigger_state = false;
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    int count = int(m_triggers.size());
+    int i = m_play_trigger;
+    if (i > count || (i > 0 && m_triggers[i - 1].tick_end() > end_tick))
+    {
+        i = first_ending_after(end_tick);       /* re-seek the cursor       */
+    }
+    else
+    {
+        while (i < count && m_triggers[i].tick_end() <= end_tick)
+            ++i;                                /* usually zero or one step */
+    }
+    m_play_trigger = i;
+    if (i < count && m_triggers[i].tick_start() <= end_tick)
     {
+        trigger_state = true;                   /* inside trigger i         */
+        trigger_tick = m_triggers[i].tick_start();
+        trigger_offset = m_triggers[i].offset();
+    }
+    else if (i > 0)
+    {
+        trigger_state = false;                  /* after trigger i - 1      */
+        trigger_tick = m_triggers[i - 1].tick_end();
+        trigger_offset = m_triggers[i - 1].offset();
+    }
 
 #ifdef SEQ64_SONG_RECORDING
-        if (i->at_trigger_transition(start_tick, end_tick))
-            m_parent.song_playback_block(false);
-#endif
+    for (int t = (i < count) ? i : i - 1; t >= 0; --t)
+    {
+        if (m_triggers[t].tick_end() < start_tick)
+            break;                              /* no transition before it  */
 
-        midipulse trigstart = i->tick_start();
-        midipulse trigend = i->tick_end();
-        midipulse trigoffset = i->offset();
-        if (trigstart <= end_tick)
-        {
-            trigger_state = true;
-            trigger_tick = trigstart;
-            trigger_offset = trigoffset;
-        }
-        if (trigend <= end_tick)
-        {
-            trigger_state = false;
-            trigger_tick = trigend;
-            trigger_offset = trigoffset;
-        }
-        if (trigstart > end_tick || trigend > end_tick)
-            break;
+        if (m_triggers[t].at_trigger_transition(start_tick, end_tick))
+            m_parent.song_playback_block(false);
     }
+#endif
 
     /*
      * Had triggers in the slice, not equal to current state.  Therefore, it
@@ -364,6 +385,71 @@ triggers::adjust_offset (midipulse offset)
     return offset;
 }
 
+/**
+ *  Compares a tick to the end of a trigger, for std::upper_bound().
+ */
+
+static bool
+ends_after (midipulse tick, const trigger & t)
+{
+    return tick < t.tick_end();
+}
+
+/**
+ *  Finds the first trigger that ends after the given tick, with a binary
+ *  search.  Relies on the triggers being sorted and not overlapping, so that
+ *  their end ticks are sorted.
+ *
+ * \param tick
+ *      Provides the tick of interest.
+ *
+ * \return
+ *      Returns the index of the trigger, or count() if every trigger ends at
+ *      or before the tick.
+ */
+
+int
+triggers::first_ending_after (midipulse tick) const
+{
+    List::const_iterator i = std::upper_bound
+    (
+        m_triggers.begin(), m_triggers.end(), tick, ends_after
+    );
+    return int(i - m_triggers.begin());
+}
+
+/**
+ *  Finds the trigger that brackets the given tick.
+ *
+ * \param tick
+ *      Provides the tick of interest.
+ *
+ * \return
+ *      Returns the index of the trigger, or -1 if no trigger brackets the
+ *      tick.
+ */
+
+int
+triggers::find (midipulse tick) const
+{
+    int i = first_ending_after(tick - 1);
+    if (i < count() && m_triggers[i].tick_start() <= tick)
+        return i;
+
+    return -1;
+}
+
+/**
+ *  Sorts the triggers by start tick, keeping the order of triggers that
+ *  start at the same tick, as std::list::sort() did.
+ */
+
+void
+triggers::sort ()
+{
+    std::stable_sort(m_triggers.begin(), m_triggers.end());
+}
+
 /**
  *  Adds a trigger.
  *
@@ -423,15 +509,15 @@ triggers::add
     );
 #endif
 
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    List::iterator i = m_triggers.begin();
+    while (i != m_triggers.end())
     {
         midipulse tickstart = i->tick_start();
         midipulse tickend = i->tick_end();
         if (tickstart >= t.tick_start() && tickend <= t.tick_end())
         {
             unselect(*i);                       /* adjust selection count    */
-            m_triggers.erase(i);                /* inside the new one? erase */
-            i = m_triggers.begin();             /* THERE IS A BETTER WAY     */
+            i = m_triggers.erase(i);            /* inside the new one? erase */
             continue;
         }
         else if (tickend >= t.tick_end() && tickstart <= t.tick_end())
@@ -445,9 +531,13 @@ triggers::add
         {
             i->tick_end(t.tick_start() - 1);    /* last start inside new end? */
         }
+        ++i;
     }
-    m_triggers.push_front(t);
-    m_triggers.sort();                          /* hmmm, another sort       */
+    m_triggers.insert                           /* keep it sorted           */
+    (
+        std::upper_bound(m_triggers.begin(), m_triggers.end(), t), t
+    );
+    m_parent.wake_playback();                   /* it may be parked         */
 }
 
 /**
@@ -476,31 +566,30 @@ triggers::add
 bool
 triggers::intersect (midipulse position, midipulse & start, midipulse & ender)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    int i = find(position);
+    if (i >= 0)
     {
-        if (i->tick_start() <= position && position <= i->tick_end())
-        {
-            start = i->tick_start();    /* return by reference */
-            ender = i->tick_end();      /* ditto               */
-            return true;
-        }
+        start = m_triggers[i].tick_start();     /* return by reference */
+        ender = m_triggers[i].tick_end();       /* ditto               */
+        return true;
     }
     return false;
 }
 
 /**
+ *  Indicates if a trigger brackets the given position.
+ *
+ * \param position
+ *      The position to examine.
  *
+ * \return
+ *      Returns true if a trigger contains the position.
  */
 
 bool
 triggers::intersect (midipulse position)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
-    {
-        if (i->tick_start() <= position && position <= i->tick_end())
-            return true;
-    }
-    return false;
+    return find(position) >= 0;
 }
 
 /**
@@ -526,22 +615,19 @@ triggers::intersect (midipulse position)
 void
 triggers::grow (midipulse tickfrom, midipulse tickto, midipulse len)
 {
-    for (List::iterator it = m_triggers.begin(); it != m_triggers.end(); ++it)
+    int i = find(tickfrom);
+    if (i >= 0)
     {
-        midipulse start = it->tick_start();
-        midipulse ender = it->tick_end();
-        if (start <= tickfrom && tickfrom <= ender)
-        {
-            midipulse calcend = tickto + len - 1;
-            if (tickto < start)
-                start = tickto;
+        midipulse start = m_triggers[i].tick_start();
+        midipulse ender = m_triggers[i].tick_end();
+        midipulse calcend = tickto + len - 1;
+        if (tickto < start)
+            start = tickto;
 
-            if (calcend > ender)
-                ender = calcend;
+        if (calcend > ender)
+            ender = calcend;
 
-            add(start, ender - start + 1, it->offset());
-            break;
-        }
+        add(start, ender - start + 1, m_triggers[i].offset());
     }
 }
 
@@ -556,14 +642,11 @@ triggers::grow (midipulse tickfrom, midipulse tickto, midipulse len)
 void
 triggers::remove (midipulse tick)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    int i = find(tick);
+    if (i >= 0)
     {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
-        {
-            unselect(*i);                       /* adjust selection count    */
-            m_triggers.erase(i);
-            break;
-        }
+        unselect(m_triggers[i]);                /* adjust selection count    */
+        m_triggers.erase(m_triggers.begin() + i);
     }
 }
 
@@ -587,11 +670,12 @@ triggers::split (trigger & trig, midipulse splittick)
 {
     midipulse new_tick_end = trig.tick_end();
     midipulse new_tick_start = splittick;
-    trig.tick_end(splittick - 1);
+    midipulse offset = trig.offset();
+    trig.tick_end(splittick - 1);               /* add() may move the trig  */
 
     midipulse len = new_tick_end - new_tick_start;
     if (len > 1)
-        add(new_tick_start, len + 1, trig.offset());
+        add(new_tick_start, len + 1, offset);
 }
 
 /**
@@ -605,20 +689,18 @@ triggers::split (trigger & trig, midipulse splittick)
 void
 triggers::split (midipulse splittick)
 {
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    int i = find(splittick);
+    if (i >= 0)
     {
-        if (i->tick_start() <= splittick && splittick <= i->tick_end())
+        trigger & t = m_triggers[i];
+        if (rc().allow_snap_split())
         {
-            if (rc().allow_snap_split())
-            {
-                split(*i, splittick);               /* stazed feature   */
-            }
-            else
-            {
-                midipulse tick = (i->tick_end() - i->tick_start() + 1) / 2;
-                split(*i, i->tick_start() + tick);
-            }
-            break;
+            split(t, splittick);                    /* stazed feature   */
+        }
+        else
+        {
+            midipulse tick = (t.tick_end() - t.tick_start() + 1) / 2;
+            split(t, t.tick_start() + tick);
         }
     }
 }
@@ -630,18 +712,14 @@ triggers::split (midipulse splittick)
 void
 triggers::half_split (midipulse splittick)
 {
-    List::iterator i = m_triggers.begin();
-    while (i != m_triggers.end())
-	{
-        if ( i->tick_start() <= splittick && i->tick_end() >= splittick )
-        {
-            long tick = i->tick_end() - i->tick_start();
-            ++tick;
-            tick /= 2;
-            split(*i, i->tick_start() + tick);
-            break;
-        }
-        ++i;
+    int i = find(splittick);
+    if (i >= 0)
+    {
+        trigger & t = m_triggers[i];
+        long tick = t.tick_end() - t.tick_start();
+        ++tick;
+        tick /= 2;
+        split(t, t.tick_start() + tick);
     }
 }
 
@@ -652,16 +730,9 @@ triggers::half_split (midipulse splittick)
 void
 triggers::exact_split (midipulse splittick)
 {
-    List::iterator i = m_triggers.begin();
-    while (i != m_triggers.end())
-	{
-        if (i->tick_start() <= splittick && i->tick_end() >= splittick)
-        {
-            split(*i, splittick);
-            break;
-        }
-        ++i;
-    }
+    int i = find(splittick);
+    if (i >= 0)
+        split(m_triggers[i], splittick);
 }
 
 /**
@@ -772,6 +843,8 @@ triggers::copy (midipulse starttick, midipulse distance)
     midipulse from_start_tick = starttick + distance;
     midipulse from_end_tick = from_start_tick + distance - 1;
     move(starttick, distance, true);
+
+    List copies;                                /* do not grow while looping */
     for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
         midipulse tickstart = i->tick_start();
@@ -791,10 +864,12 @@ triggers::copy (midipulse starttick, midipulse distance)
             if (t.offset() < 0)
                 t.increment_offset(m_length);
 
-            m_triggers.push_front(t);
+            copies.push_back(t);
         }
     }
-    m_triggers.sort();
+    m_triggers.insert(m_triggers.end(), copies.begin(), copies.end());
+    sort();
+    m_parent.wake_playback();
 }
 
 /**
@@ -817,36 +892,54 @@ void
 triggers::move (midipulse starttick, midipulse distance, bool direction)
 {
     midipulse endtick = starttick + distance;
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+
+    /*
+     * Indexed, since split() adds a trigger, which can move the others in
+     * the vector.  The added trigger always lands after index n.
+     */
+
+    for (size_t n = 0; n < m_triggers.size(); ++n)
     {
-        if (i->tick_start() < starttick && starttick < i->tick_end())
+        if
+        (
+            m_triggers[n].tick_start() < starttick &&
+            starttick < m_triggers[n].tick_end()
+        )
         {
             if (direction)                              /* forward */
-                split(*i, starttick);
+                split(m_triggers[n], starttick);
             else                                        /* back    */
-                split(*i, endtick);
+                split(m_triggers[n], endtick);
         }
-        if (i->tick_start() < starttick && starttick < i->tick_end())
+        if
+        (
+            m_triggers[n].tick_start() < starttick &&
+            starttick < m_triggers[n].tick_end()
+        )
         {
             if (direction)                              /* forward */
-                split(*i, starttick);
+                split(m_triggers[n], starttick);
             else                                        /* back    */
-                i->tick_end(starttick - 1);
+                m_triggers[n].tick_end(starttick - 1);
         }
         if
         (
-            i->tick_start() >= starttick &&
-            i->tick_end() <= endtick && ! direction
+            m_triggers[n].tick_start() >= starttick &&
+            m_triggers[n].tick_end() <= endtick && ! direction
         )
         {
-            unselect(*i);                       /* adjust selection count    */
-            m_triggers.erase(i);
-            i = m_triggers.begin();                     /* A BETTER WAY? */
+            unselect(m_triggers[n]);            /* adjust selection count    */
+            m_triggers.erase(m_triggers.begin() + n);
+            n = 0;                                      /* A BETTER WAY? */
+            if (m_triggers.empty())
+                break;
         }
-        if (i->tick_start() < endtick && endtick < i->tick_end())
+
+        trigger & t = m_triggers[n];
+        if (t.tick_start() < endtick && endtick < t.tick_end())
         {
             if (! direction)                            /* forward */
-                i->tick_start(endtick);
+                t.tick_start(endtick);
         }
     }
     for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
@@ -877,6 +970,7 @@ triggers::move (midipulse starttick, midipulse distance, bool direction)
         }
         i->offset(adjust_offset(i->offset()));
     }
+    m_parent.wake_playback();
 }
 
 /**
@@ -1027,18 +1121,77 @@ triggers::move_selected (midipulse tick, bool fixoffset, grow_edit_t which)
         else
             mintick = i->tick_end() + 1;
     }
+    m_parent.wake_playback();
     return result;
 }
 
 /**
+ *  Offsets all selected triggers by the same amount.  Used by box-selection
+ *  movement in the song editor.  Like move_selected(), the movement is
+ *  clamped so that the triggers stay sorted and do not overlap:  a moved
+ *  trigger stops at its nearest unselected neighbour (the selected ones
+ *  move with it), and a grown or shrunk trigger stops at its neighbour or
+ *  at the minimum length.  The same clamped amount is applied to every
+ *  selected trigger, so that the selection keeps its shape.
  *
+ * \param tick
+ *      The amount of the offset, which can be negative.
+ *
+ * \param editmode
+ *      Selects which movement will be done, as in move_selected().
  */
 
 void
 triggers::offset_selected (midipulse tick, grow_edit_t editmode)
 {
-    List::iterator i = m_triggers.begin();
-    while (i != m_triggers.end())
+    midipulse minlength = m_ppqn / 8;
+    midipulse lowdelta = tick;
+    midipulse highdelta = tick;
+    List::iterator prev = m_triggers.end();
+    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    {
+        if (i->selected())
+        {
+            List::iterator next = i + 1;
+            bool hasprev = prev != m_triggers.end();
+            bool hasnext = next != m_triggers.end();
+            midipulse lo = -i->tick_start();
+            midipulse hi = tick;
+            if (editmode == GROW_MOVE)
+            {
+                if (hasprev && ! prev->selected())
+                    lo = prev->tick_end() + 1 - i->tick_start();
+
+                if (hasnext && ! next->selected())
+                    hi = next->tick_start() - 1 - i->tick_end();
+            }
+            else if (editmode == GROW_START)
+            {
+                if (hasprev)
+                    lo = prev->tick_end() + 1 - i->tick_start();
+
+                hi = i->tick_end() - minlength - i->tick_start();
+            }
+            else if (editmode == GROW_END)
+            {
+                lo = i->tick_start() + minlength - i->tick_end();
+                if (hasnext)
+                    hi = next->tick_start() - 1 - i->tick_end();
+            }
+            if (lo > lowdelta)
+                lowdelta = lo;
+
+            if (hi < highdelta)
+                highdelta = hi;
+        }
+        prev = i;
+    }
+    if (tick > 0 && tick > highdelta)
+        tick = highdelta > 0 ? highdelta : 0 ;
+    else if (tick < 0 && tick < lowdelta)
+        tick = lowdelta < 0 ? lowdelta : 0 ;
+
+    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
         if (i->selected())
         {
@@ -1051,8 +1204,8 @@ triggers::offset_selected (midipulse tick, grow_edit_t editmode)
             if (editmode == GROW_MOVE)
                 i->increment_offset(tick);
         }
-        ++i;
     }
+    m_parent.wake_playback();
 }
 
 /**
@@ -1087,14 +1240,33 @@ triggers::get_maximum () const
 bool
 triggers::get_state (midipulse tick) const
 {
-    bool result = false;
-    for (List::const_iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    return find(tick) >= 0;
+}
+
+/**
+ *  Finds the next tick, after the given tick, at which a trigger starts or
+ *  ends, and so at which play() might turn the sequence on or off.  Used by
+ *  the event-driven output scheduler.  The first trigger that ends at or
+ *  after the tick is found by a binary search.
+ *
+ * \param tick
+ *      Provides the tick of interest.
+ *
+ * \return
+ *      Returns the next start tick, or the tick following the end of the
+ *      trigger that brackets the given tick.  If there is none,
+ *      SEQ64_NULL_MIDIPULSE is returned.
+ */
+
+midipulse
+triggers::next_change (midipulse tick) const
+{
+    midipulse result = SEQ64_NULL_MIDIPULSE;
+    int i = first_ending_after(tick - 1);
+    if (i < count())
     {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
-        {
-            result = true;
-            break;
-        }
+        const trigger & t = m_triggers[i];
+        result = t.tick_start() > tick ? t.tick_start() : t.tick_end() + 1 ;
     }
     return result;
 }
@@ -1273,7 +1445,7 @@ triggers::paste (midipulse paste_tick)
  *      on the values returned through the return parameters.
  *
  * \sideeffect
- *      The value of the m_iterator_draw_trigger member will be altered by this
+ *      The value of the m_draw_trigger member will be altered by this
  *      call, unless pointing to the end of the triggerlist, or if there are
  *      no triggers.
  */
@@ -1287,13 +1459,14 @@ triggers::next
     midipulse & offset
 )
 {
-    while (m_iterator_draw_trigger != m_triggers.end())
+    if (m_draw_trigger < count())
     {
-        tick_on  = m_iterator_draw_trigger->tick_start();
-        selected = m_iterator_draw_trigger->selected();
-        offset = m_iterator_draw_trigger->offset();
-        tick_off = m_iterator_draw_trigger->tick_end();
-        ++m_iterator_draw_trigger;
+        const trigger & t = m_triggers[m_draw_trigger];
+        tick_on  = t.tick_start();
+        selected = t.selected();
+        offset = t.offset();
+        tick_off = t.tick_end();
+        ++m_draw_trigger;
         return true;
     }
     return false;
@@ -1311,10 +1484,10 @@ trigger
 triggers::next_trigger ()
 {
     trigger result;
-    while (m_iterator_draw_trigger != m_triggers.end())
+    while (m_draw_trigger < count())
     {
-        result = *m_iterator_draw_trigger;
-        ++m_iterator_draw_trigger;
+        result = m_triggers[m_draw_trigger];
+        ++m_draw_trigger;
     }
     return result;
 }
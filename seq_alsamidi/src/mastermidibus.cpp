@@ -354,7 +354,7 @@ mastermidibus::api_init (int ppqn, midibpm bpm)
      */
 
     m_num_poll_descriptors = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
-    m_poll_descriptors = new pollfd[m_num_poll_descriptors];
+    m_poll_descriptors = new pollfd[m_num_poll_descriptors + 1]; /* + wakeup */
     snd_seq_poll_descriptors
     (
         m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
@@ -492,7 +492,11 @@ mastermidibus::api_flush ()
 }
 
 /**
- *  Initiate a poll() on the existing poll descriptors.  The m_
+ *  Initiate a poll() on the existing poll descriptors.  The wakeup of the
+ *  input thread is polled in the extra slot at the end of the descriptors,
+ *  so that the perform object can end the wait when it stops the input
+ *  thread.  The poll itself is the wait, so there is no longer a millisecond
+ *  of sleep when no input is pending.
  *
  *  No locking needed?
  *
@@ -506,10 +510,24 @@ mastermidibus::api_flush ()
 int
 mastermidibus::api_poll_for_midi ()
 {
-    int result = poll(m_poll_descriptors, m_num_poll_descriptors, 1000);
-    if (result == 0)
-        millisleep(1);
+    int count = m_num_poll_descriptors;
+    if (not_nullptr(m_poll_descriptors) && m_input_wakeup.valid())
+    {
+        struct pollfd & pfd = m_poll_descriptors[count++];
+        pfd.fd = m_input_wakeup.fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+    }
 
+    int result = poll(m_poll_descriptors, count, 1000);
+    if (result > 0 && count > m_num_poll_descriptors)
+    {
+        if (m_poll_descriptors[m_num_poll_descriptors].revents != 0)
+        {
+            m_input_wakeup.drain();
+            --result;
+        }
+    }
     return result;
 }
 
@@ -449,6 +449,35 @@ midibus::api_deinit_in ()
 
 #define SEQ64_MIDI_EVENT_SIZE_MAX   10
 
+/**
+ *  Encodes a native event into an ALSA MIDI sequencer event, for api_play()
+ *  and api_play_at().
+ *
+ * \param e24
+ *      The event to be encoded.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param [out] ev
+ *      The ALSA event, which is cleared and then filled in.
+ */
+
+static void
+encode_play_event (event * e24, midibyte channel, snd_seq_event_t & ev)
+{
+    midibyte buffer[4];                             /* temp for MIDI data   */
+    buffer[0] = e24->get_status();                  /* fill buffer          */
+    buffer[0] += (channel & 0x0F);
+    e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
+
+    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
+    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
+    snd_seq_ev_clear(&ev);                          /* clear event          */
+    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
+    snd_midi_event_free(midi_ev);                   /* free the parser      */
+}
+
 /**
  *  This play() function takes a native event, encodes it to an ALSA MIDI
  *  sequencer event, sets the broadcasting to the subscribers, sets the
@@ -468,21 +497,46 @@ midibus::api_deinit_in ()
 void
 midibus::api_play (event * e24, midibyte channel)
 {
-    midibyte buffer[4];                             /* temp for MIDI data   */
-    buffer[0] = e24->get_status();                  /* fill buffer          */
-    buffer[0] += (channel & 0x0F);
-    e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
+    snd_seq_event_t ev;
+    encode_play_event(e24, channel, ev);
+    snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
+    snd_seq_ev_set_subs(&ev);
+    snd_seq_ev_set_direct(&ev);                     /* it is immediate      */
+    snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
+}
 
-    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
-    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
+/**
+ *  Like api_play(), but, instead of sending the event directly, schedules
+ *  it on the ALSA queue, at a real-time stamp relative to the current queue
+ *  time.  The ALSA sequencer then delivers it at that time, no matter when
+ *  the output thread woke up.  The queue is started by
+ *  mastermidibus::api_start(), and its pending events are delivered by
+ *  mastermidibus::api_stop() before it is stopped.
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to deliver the event.
+ */
 
+void
+midibus::api_play_at (event * e24, midibyte channel, long delay_us)
+{
     snd_seq_event_t ev;
-    snd_seq_ev_clear(&ev);                          /* clear event          */
-    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
-    snd_midi_event_free(midi_ev);                   /* free the parser      */
+    encode_play_event(e24, channel, ev);
+
+    snd_seq_real_time_t rt;
+    rt.tv_sec = unsigned(delay_us / 1000000);
+    rt.tv_nsec = unsigned(delay_us % 1000000) * 1000;
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
     snd_seq_ev_set_subs(&ev);
-    snd_seq_ev_set_direct(&ev);                     /* it is immediate      */
+    snd_seq_ev_schedule_real(&ev, queue_number(), 1, &rt);  /* 1: relative  */
     snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
 }
 
@@ -713,6 +767,39 @@ midibus::api_clock (midipulse tick)
     snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
 }
 
+/**
+ *  Like api_clock(), but schedules the pulse on the ALSA queue, at a
+ *  real-time stamp relative to the current queue time, as api_play_at()
+ *  does for the events.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      Provides the tick of the pulse, unused in the ALSA implementation.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to deliver the pulse.
+ */
+
+void
+midibus::api_clock_at (midipulse /*tick*/, long delay_us)
+{
+    snd_seq_event_t ev;
+    snd_seq_ev_clear(&ev);                          /* clear event          */
+    ev.type = SND_SEQ_EVENT_CLOCK;
+    ev.tag = 127;
+    snd_seq_ev_set_fixed(&ev);
+    snd_seq_ev_set_priority(&ev, 1);
+
+    snd_seq_real_time_t rt;
+    rt.tv_sec = unsigned(delay_us / 1000000);
+    rt.tv_nsec = unsigned(delay_us % 1000000) * 1000;
+    snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
+    snd_seq_ev_set_subs(&ev);
+    snd_seq_ev_schedule_real(&ev, queue_number(), 1, &rt);  /* 1: relative  */
+    snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
+}
+
 #if REMOVE_QUEUED_ON_EVENTS_CODE
 
 /**
@@ -1354,7 +1354,7 @@ mainwnd::timer_callback ()
         }
         else
         {
-            std::string t = pulses_to_timestring(tick, bpm, ppqn, false);
+            std::string t = perf().pulses_to_timestring(tick, false);
             m_tick_time->set_text(t);
         }
     }
@@ -89,6 +89,7 @@ protected:
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, long delay_us);
 
     /*
      * Functions not implemented in PortMIDI.  For example, the "sub"
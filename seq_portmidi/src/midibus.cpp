@@ -44,6 +44,7 @@
 #include "event.hpp"                    /* seq64::event and macros          */
 #include "midibus_pm.hpp"               /* seq64::midibus for PortMIDI      */
 #include "settings.hpp"                 /* seq64::rc_settings               */
+#include "porttime.h"                   /* Pt_Time()                        */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -134,7 +135,18 @@ midibus::api_poll_for_midi ()
 }
 
 /**
- *  Initializes the MIDI output port, for PortMidi.
+ *  The PortMidi output latency, in milliseconds, used when lookahead
+ *  rendering is enabled.  A non-zero latency makes PortMidi honor the
+ *  time-stamps of the output events; a time-stamp of 0, as used by
+ *  api_play(), is then in the past, and the event is sent at once.
+ */
+
+static const int32_t s_lookahead_latency_ms = 1;
+
+/**
+ *  Initializes the MIDI output port, for PortMidi.  If lookahead rendering
+ *  is enabled, the port is opened with a small latency, so that
+ *  api_play_at() can time-stamp its events.
  *
  * \return
  *      Returns true if the output port was successfully opened.
@@ -143,9 +155,10 @@ midibus::api_poll_for_midi ()
 bool
 midibus::api_init_out ()
 {
+    int32_t latency = rc().lookahead_ms() > 0 ? s_lookahead_latency_ms : 0 ;
     PmError err = Pm_OpenOutput
     (
-        &m_pms, queue_number(), NULL, 100, NULL, NULL, 0
+        &m_pms, queue_number(), NULL, 100, NULL, NULL, latency
     );
     bool result = err == pmNoError;
     if (! result)
@@ -212,6 +225,38 @@ midibus::api_play (event * e24, midibyte channel)
     /* PmError err = */ Pm_Write(m_pms, &event, 1);
 }
 
+/**
+ *  Like api_play(), but time-stamps the event with the PortTime clock, so
+ *  that PortMidi sends it the given time from now.  The output latency set
+ *  in api_init_out() is subtracted, since PortMidi adds it back.  PortMidi
+ *  has millisecond resolution.
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to send the event.
+ */
+
+void
+midibus::api_play_at (event * e24, midibyte channel, long delay_us)
+{
+    midibyte buffer[4];                /* temp for midi data */
+    buffer[0] = e24->get_status();
+    buffer[0] += (channel & 0x0F);
+    e24->get_data(buffer[1], buffer[2]);
+
+    PmEvent event;
+    event.timestamp = Pt_Time() + PmTimestamp((delay_us + 500) / 1000) -
+        s_lookahead_latency_ms;
+
+    event.message = Pm_Message(buffer[0], buffer[1], buffer[2]);
+    /* PmError err = */ Pm_Write(m_pms, &event, 1);
+}
+
 /**
  *  Continue from the given tick.  This function implements only the
  *  PortMidi-specific code.
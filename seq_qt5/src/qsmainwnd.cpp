@@ -962,7 +962,7 @@ qsmainwnd::refresh ()
         }
         else
         {
-            std::string t = pulses_to_timestring(tick, bpm, ppqn, false);
+            std::string t = perf().pulses_to_timestring(tick, false);
             ui->label_HMS->setText(t.c_str());
         }
     }
@@ -66,10 +66,10 @@ private:
     rtmidi_info m_midi_master;
 
     /**
-     *  Indicates we are running with JACK MIDI enabled, and need to
-     *  use each port's ability to poll for and get MIDI events, rather
-     *  than use ALSA's method of calling functions from the "MIDI master"
-     *  object.
+     *  Indicates we are running with JACK MIDI (or the null API) enabled,
+     *  and need to use each port's ability to poll for and get MIDI events,
+     *  rather than use ALSA's method of calling functions from the "MIDI
+     *  master" object.
      */
 
     bool m_use_jack_polling;
@@ -120,6 +120,16 @@ protected:
         m_midi_master.api_port_start(masterbus, bus, port);
     }
 
+    /**
+     *  Lets the API apply the thru routing table, if it can.
+     */
+
+    virtual bool api_routes_thru () const
+    {
+        const midi_info * info = m_midi_master.get_api_info();
+        return not_nullptr(info) && info->api_routes_thru();
+    }
+
 private:
 
     void port_list (const std::string & tag);
@@ -163,12 +163,14 @@ protected:
      */
 
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, long delay_us);
     virtual void api_sysex (event * e24);
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
     virtual void api_start ();
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
+    virtual void api_clock_at (midipulse tick, long delay_us);
     virtual void api_set_ppqn (int ppqn);
     virtual void api_set_beats_per_minute (midibpm bpm);
 
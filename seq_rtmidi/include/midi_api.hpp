@@ -137,12 +137,38 @@ public:
     virtual bool api_deinit_in () = 0;
     virtual bool api_get_midi_event (event *) = 0;
     virtual void api_play (event * e24, midibyte channel) = 0;
+
+    /**
+     *  Plays an event the given number of microseconds from now.  By
+     *  default, the event is sent immediately; midi_alsa overrides this
+     *  function to schedule the event on its queue.
+     */
+
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, long /* delay_us */
+    )
+    {
+        api_play(e24, channel);
+    }
+
     virtual void api_sysex (event * e24) = 0;
     virtual void api_continue_from (midipulse tick, midipulse beats) = 0;
     virtual void api_start () = 0;
     virtual void api_stop () = 0;
     virtual void api_flush () = 0;
     virtual void api_clock (midipulse tick) = 0;
+
+    /**
+     *  Sends a MIDI clock pulse the given number of microseconds from now.
+     *  By default, the pulse is sent immediately.
+     */
+
+    virtual void api_clock_at (midipulse tick, long /* delay_us */)
+    {
+        api_clock(tick);
+    }
+
     virtual void api_set_ppqn (int ppqn) = 0;
     virtual void api_set_beats_per_minute (midibpm bpm) = 0;
 
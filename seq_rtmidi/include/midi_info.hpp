@@ -49,7 +49,9 @@ namespace seq64
 {
     class event;
     class mastermidibus;
+    class midi_wakeup;
     class midibus;
+    class thru_map;
 
 /**
  *  A class for holding port information.
@@ -288,6 +290,22 @@ private:
 
     midibpm m_bpm;
 
+    /**
+     *  The wakeup of the input thread, owned by the mastermidibus.  The input
+     *  ports that can post it when they queue input get it from here.  Null
+     *  until the mastermidibus sets it.
+     */
+
+    midi_wakeup * m_input_wakeup;
+
+    /**
+     *  The MIDI-thru routing table, owned by the mastermidibus.  An API that
+     *  can echo its input as soon as it arrives reads it, and returns true
+     *  from api_routes_thru().  Null until the mastermidibus sets it.
+     */
+
+    const thru_map * m_thru_routes;
+
 protected:
 
     /**
@@ -513,6 +531,52 @@ public:
         return m_global_queue;
     }
 
+    /**
+     * \getter m_input_wakeup
+     */
+
+    midi_wakeup * input_wakeup ()
+    {
+        return m_input_wakeup;
+    }
+
+    /**
+     * \setter m_input_wakeup
+     */
+
+    void input_wakeup (midi_wakeup * wp)
+    {
+        m_input_wakeup = wp;
+    }
+
+    /**
+     * \getter m_thru_routes
+     */
+
+    const thru_map * thru_routes () const
+    {
+        return m_thru_routes;
+    }
+
+    /**
+     * \setter m_thru_routes
+     */
+
+    void thru_routes (const thru_map * tm)
+    {
+        m_thru_routes = tm;
+    }
+
+    /**
+     *  Indicates if this API applies the thru routing table itself.  See
+     *  mastermidibase::api_routes_thru().
+     */
+
+    virtual bool api_routes_thru () const
+    {
+        return false;
+    }
+
     /**
      *  A basic error reporting function for midi_info classes.
      */
@@ -101,6 +101,26 @@ public:
         return m_jack_data;
     }
 
+    /**
+     * \getter m_jack_data.m_jack_late_count
+     *      The number of output messages sent after their target frame.
+     */
+
+    unsigned long late_events () const
+    {
+        return m_jack_data.m_jack_late_count;
+    }
+
+    /**
+     * \getter m_jack_data.m_jack_drop_count
+     *      The number of output messages dropped by the process callback.
+     */
+
+    unsigned long dropped_events () const
+    {
+        return m_jack_data.m_jack_drop_count;
+    }
+
     /**
      * \getter m_remote_port_name
      */
@@ -193,12 +213,14 @@ protected:
      */
 
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, long delay_us);
     virtual void api_sysex (event * e24);
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
     virtual void api_start ();
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
+    virtual void api_clock_at (midipulse tick, long delay_us);
     virtual void api_set_ppqn (int ppqn);
     virtual void api_set_beats_per_minute (midibpm bpm);
     virtual std::string api_get_port_name ();
@@ -206,7 +228,8 @@ protected:
 private:
 
     void send_byte (midibyte evbyte);
-    bool send_message (const midi_message & message);
+    jack_nframes_t frame_stamp (long delay_us);
+    bool send_message (const midi_message & message, jack_nframes_t frame);
     bool set_virtual_name (int portid, const std::string & portname);
 
 };          // class midi_jack
@@ -19,9 +19,35 @@
 
 #ifdef SEQ64_JACK_SUPPORT
 
+#include <atomic>                       /* std::atomic<>                */
+
 #include <jack/jack.h>
 #include <jack/ringbuffer.h>
 
+/**
+ *  The largest message whose bytes are kept in its entry of the pending list
+ *  of an output port.  Channel and realtime messages are at most 3 bytes.
+ *  The bytes of a longer message (SysEx) are staged in m_jack_staged.
+ */
+
+#define SEQ64_JACK_EVENT_BYTES_MAX      4
+
+/**
+ *  The number of bytes of the longer messages that can wait in the pending
+ *  list of an output port.  Room for eight SysEx messages of the largest
+ *  size held by a midi_message.
+ */
+
+#define SEQ64_JACK_STAGED_BYTES      8192
+
+/**
+ *  The number of messages that can wait in the pending list of an output
+ *  port.  When it is full, the rest stay in the ring-buffer until the next
+ *  cycle.
+ */
+
+#define SEQ64_JACK_PENDING_MAX        512
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -29,6 +55,32 @@
 namespace seq64
 {
 
+/**
+ *  Precedes each message in the output ring-buffer m_jack_buffsize (the
+ *  message bytes themselves go into m_jack_buffmessage).  The frame is an
+ *  absolute JACK frame time, as returned by jack_frame_time(), at which the
+ *  message is to be sent.
+ */
+
+struct midi_jack_header
+{
+    jack_nframes_t mjh_frame;   /**< The target JACK frame time.            */
+    int mjh_size;               /**< The number of bytes in the message.    */
+};
+
+/**
+ *  Holds an output message read from the ring-buffer, until the JACK cycle
+ *  that contains its target frame.
+ */
+
+struct midi_jack_event
+{
+    jack_nframes_t mje_frame;   /**< The target JACK frame time.            */
+    int mje_size;               /**< The number of bytes in the message.    */
+    int mje_staged;             /**< Index of longer bytes in m_jack_staged.*/
+    midibyte mje_data[SEQ64_JACK_EVENT_BYTES_MAX];  /**< The message bytes. */
+};
+
 /**
  *  Contains the JACK MIDI API data as a kind of scratchpad for this object.
  *  This guy needs a constructor taking parameters for an rtmidi_in_data
@@ -57,8 +109,9 @@ struct midi_jack_data
     jack_port_t * m_jack_port;
 
     /**
-     *  Holds the size of data for communicating between the client
-     *  ring-buffer and the JACK port's internal buffer.
+     *  Holds the size and target frame of the data for communicating between
+     *  the client ring-buffer and the JACK port's internal buffer, as one
+     *  midi_jack_header per message.
      */
 
     jack_ringbuffer_t * m_jack_buffsize;
@@ -84,6 +137,58 @@ struct midi_jack_data
 
     rtmidi_in_data * m_jack_rtmidiin;
 
+    /**
+     *  The output messages read from the ring-buffer whose target frames
+     *  are not yet reached, sorted by target frame.  Used only by the JACK
+     *  process callback, so it needs no locking, and it is preallocated.
+     */
+
+    midi_jack_event m_jack_pending[SEQ64_JACK_PENDING_MAX];
+
+    /**
+     *  The number of messages in m_jack_pending.
+     */
+
+    int m_jack_pending_count;
+
+    /**
+     *  Holds the bytes of the pending messages longer than
+     *  SEQ64_JACK_EVENT_BYTES_MAX, one after the other.  The space is
+     *  reclaimed when none of them is pending any more.  If a message does
+     *  not fit, it and the messages after it wait in the ring-buffer.
+     */
+
+    midibyte m_jack_staged[SEQ64_JACK_STAGED_BYTES];
+
+    /**
+     *  The number of bytes used in m_jack_staged.
+     */
+
+    int m_jack_staged_used;
+
+    /**
+     *  The number of pending messages whose bytes are in m_jack_staged.
+     */
+
+    int m_jack_staged_count;
+
+    /**
+     *  The number of output messages whose target frame had already passed
+     *  when their JACK cycle came.  They are sent at the start of the cycle.
+     *  Written only by the JACK process callback.
+     */
+
+    std::atomic<unsigned long> m_jack_late_count;
+
+    /**
+     *  The number of output messages that the JACK process callback had to
+     *  drop, because jack_midi_event_reserve() failed, or because they are
+     *  too long to be staged.  Written only by the process callback, which
+     *  cannot report errors itself; the port reports it when destroyed.
+     */
+
+    std::atomic<unsigned long> m_jack_drop_count;
+
     /**
      * \ctor midi_jack_data
      */
@@ -94,7 +199,14 @@ struct midi_jack_data
         m_jack_buffsize     (nullptr),
         m_jack_buffmessage  (nullptr),
         m_jack_lasttime     (0),
-        m_jack_rtmidiin     (nullptr)
+        m_jack_rtmidiin     (nullptr),
+        m_jack_pending      (),
+        m_jack_pending_count(0),
+        m_jack_staged       (),
+        m_jack_staged_used  (0),
+        m_jack_staged_count (0),
+        m_jack_late_count   (0),
+        m_jack_drop_count   (0)
     {
         // Empty body
     }
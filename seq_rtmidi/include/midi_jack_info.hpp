@@ -104,6 +104,17 @@ public:
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port);
     virtual void api_flush ();
 
+    /**
+     *  In single-client mode, all ports are processed in one callback,
+     *  jack_process_io(), which echoes the input along the thru routing
+     *  table in the same cycle.  The multi-client mode cannot.
+     */
+
+    virtual bool api_routes_thru () const
+    {
+        return not_nullptr(m_jack_client);
+    }
+
 private:
 
     virtual int get_all_port_info ();
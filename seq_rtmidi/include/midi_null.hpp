@@ -0,0 +1,125 @@
+#ifndef SEQ64_MIDI_NULL_HPP
+#define SEQ64_MIDI_NULL_HPP
+
+/**
+ * \file          midi_null.hpp
+ *
+ *    A class for MIDI input/output that needs no sound server.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       See the rtexmidi.lic file.  Too big for a header file.
+ *
+ *  The output ports capture what is played to them, and the input port
+ *  presents the events of a script.  See the midi_null_info.hpp module.
+ */
+
+#include <string>
+
+#include "midi_api.hpp"
+#include "midi_null_info.hpp"           /* seq64::midi_null_info            */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class midibus;
+
+/**
+ *  This class implements the null version of the midi_alsa object.
+ */
+
+class midi_null : public midi_api
+{
+
+protected:
+
+    /**
+     *  The null master, which holds the capture buffer and the input script
+     *  shared by all of the null ports.
+     */
+
+    midi_null_info & m_null_info;
+
+public:
+
+    midi_null (midibus & parentbus, midi_info & masterinfo);
+    virtual ~midi_null ();
+
+    virtual bool api_init_out ();
+    virtual bool api_init_in ();
+    virtual bool api_init_out_sub ();
+    virtual bool api_init_in_sub ();
+    virtual bool api_deinit_in ();
+
+    /**
+     *  The null output ports have no input.
+     */
+
+    virtual bool api_get_midi_event (event *)
+    {
+        return false;
+    }
+
+    virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, long delay_us);
+    virtual void api_sysex (event * e24);
+    virtual void api_flush ();
+    virtual void api_continue_from (midipulse tick, midipulse beats);
+    virtual void api_start ();
+    virtual void api_stop ();
+    virtual void api_clock (midipulse tick);
+    virtual void api_clock_at (midipulse tick, long delay_us);
+    virtual void api_set_ppqn (int ppqn);
+    virtual void api_set_beats_per_minute (midibpm bpm);
+
+private:
+
+    void send_byte (midibyte evbyte);
+
+};          // class midi_null
+
+/**
+ *  The class for handling null MIDI input.
+ */
+
+class midi_in_null: public midi_null
+{
+
+public:
+
+    midi_in_null (midibus & parentbus, midi_info & masterinfo);
+    virtual ~midi_in_null ();
+
+    virtual int api_poll_for_midi ();
+    virtual bool api_get_midi_event (event *);
+
+};          // class midi_in_null
+
+/**
+ *  The null MIDI output API class.
+ */
+
+class midi_out_null: public midi_null
+{
+
+public:
+
+    midi_out_null (midibus & parentbus, midi_info & masterinfo);
+    virtual ~midi_out_null ();
+
+};          // class midi_out_null
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDI_NULL_HPP
+
+/*
+ * midi_null.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,168 @@
+#ifndef SEQ64_MIDI_NULL_INFO_HPP
+#define SEQ64_MIDI_NULL_INFO_HPP
+
+/**
+ * \file          midi_null_info.hpp
+ *
+ *    A class for the ports, the capture buffer, and the input script of the
+ *    null MIDI API.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       See the rtexmidi.lic file.  Too big for a header file.
+ *
+ *  The null API needs no sound server, so that the engine can be run,
+ *  benchmarked, and regression-tested on a headless machine.  It is selected
+ *  at run time with the "-o null=n" option, in place of ALSA or JACK.
+ *
+ *      -   It reports n output ports and one input port, all belonging to a
+ *          "null" client.
+ *      -   Everything played to an output port is stamped with the time, in
+ *          microseconds since the ports were activated, and stored in a
+ *          capture buffer allocated up front.  At exit, the capture is
+ *          written to the file given by "-o capture=filename", one event per
+ *          line:
+ *
+ *              time_us buss status data0 data1
+ *
+ *          The time and buss are decimal, the bytes are two-digit hex.
+ *
+ *      -   The file given by "-o inject=filename" is read at start-up.  Each
+ *          of its lines holds an event to present on the input port at the
+ *          given time, in the same microsecond base:
+ *
+ *              time_us status data0 [data1]
+ *
+ *          The bytes are hex.  Blank lines and lines starting with '#' are
+ *          ignored.  The events must be in time order.
+ */
+
+#include <atomic>                       /* std::atomic<unsigned>        */
+#include <vector>                       /* std::vector<>                */
+
+#include "midi_info.hpp"                /* seq64::midi_port_info etc.   */
+#include "mastermidibus_rm.hpp"
+#include "midibus.hpp"                  /* seq64::midibus               */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class mastermidibus;
+
+/**
+ *  The class for handling the null MIDI ports.
+ */
+
+class midi_null_info : public midi_info
+{
+
+public:
+
+    /**
+     *  Holds a captured output event, or an event of the input script.
+     */
+
+    struct record
+    {
+        long nr_time_us;                /**< Microseconds since activation. */
+        int nr_bus;                     /**< The output buss, 0 for input.  */
+        midibyte nr_status;             /**< The status, with the channel.  */
+        midibyte nr_d0;                 /**< The first data byte, if any.   */
+        midibyte nr_d1;                 /**< The second data byte, if any.  */
+    };
+
+private:
+
+    /**
+     *  The capture buffer, of SEQ64_NULL_CAPTURE_SIZE records, allocated in
+     *  the constructor.  It is never resized, so that capturing is
+     *  realtime-safe.
+     */
+
+    std::vector<record> m_capture;
+
+    /**
+     *  The number of events played.  Events past the end of m_capture are
+     *  counted, but not captured.  Atomic, so that the output thread and a
+     *  thread that sends clocks or panics can both capture.
+     */
+
+    std::atomic<unsigned> m_capture_count;
+
+    /**
+     *  The events of the input script, in time order.  Read by the
+     *  constructor, and never resized afterward.
+     */
+
+    std::vector<record> m_script;
+
+    /**
+     *  The index of the next event of m_script to present on the input port.
+     *  Used only by the input thread.
+     */
+
+    unsigned m_script_next;
+
+    /**
+     *  The monotonic time of activation, in microseconds, from which the
+     *  captured and injected events are timed.
+     */
+
+    long m_start_us;
+
+public:
+
+    midi_null_info
+    (
+        const std::string & appname,
+        int ppqn    = SEQ64_DEFAULT_PPQN,       /* 192    */
+        midibpm bpm = SEQ64_DEFAULT_BPM         /* 120.0  */
+    );
+    virtual ~midi_null_info ();
+
+    virtual bool api_get_midi_event (event * inev);
+    virtual bool api_connect ();
+    virtual int api_poll_for_midi ();
+    virtual void api_flush ();
+
+    long elapsed_us () const;
+    void capture
+    (
+        int bus, midibyte status, midibyte d0, midibyte d1, long delay_us = 0
+    );
+    int script_pending ();
+    bool script_event (event & ev);
+    bool write_capture (const std::string & filename) const;
+
+    /**
+     * \getter m_capture_count
+     *      The number of events played, captured or not.
+     */
+
+    unsigned capture_count () const
+    {
+        return m_capture_count.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    virtual int get_all_port_info ();
+
+    bool read_script (const std::string & filename);
+
+};          // midi_null_info
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDI_NULL_INFO_HPP
+
+/*
+ * midi_null_info.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
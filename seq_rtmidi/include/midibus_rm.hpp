@@ -112,7 +112,9 @@ protected:
     virtual void api_start ();
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
+    virtual void api_clock_at (midipulse tick, long delay_us);
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, long delay_us);
 
 };          // class midibus (rtmidi version)
 
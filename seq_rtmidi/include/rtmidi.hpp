@@ -78,6 +78,11 @@ public:
         get_api()->api_play(e24, channel);
     }
 
+    virtual void api_play_at (event * e24, midibyte channel, long delay_us)
+    {
+        get_api()->api_play_at(e24, channel, delay_us);
+    }
+
     virtual void api_continue_from (midipulse tick, midipulse beats)
     {
         get_api()->api_continue_from(tick, beats);
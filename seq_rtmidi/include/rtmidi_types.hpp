@@ -17,6 +17,7 @@
  *  refactor and partition, and slightly easier to read.
  */
 
+#include <atomic>                           /* std::atomic<>                */
 #include <string>                           /* std::string                  */
 #include <vector>                           /* std::vector container        */
 
@@ -71,10 +72,28 @@
 #define SEQ64_NO_INDEX          (-1)        /* good values start at 0       */
 
 /**
- *  Default size of the MIDI queue.
+ *  Default size of the MIDI queue.  The queue rounds it up to a power of 2.
+ *  The JACK input ports use rc_settings::input_queue_size() instead, which
+ *  can be changed with the "-o inqueue=n" option.
  */
 
-#define SEQ64_DEFAULT_QUEUE_SIZE    100
+#define SEQ64_DEFAULT_QUEUE_SIZE    1024
+
+/**
+ *  The number of bytes a midi_message holds in its own storage.  Enough for
+ *  any channel or system message except SysEx.
+ */
+
+#define SEQ64_MIDI_MESSAGE_INLINE   4
+
+/**
+ *  The size of a SysEx block, the largest message a midi_message can hold,
+ *  and the number of blocks preallocated in the SysEx pool shared by all
+ *  messages.  See midi_sysex_pool.
+ */
+
+#define SEQ64_SYSEX_BLOCK_SIZE      1024
+#define SEQ64_SYSEX_BLOCK_COUNT     64
 
 /*
  * Do not document the namespace; it breaks Doxygen.
@@ -82,6 +101,7 @@
 
 namespace seq64
 {
+    class midi_wakeup;
 
 /**
  *    MIDI API specifier arguments.  These items used to be nested in
@@ -94,6 +114,7 @@ enum rtmidi_api
     RTMIDI_API_UNSPECIFIED,     /**< Search for a working compiled API.     */
     RTMIDI_API_LINUX_ALSA,      /**< Advanced Linux Sound Architecture API. */
     RTMIDI_API_UNIX_JACK,       /**< JACK Low-Latency MIDI Server API.      */
+    RTMIDI_API_NULL,            /**< No server; captures, injects events.   */
 
 #ifdef USE_RTMIDI_API_ALL
 
@@ -112,6 +133,48 @@ enum rtmidi_api
 
 };
 
+/**
+ *  Provides a fixed set of SysEx blocks, for the midi_message objects that
+ *  outgrow their own storage.  The blocks are allocated statically, and
+ *  handed out and taken back by a lock-free stack, so that a realtime
+ *  callback can build a SysEx message without allocating memory or taking
+ *  a lock.  The head of the stack holds a block index and a modification
+ *  tag, to avoid the ABA problem.
+ */
+
+class midi_sysex_pool
+{
+
+public:
+
+    static midibyte * acquire ();
+    static void release (midibyte * block);
+
+    /**
+     *  Returns the number of times a message could not get a block, or had
+     *  to be truncated to the block size.
+     */
+
+    static unsigned long overflow ()
+    {
+        return sm_overflow;
+    }
+
+    /**
+     *  Counts a message that could not get a block, or was truncated.
+     */
+
+    static void count_overflow ()
+    {
+        ++sm_overflow;
+    }
+
+private:
+
+    static std::atomic<unsigned long> sm_overflow;
+
+};          // class midi_sysex_pool
+
 /**
  *  Provides a handy capsule for a MIDI message, based on the
  *  std::vector<unsigned char> data type from the RtMidi project.
@@ -120,29 +183,38 @@ enum rtmidi_api
  *  uses the seq64::event rather than the seq64::midi_message object.
  *  For the moment, we will translate between them until we have the
  *  interactions between the old and new modules under control.
+ *
+ *  A message is built and copied in the JACK process callbacks, for every
+ *  event, so it no longer wraps a vector.  Up to SEQ64_MIDI_MESSAGE_INLINE
+ *  bytes are stored in the object itself.  A longer (SysEx) message moves
+ *  its bytes to a block from the midi_sysex_pool, and gives the block back
+ *  when destroyed or assigned a short message.  If no block is free, or the
+ *  message outgrows its block, the extra bytes are dropped and counted.
  */
 
 class midi_message
 {
 
-public:
+private:
 
     /**
-     *  Holds the data of the MIDI message.  Callers should use
-     *  midi_message::container rather than using the vector directly.
-     *  Bytes are added by the push() function, and are safely accessed
-     *  (with bounds-checking) by operator [].
+     *  Holds the event status and data bytes of a short message.
      */
 
-    typedef std::vector<midibyte> container;
+    midibyte m_inline[SEQ64_MIDI_MESSAGE_INLINE];
 
-private:
+    /**
+     *  Points to the SysEx block holding the bytes of a long message, or is
+     *  null.
+     */
+
+    midibyte * m_sysex;
 
     /**
-     *  Holds the event status and data bytes.
+     *  The number of bytes in the message.
      */
 
-    container m_bytes;
+    int m_count;
 
     /**
      *  Holds the (optional) timestamp of the MIDI message.
@@ -153,46 +225,52 @@ private:
 public:
 
     midi_message ();
+    midi_message (const midi_message & rhs);
+    midi_message & operator = (const midi_message & rhs);
+    ~midi_message ();
 
     midibyte operator [] (int i) const
     {
-        return (i >= 0 && i < int(m_bytes.size())) ? m_bytes[i] : 0 ;
+        return (i >= 0 && i < m_count) ? bytes()[i] : 0 ;
     }
 
-#ifdef USE_MIDI_MESSAGE_AT_ACCESS
-
-    midibyte & at (int i)
-    {
-        return m_bytes.at(i);       /* can throw an exception */
-    }
-
-    const midibyte & at (int i) const
-    {
-        return m_bytes.at(i);       /* can throw an exception */
-    }
-
-#endif
-
     const char * array () const
     {
-        return reinterpret_cast<const char *>(&m_bytes[0]);
+        return reinterpret_cast<const char *>(bytes());
     }
 
     int count () const
     {
-        return int(m_bytes.size());
+        return m_count;
     }
 
     bool empty () const
     {
-        return m_bytes.empty();
+        return m_count == 0;
     }
 
-    void push (midibyte b)
+    /**
+     *  Appends a byte to the message.  Allocates nothing, except perhaps a
+     *  block from the SysEx pool.
+     *
+     * \return
+     *      Returns false if the byte was dropped.
+     */
+
+    bool push (midibyte b)
     {
-        m_bytes.push_back(b);
+        if (is_nullptr(m_sysex) && m_count < SEQ64_MIDI_MESSAGE_INLINE)
+        {
+            m_inline[m_count++] = b;
+            return true;
+        }
+        return push_sysex(b);
     }
 
+    void clear ();
+    bool assign (const midi_message & rhs);
+    void swap (midi_message & rhs);
+
     double timestamp () const
     {
         return m_timestamp;
@@ -205,11 +283,25 @@ public:
 
     bool is_sysex () const
     {
-        return m_bytes.size() > 0 ? event::is_sysex_msg(m_bytes[0]) : false ;
+        return m_count > 0 ? event::is_sysex_msg(bytes()[0]) : false ;
     }
 
     void show () const;
 
+private:
+
+    /**
+     *  Returns the storage in use, inline or pooled.
+     */
+
+    const midibyte * bytes () const
+    {
+        return not_nullptr(m_sysex) ? m_sysex : m_inline ;
+    }
+
+    bool push_sysex (midibyte b);
+    bool copy (const midi_message & rhs);
+
 };          // class midi_message
 
 /**
@@ -229,6 +321,15 @@ typedef void (* rtmidi_callback_t)
  *  Provides a queue of midi_message structures.  This entity used to be a
  *  plain structure nested in the midi_in_api class.  We made it a class to
  *  encapsulate some common operations to save a burden on the callers.
+ *
+ *  The queue is filled by an input callback (such as the JACK process
+ *  callback) and emptied by the input thread, concurrently.  It is a
+ *  wait-free single-producer, single-consumer ring:  only add() is called
+ *  by the producer, and only pop(), pop_front(), and front() by the
+ *  consumer.  The slots are allocated once, by allocate(), which must not
+ *  be called while the queue is in use.  The front and back counters
+ *  increase without bound (wrapping around), and are masked to get the slot
+ *  index, so the ring size is a power of 2.
  */
 
 class midi_queue
@@ -236,33 +337,61 @@ class midi_queue
 
 private:
 
-    unsigned m_front;
-    unsigned m_back;
-    unsigned m_size;
+    /**
+     *  The count of messages removed, written only by the consumer.
+     */
+
+    std::atomic<unsigned> m_front;
+
+    /**
+     *  The count of messages added, written only by the producer.
+     */
+
+    std::atomic<unsigned> m_back;
+
+    /**
+     *  The number of slots, a power of 2.
+     */
+
     unsigned m_ring_size;
+
+    /**
+     *  The preallocated slots.
+     */
+
     midi_message * m_ring;
 
+    /**
+     *  The number of messages dropped by add() because the queue was full.
+     *  A SysEx message dropped for want of a SysEx block is counted by the
+     *  midi_sysex_pool instead.
+     */
+
+    std::atomic<unsigned long> m_overflow;
+
 public:
 
     midi_queue ();
     ~midi_queue ();
 
     /**
-     * \getter m_size == 0
+     * \getter m_front == m_back
      */
 
     bool empty () const
     {
-        return m_size == 0;
+        return count() == 0;
     }
 
     /**
-     * \getter m_size == 0
+     *  Returns the number of messages in the queue.  Exact for the
+     *  consumer; the producer may add to it at any time.
      */
 
     int count () const
     {
-        return int(m_size);
+        return int(m_back.load(std::memory_order_acquire) -
+            m_front.load(std::memory_order_acquire));
     }
 
     /**
@@ -272,7 +401,16 @@ public:
 
     bool full () const
     {
-        return m_size == m_ring_size;
+        return unsigned(count()) == m_ring_size;
+    }
+
+    /**
+     * \getter m_overflow
+     */
+
+    unsigned long overflow () const
+    {
+        return m_overflow;
     }
 
     bool add (const midi_message & mmsg);
@@ -283,13 +421,20 @@ public:
 
     /**
      * \getter m_ring[m_front]
+     *      To be called by the consumer, only if the queue is not empty.
      */
 
     const midi_message & front () const
     {
-        return m_ring[m_front];
+        return m_ring[m_front.load(std::memory_order_relaxed) &
+            (m_ring_size - 1)];
     }
 
+private:
+
+    midi_queue (const midi_queue &);                /* not copyable     */
+    midi_queue & operator = (const midi_queue &);
+
 };
 
 /**
@@ -313,6 +458,7 @@ private:
     rtmidi_callback_t m_user_callback;
     void * m_user_data;
     bool m_continue_sysex;
+    midi_wakeup * m_wakeup;
 
 public:
 
@@ -472,6 +618,25 @@ public:
         m_user_callback = cbptr;
     }
 
+    /**
+     * \getter m_wakeup
+     *      If not null, to be posted after a message is added to the queue.
+     */
+
+    midi_wakeup * wakeup ()
+    {
+        return m_wakeup;
+    }
+
+    /**
+     * \setter m_wakeup
+     */
+
+    void wakeup (midi_wakeup * wp)
+    {
+        m_wakeup = wp;
+    }
+
 };          // class rtmidi_in_data
 
 }           // namespace seq64
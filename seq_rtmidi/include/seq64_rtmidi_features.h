@@ -49,6 +49,13 @@
 
 #define SEQ64_RTMIDI_PENDING
 
+/**
+ *  The null API needs no sound server or library, so it is built on every
+ *  platform.  It is used only if selected with the "-o null=n" option.
+ */
+
+#define SEQ64_BUILD_NULL_MIDI
+
 #ifdef PLATFORM_LINUX
 #define SEQ64_BUILD_UNIX_JACK
 
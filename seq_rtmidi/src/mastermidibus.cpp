@@ -51,7 +51,29 @@ namespace seq64
 {
 
 /**
- *  The base-class constructor fills the array for our busses.
+ *  Selects the MIDI API from the settings.  The null API, if selected with
+ *  the "-o null=n" option, overrides the JACK MIDI setting, which is sticky.
+ *
+ * \return
+ *      Returns RTMIDI_API_NULL, RTMIDI_API_UNIX_JACK, or
+ *      RTMIDI_API_LINUX_ALSA.
+ */
+
+static rtmidi_api
+settings_api ()
+{
+    if (rc().with_null_midi())
+        return RTMIDI_API_NULL;
+    else if (rc().with_jack_midi())
+        return RTMIDI_API_UNIX_JACK;
+    else
+        return RTMIDI_API_LINUX_ALSA;
+}
+
+/**
+ *  The base-class constructor fills the array for our busses.  The API
+ *  gets the wakeup of the input thread, for its input ports to post, and
+ *  the thru routing table.
  *
  * \param ppqn
  *      Provides the PPQN value for this object.  However, in most cases, the
@@ -65,14 +87,15 @@ namespace seq64
 mastermidibus::mastermidibus (int ppqn, midibpm bpm)
  :
     mastermidibase      (ppqn, bpm),
-    m_midi_master
-    (
-        rc().with_jack_midi() ? RTMIDI_API_UNIX_JACK : RTMIDI_API_LINUX_ALSA,
-        rc().application_name(), ppqn, bpm
-    ),
-    m_use_jack_polling  (rc().with_jack_midi())
+    m_midi_master       (settings_api(), rc().application_name(), ppqn, bpm),
+    m_use_jack_polling  (settings_api() != RTMIDI_API_LINUX_ALSA)
 {
-    // Empty body
+    midi_info * info = m_midi_master.get_api_info();
+    if (not_nullptr(info))
+    {
+        info->input_wakeup(&m_input_wakeup);
+        info->thru_routes(&m_thru_map);
+    }
 }
 
 /**
@@ -160,7 +183,8 @@ mastermidibus::api_init (int ppqn, midibpm bpm)
     else
     {
         unsigned nports = m_midi_master.full_port_count();
-        bool swap_io = rc().with_jack_midi();
+        bool nullmidi = settings_api() == RTMIDI_API_NULL;
+        bool swap_io = settings_api() == RTMIDI_API_UNIX_JACK;
         bool isinput = swap_io ? SEQ64_MIDI_OUTPUT_PORT : SEQ64_MIDI_INPUT_PORT;
         bool isoutput = swap_io ? SEQ64_MIDI_INPUT_PORT : SEQ64_MIDI_OUTPUT_PORT;
         port_list("rtmidi");
@@ -179,6 +203,8 @@ mastermidibus::api_init (int ppqn, midibpm bpm)
                 );
                 if (swap_io)
                     m_outbus_array.add(m, clock(i));    /* must come 1st    */
+                else if (nullmidi)
+                    m_inbus_array.add(m, true);         /* for the script   */
                 else
                     m_inbus_array.add(m, input(i));     /* must come 1st    */
 
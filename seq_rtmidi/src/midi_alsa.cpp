@@ -575,6 +575,48 @@ midi_alsa::api_play (event * e24, midibyte channel)
     snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
 }
 
+/**
+ *  Like api_play(), but schedules the event on the ALSA queue at a
+ *  real-time stamp relative to the current queue time, instead of sending
+ *  it directly.  The queue is started by midi_alsa_info.
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to deliver the event.
+ */
+
+void
+midi_alsa::api_play_at (event * e24, midibyte channel, long delay_us)
+{
+    midibyte buffer[4];                             /* temp for MIDI data   */
+    buffer[0] = e24->get_status();                  /* fill buffer          */
+    buffer[0] += (channel & 0x0F);
+    e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
+
+    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
+    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
+
+    snd_seq_event_t ev;
+    snd_seq_ev_clear(&ev);                          /* clear event          */
+    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
+    snd_midi_event_free(midi_ev);                   /* free the parser      */
+
+    snd_seq_real_time_t rt;
+    rt.tv_sec = unsigned(delay_us / 1000000);
+    rt.tv_nsec = unsigned(delay_us % 1000000) * 1000;
+    snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
+    snd_seq_ev_set_subs(&ev);
+    snd_seq_ev_schedule_real(&ev, parent_bus().queue_number(), 1, &rt);
+    snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
+}
+
 /**
  *  min() for long values.
  *
@@ -782,6 +824,39 @@ midi_alsa::api_clock (midipulse tick)
     snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
 }
 
+/**
+ *  Like api_clock(), but schedules the pulse on the ALSA queue at a
+ *  real-time stamp relative to the current queue time, as api_play_at()
+ *  does for the events.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      Provides the tick of the pulse, unused in the ALSA implementation.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to deliver the pulse.
+ */
+
+void
+midi_alsa::api_clock_at (midipulse /*tick*/, long delay_us)
+{
+    snd_seq_event_t ev;
+    snd_seq_ev_clear(&ev);                          /* clear event          */
+    ev.type = SND_SEQ_EVENT_CLOCK;
+    ev.tag = 127;
+    snd_seq_ev_set_fixed(&ev);
+    snd_seq_ev_set_priority(&ev, 1);
+
+    snd_seq_real_time_t rt;
+    rt.tv_sec = unsigned(delay_us / 1000000);
+    rt.tv_nsec = unsigned(delay_us % 1000000) * 1000;
+    snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
+    snd_seq_ev_set_subs(&ev);
+    snd_seq_ev_schedule_real(&ev, parent_bus().queue_number(), 1, &rt);
+    snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
+}
+
 /**
  * Currently, this code is implemented in the midi_alsa_info module, since
  * it is a mastermidibus function.  Note the implementation here, though.
@@ -59,6 +59,7 @@
 #include "easy_macros.hpp"              /* C++ version of easy macros       */
 #include "event.hpp"                    /* seq64::event and other tokens    */
 #include "midi_alsa_info.hpp"           /* seq64::midi_alsa_info            */
+#include "midi_wakeup.hpp"              /* seq64::midi_wakeup               */
 #include "midibus_common.hpp"           /* from the libseq64 sub-project    */
 #include "settings.hpp"                 /* seq64::rc() configuration object */
 
@@ -137,13 +138,21 @@ midi_alsa_info::midi_alsa_info
         (
             m_alsa_seq, POLLIN
         );
-        m_poll_descriptors = new pollfd[m_num_poll_descriptors];
+        m_poll_descriptors = new pollfd[m_num_poll_descriptors + 1];
         snd_seq_poll_descriptors
         (
             m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
         );
         snd_seq_set_output_buffer_size(m_alsa_seq, c_midibus_output_size);
         snd_seq_set_input_buffer_size(m_alsa_seq, c_midibus_input_size);
+
+        /*
+         * Start the queue, so that midi_alsa::api_play_at() can schedule
+         * lookahead events on it.  It runs as long as the client exists.
+         */
+
+        snd_seq_start_queue(m_alsa_seq, global_queue(), NULL);
+        snd_seq_drain_output(m_alsa_seq);
     }
 }
 
@@ -355,20 +364,39 @@ midi_alsa_info::api_set_beats_per_minute (midibpm b)
 /**
  *  Polls for any ALSA MIDI information using a timeout value of 1000
  *  milliseconds.  Identical to seq_alsamidi's mastermidibus ::
- *  api_poll_for_midi(), which waits 1 millisecond if no input is pending.
+ *  api_poll_for_midi().  The wakeup of the input thread, if set, is polled
+ *  in the extra slot at the end of the descriptors, so that the perform
+ *  object can end the wait when it stops the input thread.  The poll itself
+ *  is the wait, so there is no longer a millisecond of sleep when no input
+ *  is pending.
  *
  * \return
  *      Returns the result of the call to poll() on the global ALSA poll
- *      descriptors.
+ *      descriptors, not counting the wakeup.
  */
 
 int
 midi_alsa_info::api_poll_for_midi ()
 {
-    int result = poll(m_poll_descriptors, m_num_poll_descriptors, 1000);
-    if (result == 0)
-        millisleep(1);
+    int count = m_num_poll_descriptors;
+    midi_wakeup * wp = input_wakeup();
+    if (not_nullptr(m_poll_descriptors) && not_nullptr(wp) && wp->valid())
+    {
+        struct pollfd & pfd = m_poll_descriptors[count++];
+        pfd.fd = wp->fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+    }
 
+    int result = poll(m_poll_descriptors, count, 1000);
+    if (result > 0 && count > m_num_poll_descriptors)
+    {
+        if (m_poll_descriptors[m_num_poll_descriptors].revents != 0)
+        {
+            wp->drain();
+            --result;
+        }
+    }
     return result;
 }
 
@@ -471,7 +499,7 @@ midi_alsa_info::api_port_start (mastermidibus & masterbus, int bus, int port)
      */
 
     m_num_poll_descriptors = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
-    m_poll_descriptors = new pollfd[m_num_poll_descriptors]; /* allocate info */
+    m_poll_descriptors = new pollfd[m_num_poll_descriptors + 1]; /* + wakeup */
     snd_seq_poll_descriptors                        /* get input descriptors */
     (
         m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
@@ -148,6 +148,7 @@
 #ifdef SEQ64_JACK_SUPPORT
 
 #include <sstream>
+#include <string.h>                     /* memcpy()                         */
 
 #include <jack/midiport.h>
 #include <jack/ringbuffer.h>
@@ -157,6 +158,8 @@
 #include "jack_assistant.hpp"           /* seq64::jack_status_pair_t        */
 #include "midibus_rm.hpp"               /* seq64::midibus for rtmidi        */
 #include "midi_jack.hpp"                /* seq64::midi_jack                 */
+#include "midi_wakeup.hpp"              /* seq64::midi_wakeup               */
+#include "rt_audit.hpp"                 /* SEQ64_RT_SCOPE()                 */
 #include "settings.hpp"                 /* seq64::rc() accessor function    */
 
 /**
@@ -216,6 +219,7 @@ namespace seq64
 int
 jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
 {
+    SEQ64_RT_SCOPE();                               /* a JACK callback      */
     midi_jack_data * jackdata = reinterpret_cast<midi_jack_data *>(arg);
 
 #ifdef SEQ64_USE_DEBUG_OUTPUT
@@ -253,6 +257,7 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
         rtmidi_in_data * rtindata = jackdata->m_jack_rtmidiin;
         jack_midi_event_t jmevent;
         jack_time_t jtime;
+        bool queued = false;
         int evcount = jack_midi_get_event_count(buff);
         for (int j = 0; j < evcount; ++j)
         {
@@ -261,8 +266,12 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
             {
                 midi_message message;
                 int eventsize = int(jmevent.size);
-                for (int i = 0; i < eventsize; ++i)
-                    message.push(jmevent.buffer[i]);
+                bool complete = true;
+                for (int i = 0; complete && i < eventsize; ++i)
+                    complete = message.push(jmevent.buffer[i]);
+
+                if (! complete)
+                    continue;               /* no SysEx block, drop it      */
 
                 jack_time_t delta_jtime;
                 jtime = jack_get_time();            /* compute delta time   */
@@ -285,8 +294,8 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                         rtmidi_callback_t callback = rtindata->user_callback();
                         callback(message, rtindata->user_data());
                     }
-                    else
-                        (void) rtindata->queue().add(message);
+                    else if (rtindata->queue().add(message))
+                        queued = true;
                 }
             }
             else
@@ -301,6 +310,8 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                 }
             }
         }
+        if (queued && not_nullptr(rtindata->wakeup()))
+            rtindata->wakeup()->post();         /* one write per cycle  */
     }
     return 0;
 }
@@ -313,13 +324,22 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
  *  Client" by qjackctl.  Here's how it works:
  *
  *      -#  Get the JACK port buffer, for our local jack port.  Clear it.
- *      -#  Loop while the number of bytes available for reading [via
- *          jack_ringbuffer_read_space()] is non-zero.  Note that the second
- *          parameter is where the data is copied.
- *      -#  Get the size of each event, and allocate space for an event to be
- *          written to an event port buffer (the JACK "reserve" function).
- *      -#  Read the data from the ringbuffer into this port buffer.  JACK
- *          should then send it to the remote port.
+ *      -#  Loop while a message header is available for reading [via
+ *          jack_ringbuffer_read_space()].  Read the header and the message
+ *          into the pending list, which is kept sorted by target frame.
+ *          The bytes of a SysEx message are staged in m_jack_staged.
+ *      -#  Send each pending message whose target frame falls in this
+ *          cycle, at its frame offset from the start of the cycle (the JACK
+ *          "reserve" function).  A message whose target frame has already
+ *          passed is late; it is counted, and sent at offset 0.  The other
+ *          messages wait for a later cycle.  JACK should then send the
+ *          data to the remote port.  A message that JACK has no room for is
+ *          dropped and counted; nothing is printed from this callback.
+ *
+ *  Every message used to be reserved at offset 0, so that all events
+ *  written during a period landed on its first frame.  Now each message
+ *  carries the JACK frame time at which it is due (see
+ *  midi_jack::frame_stamp()), and the timing is sample-accurate.
  *
  *  Since this is an output port, "buff" is the area to which we can write
  *  data, to send it to the "remote" (i.e. outside our application) port.  The
@@ -344,7 +364,7 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
 int
 jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
 {
-    static size_t s_offset = 0;
+    SEQ64_RT_SCOPE();                               /* a JACK callback      */
     midi_jack_data * jackdata = reinterpret_cast<midi_jack_data *>(arg);
 
 #ifdef SEQ64_USE_DEBUG_OUTPUT
@@ -381,47 +401,129 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
 #endif
 
     /*
-     * A for-loop over the number of nframes?  See discussion above.
      * Why are we reading here?  That's where our app has dumped the next set
-     * of MIDI events to output.
+     * of MIDI events to output.  Move them to the pending list, in order of
+     * target frame.  The frames are compared by signed difference, since
+     * the JACK frame time wraps around.  The bytes of a longer message are
+     * staged; if there is no room, it stays in the ring-buffer, with the
+     * messages after it, until a later cycle.
      */
 
-    while (jack_ringbuffer_read_space(jackdata->m_jack_buffsize) > 0)
+    jack_nframes_t cyclestart = jack_last_frame_time(jackdata->m_jack_client);
+    midi_jack_event * pending = jackdata->m_jack_pending;
+    int count = jackdata->m_jack_pending_count;
+    midi_jack_header header;
+    while
+    (
+        count < SEQ64_JACK_PENDING_MAX &&
+        jack_ringbuffer_read_space(jackdata->m_jack_buffsize) >= sizeof header
+    )
     {
-        int space;
+        (void) jack_ringbuffer_peek
+        (
+            jackdata->m_jack_buffsize, (char *) &header, sizeof header
+        );
+
+        char * dest = nullptr;
+        int staged = 0;
+        bool longer = header.mjh_size > SEQ64_JACK_EVENT_BYTES_MAX;
+        if (longer)
+        {
+            if (header.mjh_size > SEQ64_JACK_STAGED_BYTES)
+            {
+                jack_ringbuffer_read_advance
+                (
+                    jackdata->m_jack_buffsize, sizeof header
+                );
+                jack_ringbuffer_read_advance
+                (
+                    jackdata->m_jack_buffmessage, size_t(header.mjh_size)
+                );
+                ++jackdata->m_jack_drop_count;      /* can never be staged  */
+                continue;
+            }
+            staged = jackdata->m_jack_staged_used;
+            if (staged + header.mjh_size > SEQ64_JACK_STAGED_BYTES)
+                break;                              /* wait for the room    */
+
+            jackdata->m_jack_staged_used += header.mjh_size;
+            ++jackdata->m_jack_staged_count;
+            dest = reinterpret_cast<char *>(&jackdata->m_jack_staged[staged]);
+        }
+        jack_ringbuffer_read_advance(jackdata->m_jack_buffsize, sizeof header);
+
+        int i = count++;
+        while (i > 0 && int32_t(pending[i-1].mje_frame - header.mjh_frame) > 0)
+        {
+            pending[i] = pending[i-1];              /* stable insertion     */
+            --i;
+        }
+        pending[i].mje_frame = header.mjh_frame;
+        pending[i].mje_size = header.mjh_size;
+        pending[i].mje_staged = staged;
+        if (! longer)
+            dest = reinterpret_cast<char *>(pending[i].mje_data);
+
         (void) jack_ringbuffer_read
         (
-            jackdata->m_jack_buffsize, (char *) &space, sizeof space
+            jackdata->m_jack_buffmessage, dest, size_t(header.mjh_size)
         );
+    }
 
-        /*
-         * s_offset is always zero. Using nframes instead of s_offset = 0
-         * causes notes not to be played.  Probably because this is a write
-         * operation?
-         */
+    /*
+     * Send the messages due in this cycle.  Since the list is sorted, the
+     * offsets never decrease, as jack_midi_event_reserve() requires.
+     */
+
+    int sent = 0;
+    for ( ; sent < count; ++sent)
+    {
+        const midi_jack_event & ev = pending[sent];
+        int32_t offset = int32_t(ev.mje_frame - cyclestart);
+        if (offset >= int32_t(nframes))
+            break;                                  /* due in a later cycle */
 
-        jack_midi_data_t * md = jack_midi_event_reserve(buf, s_offset, space);
+        if (offset < 0)
+        {
+            offset = 0;                             /* late, send it now    */
+            ++jackdata->m_jack_late_count;
+        }
+
+        const midibyte * data = ev.mje_data;
+        if (ev.mje_size > SEQ64_JACK_EVENT_BYTES_MAX)
+        {
+            data = &jackdata->m_jack_staged[ev.mje_staged];
+            if (--jackdata->m_jack_staged_count == 0)
+                jackdata->m_jack_staged_used = 0;   /* reclaim the staging  */
+        }
+
+        jack_midi_data_t * md = jack_midi_event_reserve
+        (
+            buf, jack_nframes_t(offset), size_t(ev.mje_size)
+        );
         if (not_nullptr(md))
         {
-            char * mididata = reinterpret_cast<char *>(md);
-            (void) jack_ringbuffer_read         /* copy into mididata */
-            (
-                jackdata->m_jack_buffmessage, mididata, size_t(space)
-            );
+            memcpy(md, data, size_t(ev.mje_size));
 
 #ifdef SEQ64_SHOW_API_CALLS_TMI
-            printf("%d bytes read: ", space);
-            for (int i = 0; i < space; ++i)
-                printf("%x ", (unsigned char)(mididata[i]));
+            printf("%d bytes at offset %d: ", ev.mje_size, int(offset));
+            for (int i = 0; i < ev.mje_size; ++i)
+                printf("%x ", (unsigned char)(data[i]));
 
             printf("\n");
 #endif
         }
         else
-        {
-            errprint("jack_midi_event_reserve() returned a null pointer");
-        }
+            ++jackdata->m_jack_drop_count;          /* reported later       */
     }
+    if (sent > 0)
+    {
+        for (int i = sent; i < count; ++i)
+            pending[i - sent] = pending[i];         /* keep the rest        */
+
+        count -= sent;
+    }
+    jackdata->m_jack_pending_count = count;
     return 0;
 }
 
@@ -463,11 +565,20 @@ midi_jack::midi_jack
 /**
  *  This could be a rote empty destructor if we offload this destruction to the
  *  midi_jack_data structure.  However, other than the initialization, that
- *  structure is currently "dumb".
+ *  structure is currently "dumb".  It also reports the messages dropped by
+ *  the process callback, which must not print anything itself.
  */
 
 midi_jack::~midi_jack ()
 {
+    unsigned long dropped = dropped_events();   /* not in the callback  */
+    if (dropped > 0)
+    {
+        std::string msg = port_name() + ": JACK MIDI messages dropped: " +
+            std::to_string(dropped);
+
+        errprint(msg.c_str());
+    }
     if (not_nullptr(m_jack_data.m_jack_buffsize))
         jack_ringbuffer_free(m_jack_data.m_jack_buffsize);
 
@@ -737,16 +848,45 @@ midi_jack::api_deinit_in ()
     return true;
 }
 
+/**
+ *  Sends an event immediately, which, for JACK, means at the frame time of
+ *  the call plus one period.  See api_play_at().
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ */
+
+void
+midi_jack::api_play (event * e24, midibyte channel)
+{
+    api_play_at(e24, channel, 0);
+}
+
 /**
  *  We could push the bytes of the event into a midibyte vector, as done in
  *  send_message().  The ALSA code (seq_alsamidi/src/midibus.cpp) sticks the
  *  event bytes in an array, which might be a little faster than using
  *  push_back(), but let's try the vector first.  The rtmidi code here is from
  *  midi_out_jack::send_message().
+ *
+ *  The event is stamped with the JACK frame time at which it is due, and
+ *  jack_process_rtmidi_output() puts it at that frame.
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to send the event.
  */
 
 void
-midi_jack::api_play (event * e24, midibyte channel)
+midi_jack::api_play_at (event * e24, midibyte channel, long delay_us)
 {
     midibyte status = e24->get_status() + (channel & 0x0F);
     midibyte d0, d1;
@@ -764,7 +904,7 @@ midi_jack::api_play (event * e24, midibyte channel)
 
     if (m_jack_data.valid_buffer())
     {
-        if (! send_message(message))
+        if (! send_message(message, frame_stamp(delay_us)))
         {
             errprint("JACK api_play failed");
         }
@@ -772,19 +912,53 @@ midi_jack::api_play (event * e24, midibyte channel)
 }
 
 /**
- *  Sends a JACK MIDI output message.  It writes the full message size and
- *  the message itself to the JACK ring buffer.
+ *  Calculates the JACK frame time at which a message sent now, or the
+ *  given time from now, is to be played.  One period is added to the
+ *  current frame time:  the message cannot be written before the next
+ *  cycle, and the offset of the current time in the current period is kept,
+ *  so that all messages have the same one-period latency.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds.
+ *
+ * \return
+ *      Returns the target frame time.
+ */
+
+jack_nframes_t
+midi_jack::frame_stamp (long delay_us)
+{
+    jack_client_t * client = client_handle();
+    jack_nframes_t result = jack_frame_time(client) +
+        jack_get_buffer_size(client);
+
+    if (delay_us > 0)
+    {
+        double rate = double(jack_get_sample_rate(client));
+        result += jack_nframes_t(delay_us * rate / 1000000.0);
+    }
+    return result;
+}
+
+/**
+ *  Sends a JACK MIDI output message.  It writes the message itself, and
+ *  then a header holding the message size and target frame, to the JACK
+ *  ring buffers.  The header is written last, so that the process callback
+ *  never sees a header without its message.
  *
  * \param message
  *      Provides the MIDI message object, which contains the bytes to send.
  *
+ * \param frame
+ *      The JACK frame time at which to play the message.
+ *
  * \return
  *      Returns true if the buffer message and buffer size seem to be written
  *      correctly.
  */
 
 bool
-midi_jack::send_message (const midi_message & message)
+midi_jack::send_message (const midi_message & message, jack_nframes_t frame)
 {
     int nbytes = message.count();
     bool result = nbytes > 0;
@@ -793,13 +967,16 @@ midi_jack::send_message (const midi_message & message)
 #ifdef PLATFORM_DEBUG_TMI
         message.show();
 #endif
+        midi_jack_header header;
+        header.mjh_frame = frame;
+        header.mjh_size = nbytes;
         int count1 = jack_ringbuffer_write
         (
             m_jack_data.m_jack_buffmessage, message.array(), message.count()
         );
         int count2 = jack_ringbuffer_write
         (
-            m_jack_data.m_jack_buffsize, (char *) &nbytes, sizeof nbytes
+            m_jack_data.m_jack_buffsize, (char *) &header, sizeof header
         );
         apiprint("send_message", "jack");
         result = (count1 > 0) && (count2 > 0);
@@ -913,6 +1090,32 @@ midi_jack::api_clock (midipulse tick)
     send_byte(EVENT_MIDI_CLOCK);
 }
 
+/**
+ *  Sends a MIDI clock pulse stamped with the JACK frame time at which it is
+ *  due, as api_play_at() does for the events, so that the pulses are spaced
+ *  exactly, whatever the period of the output thread.
+ *
+ * \param tick
+ *      The tick of the pulse, unused.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to send the pulse.
+ */
+
+void
+midi_jack::api_clock_at (midipulse /*tick*/, long delay_us)
+{
+    midi_message message;
+    message.push(EVENT_MIDI_CLOCK);
+    if (m_jack_data.valid_buffer())
+    {
+        if (! send_message(message, frame_stamp(delay_us)))
+        {
+            errprint("JACK api_clock_at() failed");
+        }
+    }
+}
+
 /**
  *  An internal helper function for sending MIDI clock bytes.
  *
@@ -944,7 +1147,7 @@ midi_jack::send_byte (midibyte evbyte)
     message.push(evbyte);
     if (m_jack_data.valid_buffer())
     {
-        bool ok = send_message(message);
+        bool ok = send_message(message, frame_stamp(0));
         if (! ok)
         {
             errprint("JACK send_byte() failed");
@@ -1369,14 +1572,31 @@ midi_in_jack::midi_in_jack (midibus & parentbus, midi_info & masterinfo)
      * It is retrieved in api_init_in().
      *
      * Hook in the input data.  The JACK port pointer will get set in
-     * api_init_in() or api_init_out() when the port is registered.
+     * api_init_in() or api_init_out() when the port is registered.  The
+     * queue is sized before the process callback can use it.
      */
 
+    input_data()->queue().allocate(unsigned(rc().input_queue_size()));
     m_jack_data.m_jack_rtmidiin = input_data();
+
+    /*
+     * The process callback posts the wakeup of the input thread when it
+     * queues input, so the input thread can block instead of polling.
+     */
+
+    midi_wakeup * wp = masterinfo.input_wakeup();
+    if (not_nullptr(wp))
+    {
+        input_data()->wakeup(wp);
+        wp->arm();
+    }
 }
 
 /**
  *  Checks the rtmidi_in_data queue for the number of items in the queue.
+ *  This function no longer sleeps; it is called for each input port, and by
+ *  mastermidibase::is_more_input() as well.  When there is no input, the
+ *  input thread blocks on the wakeup that the process callback posts.
  *
  * \return
  *      Returns the value of rtindata->queue().count(), unless the caller is
@@ -1387,16 +1607,7 @@ int
 midi_in_jack::api_poll_for_midi ()
 {
     rtmidi_in_data * rtindata = m_jack_data.m_jack_rtmidiin;
-    if (rtindata->using_callback())
-    {
-        millisleep(1);
-        return 0;
-    }
-    else
-    {
-        millisleep(1);
-        return rtindata->queue().count();
-    }
+    return rtindata->using_callback() ? 0 : rtindata->queue().count() ;
 }
 
 /**
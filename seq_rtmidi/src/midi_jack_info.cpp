@@ -38,13 +38,17 @@
 
 #ifdef SEQ64_JACK_SUPPORT
 
+#include <jack/midiport.h>
+
 #include "easy_macros.hpp"              /* C++ version of easy macros       */
 #include "event.hpp"                    /* seq64::event and other tokens    */
 #include "jack_assistant.hpp"           /* seq64::create_jack_client()      */
 #include "midi_jack.hpp"                /* seq64::midi_jack_info            */
 #include "midi_jack_info.hpp"           /* seq64::midi_jack_info            */
 #include "midibus_common.hpp"           /* from the libseq64 sub-project    */
+#include "rt_audit.hpp"                 /* SEQ64_RT_SCOPE()                 */
 #include "settings.hpp"                 /* seq64::rc() configuration object */
+#include "thru_map.hpp"                 /* seq64::thru_map                  */
 
 /*
  * Do not document the namespace; it breaks Doxygen.
@@ -60,10 +64,148 @@ namespace seq64
 extern int jack_process_rtmidi_input (jack_nframes_t nframes, void * arg);
 extern int jack_process_rtmidi_output (jack_nframes_t nframes, void * arg);
 
+/**
+ *  Adds a thru message to the pending list of an output port, in order of
+ *  target frame, after the messages due at the same frame.  Only called in
+ *  the process callback, which is the only user of the pending list.
+ *
+ * \param jackdata
+ *      The output port.
+ *
+ * \param frame
+ *      The JACK frame time at which to send the message.
+ *
+ * \param data
+ *      The message bytes.
+ *
+ * \param size
+ *      The number of message bytes, at most SEQ64_JACK_EVENT_BYTES_MAX.
+ *
+ * \return
+ *      Returns false if the pending list is full, and the message is dropped.
+ */
+
+static bool
+jack_thru_insert
+(
+    midi_jack_data * jackdata, jack_nframes_t frame,
+    const midibyte * data, int size
+)
+{
+    midi_jack_event * pending = jackdata->m_jack_pending;
+    int i = jackdata->m_jack_pending_count;
+    if (i >= SEQ64_JACK_PENDING_MAX)
+        return false;
+
+    ++jackdata->m_jack_pending_count;
+    while (i > 0 && int32_t(pending[i-1].mje_frame - frame) > 0)
+    {
+        pending[i] = pending[i-1];
+        --i;
+    }
+    pending[i].mje_frame = frame;
+    pending[i].mje_size = size;
+    for (int b = 0; b < size; ++b)
+        pending[i].mje_data[b] = data[b];
+
+    return true;
+}
+
+/**
+ *  Echoes the channel messages of the input ports along the thru routing
+ *  table, straight into the pending lists of the output ports, at the same
+ *  frame offset in the same cycle.  The input buffers can be read more than
+ *  once in a cycle, so this function reads them after the input callbacks
+ *  have queued the messages for the input thread, and before the output
+ *  callbacks send the pending lists.  Nothing is allocated or locked.
+ *
+ * \param nframes
+ *      The number of frames in the cycle.
+ *
+ * \param ports
+ *      The ports of the JACK master, all processed in this cycle.
+ *
+ * \param client
+ *      The JACK client of the master.
+ *
+ * \param routes
+ *      The thru routing table.
+ */
+
+static void
+jack_process_thru
+(
+    jack_nframes_t nframes, std::vector<midi_jack *> & ports,
+    jack_client_t * client, const thru_map & routes
+)
+{
+    midi_jack_data * outputs[SEQ64_DEFAULT_BUSS_MAX];
+    for (int b = 0; b < SEQ64_DEFAULT_BUSS_MAX; ++b)
+        outputs[b] = nullptr;
+
+    std::vector<midi_jack *>::iterator mi;
+    for (mi = ports.begin(); mi != ports.end(); ++mi)
+    {
+        midi_jack * mj = *mi;
+        int b = mj->parent_bus().get_bus_index();
+        if (! mj->parent_bus().is_input_port() && b >= 0)
+        {
+            if (b < SEQ64_DEFAULT_BUSS_MAX && mj->jack_data().valid_buffer())
+                outputs[b] = &mj->jack_data();
+        }
+    }
+
+    jack_nframes_t cyclestart = jack_last_frame_time(client);
+    for (mi = ports.begin(); mi != ports.end(); ++mi)
+    {
+        midi_jack * mj = *mi;
+        jack_port_t * port = mj->jack_data().m_jack_port;
+        if (! mj->parent_bus().is_input_port() || is_nullptr(port))
+            continue;
+
+        void * buff = jack_port_get_buffer(port, nframes);
+        if (is_nullptr(buff))
+            continue;
+
+        bussbyte inbus = bussbyte(mj->parent_bus().get_bus_index());
+        int evcount = jack_midi_get_event_count(buff);
+        for (int j = 0; j < evcount; ++j)
+        {
+            jack_midi_event_t jmevent;
+            if (jack_midi_event_get(&jmevent, buff, j) != 0)
+                continue;
+
+            int size = int(jmevent.size);
+            if (size < 1 || size > 3)
+                continue;                           /* no SysEx echoed      */
+
+            for (int r = 0; r < routes.count(); ++r)
+            {
+                midibyte data[3];
+                data[0] = jmevent.buffer[0];
+                data[1] = size > 1 ? jmevent.buffer[1] : 0 ;
+                data[2] = size > 2 ? jmevent.buffer[2] : 0 ;
+                if (routes.apply(r, inbus, data[0], data[1]))
+                {
+                    midi_jack_data * out = outputs[routes.out_bus(r)];
+                    if (not_nullptr(out))
+                    {
+                        (void) jack_thru_insert
+                        (
+                            out, cyclestart + jmevent.time, data, size
+                        );
+                    }
+                }
+            }
+        }
+    }
+}
+
 /**
  *  Provides a JACK callback function that uses the callbacks defined in the
- *  midi_jack module.  This function calls both the input callback and
- *  the output callback, depending on the port type.  This may lead to
+ *  midi_jack module.  This function calls the input callbacks, then the
+ *  output callbacks, so that the input echoed by the thru routing table (see
+ *  jack_process_thru()) goes out in the same cycle.  This may lead to
  *  delays, depending on the size of the JACK MIDI buffer.
  *
  * \param nframes
@@ -79,6 +221,7 @@ extern int jack_process_rtmidi_output (jack_nframes_t nframes, void * arg);
 int
 jack_process_io (jack_nframes_t nframes, void * arg)
 {
+    SEQ64_RT_SCOPE();                   /* the JACK process callback        */
     if (nframes > 0)
     {
         midi_jack_info * self = reinterpret_cast<midi_jack_info *>(arg);
@@ -100,7 +243,26 @@ jack_process_io (jack_nframes_t nframes, void * arg)
                 midi_jack_data * mjp = &mj->jack_data();
                 if (mj->parent_bus().is_input_port())
                     (void) jack_process_rtmidi_input(nframes, mjp);
-                else
+            }
+
+            const thru_map * routes = self->thru_routes();
+            if (not_nullptr(routes) && ! routes->empty())
+            {
+                jack_process_thru
+                (
+                    nframes, self->m_jack_ports, self->m_jack_client, *routes
+                );
+            }
+
+            for
+            (
+                mi = self->m_jack_ports.begin();
+                mi != self->m_jack_ports.end(); ++mi
+            )
+            {
+                midi_jack * mj = *mi;
+                midi_jack_data * mjp = &mj->jack_data();
+                if (! mj->parent_bus().is_input_port())
                     (void) jack_process_rtmidi_output(nframes, mjp);
             }
         }
@@ -0,0 +1,405 @@
+/**
+ * \file          midi_null.cpp
+ *
+ *    A class for MIDI input/output that needs no sound server.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       See the rtexmidi.lic file.  Too big.
+ *
+ *  The null ports do no I/O.  Each output call is captured, with its time,
+ *  by the midi_null_info master, including the MIDI clock and the realtime
+ *  messages, so that the timing of the engine can be checked.  The input
+ *  port reads the events of the input script as they come due.
+ */
+
+#include "easy_macros.hpp"              /* C++ version of easy macros       */
+#include "event.hpp"                    /* seq64::event and other tokens    */
+#include "midi_null.hpp"                /* seq64::midi_null classes         */
+#include "midibus_common.hpp"           /* from the libseq64 sub-project    */
+#include "midibus_rm.hpp"               /* seq64::midibus                   */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/*
+ * class midi_null
+ */
+
+/**
+ *  Principal constructor.
+ *
+ * \param parentbus
+ *      Provides the buss object that owns this port.
+ *
+ * \param masterinfo
+ *      Provides the master information, which must be a midi_null_info
+ *      object.
+ */
+
+midi_null::midi_null (midibus & parentbus, midi_info & masterinfo)
+ :
+    midi_api        (parentbus, masterinfo),
+    m_null_info     (dynamic_cast<midi_null_info &>(masterinfo))
+{
+    // Empty body
+}
+
+/**
+ *  A rote empty virtual destructor.
+ */
+
+midi_null::~midi_null ()
+{
+    // Empty body
+}
+
+/**
+ *  Initializes an output port.  There is nothing to open.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midi_null::api_init_out ()
+{
+    set_port_open();
+    return true;
+}
+
+/**
+ *  Initializes the input port.  There is nothing to open.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midi_null::api_init_in ()
+{
+    set_port_open();
+    return true;
+}
+
+/**
+ *  Initializes a virtual output port, as for the --manual-alsa-ports option.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midi_null::api_init_out_sub ()
+{
+    set_port_open();
+    return true;
+}
+
+/**
+ *  Initializes a virtual input port, as for the --manual-alsa-ports option.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midi_null::api_init_in_sub ()
+{
+    set_port_open();
+    return true;
+}
+
+/**
+ *  Deinitializes the input port.  There is nothing to close.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midi_null::api_deinit_in ()
+{
+    return true;
+}
+
+/**
+ *  Captures an event now.
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ */
+
+void
+midi_null::api_play (event * e24, midibyte channel)
+{
+    api_play_at(e24, channel, 0);
+}
+
+/**
+ *  Captures an event, stamped with the time at which it is due.  The bytes
+ *  are built as in midi_jack::api_play_at().
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to send the event.
+ */
+
+void
+midi_null::api_play_at (event * e24, midibyte channel, long delay_us)
+{
+    midibyte status = e24->get_status() + (channel & 0x0F);
+    midibyte d0, d1;
+    e24->get_data(d0, d1);
+    if (! e24->is_two_bytes())
+        d1 = 0;
+
+    int bus = parent_bus().get_bus_index();
+    m_null_info.capture(bus, status, d0, d1, delay_us);
+}
+
+/**
+ *  Captures the start of a SysEx message.  The data is not kept.
+ *
+ * \param e24
+ *      The SysEx event, unused.
+ */
+
+void
+midi_null::api_sysex (event * /* e24 */)
+{
+    send_byte(EVENT_MIDI_SYSEX);
+}
+
+/**
+ *  There is nothing to flush; the events are captured as they are played.
+ */
+
+void
+midi_null::api_flush ()
+{
+    // No code needed
+}
+
+/**
+ *  Captures Continue and Song Position, in the order that the ALSA version
+ *  sends them.
+ *
+ * \param tick
+ *      Provides the tick value to continue from, unused.
+ *
+ * \param beats
+ *      The parameter "beats" is currently unused.
+ */
+
+void
+midi_null::api_continue_from (midipulse /*tick*/, midipulse /*beats*/)
+{
+    send_byte(EVENT_MIDI_CONTINUE);
+    send_byte(EVENT_MIDI_SONG_POS);
+}
+
+/**
+ *  Captures MIDI Start.
+ */
+
+void
+midi_null::api_start ()
+{
+    send_byte(EVENT_MIDI_START);
+}
+
+/**
+ *  Captures MIDI Stop.
+ */
+
+void
+midi_null::api_stop ()
+{
+    send_byte(EVENT_MIDI_STOP);
+}
+
+/**
+ *  Captures a MIDI clock, so that the clock jitter can be measured from the
+ *  capture.
+ *
+ * \param tick
+ *      The value of the tick, unused.
+ */
+
+void
+midi_null::api_clock (midipulse /*tick*/)
+{
+    send_byte(EVENT_MIDI_CLOCK);
+}
+
+/**
+ *  Captures a MIDI clock stamped with the time at which it is due, so that
+ *  the capture shows the spacing of the scheduled pulses.
+ *
+ * \param tick
+ *      The value of the tick, unused.
+ *
+ * \param delay_us
+ *      The time from now at which the pulse is due.
+ */
+
+void
+midi_null::api_clock_at (midipulse /*tick*/, long delay_us)
+{
+    m_null_info.capture
+    (
+        parent_bus().get_bus_index(), EVENT_MIDI_CLOCK, 0, 0, delay_us
+    );
+}
+
+/**
+ *  Sets the PPQN value.  The null ports keep no time of their own.
+ *
+ * \param ppqn
+ *      The PPQN value to set, unused.
+ */
+
+void
+midi_null::api_set_ppqn (int /*ppqn*/)
+{
+    // No code needed
+}
+
+/**
+ *  Sets the BPM value.  The null ports keep no time of their own.
+ *
+ * \param bpm
+ *      The BPM value to set, unused.
+ */
+
+void
+midi_null::api_set_beats_per_minute (midibpm /*bpm*/)
+{
+    // No code needed
+}
+
+/**
+ *  Captures a one-byte message.
+ *
+ * \param evbyte
+ *      The status byte of the message.
+ */
+
+void
+midi_null::send_byte (midibyte evbyte)
+{
+    m_null_info.capture(parent_bus().get_bus_index(), evbyte, 0, 0);
+}
+
+/*
+ * class midi_in_null
+ */
+
+/**
+ *  Principal constructor.
+ *
+ * \param parentbus
+ *      Provides the buss object that owns this port.
+ *
+ * \param masterinfo
+ *      Provides the master information, a midi_null_info object.
+ */
+
+midi_in_null::midi_in_null (midibus & parentbus, midi_info & masterinfo)
+ :
+    midi_null       (parentbus, masterinfo)
+{
+    // Empty body
+}
+
+/**
+ *  A rote empty virtual destructor.
+ */
+
+midi_in_null::~midi_in_null ()
+{
+    // Empty body
+}
+
+/**
+ *  Counts the script events that are due.  Unlike the JACK version, this
+ *  function does not sleep; mastermidibase::api_poll_for_midi() does.
+ *
+ * \return
+ *      Returns the number of input events waiting.
+ */
+
+int
+midi_in_null::api_poll_for_midi ()
+{
+    return m_null_info.script_pending();
+}
+
+/**
+ *  Gets the next script event, if it is due.
+ *
+ * \param inev
+ *      Provides the destination for the MIDI event.
+ *
+ * \return
+ *      Returns true if a MIDI event was obtained.
+ */
+
+bool
+midi_in_null::api_get_midi_event (event * inev)
+{
+    return m_null_info.script_event(*inev);
+}
+
+/*
+ * class midi_out_null
+ */
+
+/**
+ *  Principal constructor.
+ *
+ * \param parentbus
+ *      Provides the buss object that owns this port.
+ *
+ * \param masterinfo
+ *      Provides the master information, a midi_null_info object.
+ */
+
+midi_out_null::midi_out_null (midibus & parentbus, midi_info & masterinfo)
+ :
+    midi_null       (parentbus, masterinfo)
+{
+    // Empty body
+}
+
+/**
+ *  A rote empty virtual destructor.
+ */
+
+midi_out_null::~midi_out_null ()
+{
+    // Empty body
+}
+
+}           // namespace seq64
+
+/*
+ * midi_null.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
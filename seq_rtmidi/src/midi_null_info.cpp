@@ -0,0 +1,405 @@
+/**
+ * \file          midi_null_info.cpp
+ *
+ *    A class for the ports, the capture buffer, and the input script of the
+ *    null MIDI API.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       See the rtexmidi.lic file.  Too big.
+ *
+ *  See the midi_null_info.hpp module for the file formats of the capture
+ *  and of the input script.
+ */
+
+#include <stdio.h>                      /* C::fopen(), C::fprintf()         */
+#include <time.h>                       /* C::clock_gettime()               */
+#include <fstream>                      /* std::ifstream                    */
+
+#include "easy_macros.hpp"              /* C++ version of easy macros       */
+#include "event.hpp"                    /* seq64::event and other tokens    */
+#include "midi_null_info.hpp"           /* seq64::midi_null_info            */
+#include "midibus_common.hpp"           /* from the libseq64 sub-project    */
+#include "settings.hpp"                 /* seq64::rc() configuration object */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Gets the monotonic time.
+ *
+ * \return
+ *      Returns the time in microseconds, from an arbitrary point.
+ */
+
+static long
+monotonic_us ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return long(ts.tv_sec) * 1000000L + long(ts.tv_nsec) / 1000L;
+}
+
+/**
+ *  Principal constructor.  Allocates the capture buffer, and reads the input
+ *  script, if one was given.
+ *
+ * \param appname
+ *      Provides the name of the application.
+ *
+ * \param ppqn
+ *      Provides the desired value of the PPQN (pulses per quarter note).
+ *
+ * \param bpm
+ *      Provides the desired value of the BPM (beats per minute).
+ */
+
+midi_null_info::midi_null_info
+(
+    const std::string & appname,
+    int ppqn,
+    midibpm bpm
+) :
+    midi_info               (appname, ppqn, bpm),
+    m_capture               (SEQ64_NULL_CAPTURE_SIZE),
+    m_capture_count         (0),
+    m_script                (),
+    m_script_next           (0),
+    m_start_us              (monotonic_us())
+{
+    midi_handle(this);                      /* there is no real handle      */
+    if (! rc().null_inject_filename().empty())
+        (void) read_script(rc().null_inject_filename());
+}
+
+/**
+ *  Destructor.  Writes the capture, if a file was given for it.
+ */
+
+midi_null_info::~midi_null_info ()
+{
+    if (! rc().null_capture_filename().empty())
+        (void) write_capture(rc().null_capture_filename());
+}
+
+/**
+ *  Gets the information on the null ports: the number of output ports set
+ *  by the "-o null=n" option, and one input port.  They are normal ports of
+ *  the "null" client, so that they are created and initialized like the
+ *  system ports of ALSA.
+ *
+ * \return
+ *      Returns the total number of ports.
+ */
+
+int
+midi_null_info::get_all_port_info ()
+{
+    input_ports().clear();
+    output_ports().clear();
+
+    int count = 0;
+    input_ports().add
+    (
+        0, "null", 0, "null in 0",
+        SEQ64_MIDI_NORMAL_PORT, false, SEQ64_MIDI_INPUT_PORT
+    );
+    ++count;
+
+    int outputs = rc().null_midi_ports();
+    for (int p = 0; p < outputs; ++p)
+    {
+        std::string portname = "null out " + std::to_string(p);
+        output_ports().add
+        (
+            0, "null", p, portname,
+            SEQ64_MIDI_NORMAL_PORT, false, SEQ64_MIDI_OUTPUT_PORT
+        );
+        ++count;
+    }
+    return count;
+}
+
+/**
+ *  Activates the ports.  The capture and the input script are timed from
+ *  here.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midi_null_info::api_connect ()
+{
+    m_start_us = monotonic_us();
+    return true;
+}
+
+/**
+ *  The input is polled port by port, as for JACK, so this function just
+ *  sleeps for a millisecond.
+ *
+ * \return
+ *      Always returns 0.
+ */
+
+int
+midi_null_info::api_poll_for_midi ()
+{
+    millisleep(1);
+    return 0;
+}
+
+/**
+ *  The input is read port by port, as for JACK.
+ *
+ * \return
+ *      Always returns false.
+ */
+
+bool
+midi_null_info::api_get_midi_event (event * /*inev*/)
+{
+    return false;
+}
+
+/**
+ *  There is nothing to flush; the events are captured as they are played.
+ */
+
+void
+midi_null_info::api_flush ()
+{
+    // No code needed
+}
+
+/**
+ * \return
+ *      Returns the microseconds since activation, or, before activation,
+ *      since construction.
+ */
+
+long
+midi_null_info::elapsed_us () const
+{
+    return monotonic_us() - m_start_us;
+}
+
+/**
+ *  Captures an event played to an output port.  Realtime-safe: the buffer
+ *  is never resized, and a slot is claimed with one atomic increment.
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param status
+ *      The status byte, including the channel.
+ *
+ * \param d0
+ *      The first data byte, or 0.
+ *
+ * \param d1
+ *      The second data byte, or 0.
+ *
+ * \param delay_us
+ *      The time from now at which the event is due.  With a lookahead, the
+ *      event is stamped with the time at which a real backend would send
+ *      it.
+ */
+
+void
+midi_null_info::capture
+(
+    int bus, midibyte status, midibyte d0, midibyte d1, long delay_us
+)
+{
+    unsigned slot = m_capture_count.fetch_add(1, std::memory_order_relaxed);
+    if (slot < unsigned(m_capture.size()))
+    {
+        record & r = m_capture[slot];
+        r.nr_time_us = elapsed_us() + delay_us;
+        r.nr_bus = bus;
+        r.nr_status = status;
+        r.nr_d0 = d0;
+        r.nr_d1 = d1;
+    }
+}
+
+/**
+ *  Counts the events of the input script that are due.
+ *
+ * \return
+ *      Returns the number of script events whose time has come, and that
+ *      have not yet been read.
+ */
+
+int
+midi_null_info::script_pending ()
+{
+    int result = 0;
+    long now = elapsed_us();
+    for (unsigned i = m_script_next; i < unsigned(m_script.size()); ++i)
+    {
+        if (m_script[i].nr_time_us <= now)
+            ++result;
+        else
+            break;
+    }
+    return result;
+}
+
+/**
+ *  Gets the next event of the input script, if it is due.  As in
+ *  midi_in_jack::api_get_midi_event(), a Note On with a velocity of 0 is
+ *  turned into a Note Off.
+ *
+ * \param [out] ev
+ *      The event to fill in.  Its timestamp is the time of the script, in
+ *      milliseconds.
+ *
+ * \return
+ *      Returns true if an event was due, and was filled in.
+ */
+
+bool
+midi_null_info::script_event (event & ev)
+{
+    bool result = m_script_next < unsigned(m_script.size());
+    if (result)
+    {
+        const record & r = m_script[m_script_next];
+        result = r.nr_time_us <= elapsed_us();
+        if (result)
+        {
+            ++m_script_next;
+            ev.set_timestamp(midipulse(r.nr_time_us / 1000));
+            ev.set_status_keep_channel(r.nr_status);
+            ev.set_data(r.nr_d0, r.nr_d1);
+            if (ev.is_note_off_recorded())
+            {
+                midibyte channel = r.nr_status & EVENT_GET_CHAN_MASK;
+                ev.set_status_keep_channel(EVENT_NOTE_OFF | channel);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ *  Reads the input script.  Malformed lines are reported and skipped.
+ *
+ * \param filename
+ *      The name of the script file.
+ *
+ * \return
+ *      Returns true if the file could be read.
+ */
+
+bool
+midi_null_info::read_script (const std::string & filename)
+{
+    std::ifstream file(filename.c_str());
+    bool result = file.is_open();
+    if (result)
+    {
+        std::string line;
+        int linenumber = 0;
+        while (std::getline(file, line))
+        {
+            ++linenumber;
+            std::string::size_type pos = line.find_first_not_of(" \t\r");
+            if (pos == std::string::npos || line[pos] == '#')
+                continue;
+
+            long t;
+            unsigned status, d0, d1 = 0;
+            int count = sscanf
+            (
+                line.c_str(), "%ld %x %x %x", &t, &status, &d0, &d1
+            );
+            if (count >= 3 && status >= 0x80 && status < 0xF0 && d0 < 0x80)
+            {
+                record r;
+                r.nr_time_us = t;
+                r.nr_bus = 0;
+                r.nr_status = midibyte(status);
+                r.nr_d0 = midibyte(d0);
+                r.nr_d1 = midibyte(d1 & 0x7F);
+                m_script.push_back(r);
+            }
+            else
+            {
+                errprintf("null MIDI script: bad line %d\n", linenumber);
+            }
+        }
+    }
+    else
+    {
+        std::string msg = "cannot open null MIDI script " + filename;
+        errprint(msg.c_str());
+    }
+    return result;
+}
+
+/**
+ *  Writes the capture as text, one event per line, in the order played.
+ *  If the buffer filled up, the number of events not captured is reported.
+ *
+ * \param filename
+ *      The name of the capture file.
+ *
+ * \return
+ *      Returns true if the file could be written.
+ */
+
+bool
+midi_null_info::write_capture (const std::string & filename) const
+{
+    FILE * fp = fopen(filename.c_str(), "w");
+    bool result = not_nullptr(fp);
+    if (result)
+    {
+        unsigned count = capture_count();
+        unsigned captured = count;
+        if (captured > unsigned(m_capture.size()))
+            captured = unsigned(m_capture.size());
+
+        for (unsigned i = 0; i < captured; ++i)
+        {
+            const record & r = m_capture[i];
+            fprintf
+            (
+                fp, "%ld %d %02x %02x %02x\n", r.nr_time_us, r.nr_bus,
+                unsigned(r.nr_status), unsigned(r.nr_d0), unsigned(r.nr_d1)
+            );
+        }
+        result = fclose(fp) == 0;
+        if (captured < count)
+        {
+            errprintf
+            (
+                "null MIDI capture: %u events dropped\n", count - captured
+            );
+        }
+    }
+    else
+    {
+        std::string msg = "cannot write null MIDI capture " + filename;
+        errprint(msg.c_str());
+    }
+    return result;
+}
+
+}           // namespace seq64
+
+/*
+ * midi_null_info.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
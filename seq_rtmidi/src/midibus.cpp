@@ -378,6 +378,27 @@ midibus::api_play (event * e24, midibyte channel)
         m_rt_midi->api_play(e24, channel);
 }
 
+/**
+ *  Plays an event the given time from now.  Forwards to the API, which
+ *  either schedules the event or sends it immediately.
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to send the event.
+ */
+
+void
+midibus::api_play_at (event * e24, midibyte channel, long delay_us)
+{
+    if (not_nullptr(m_rt_midi))
+        m_rt_midi->api_play_at(e24, channel, delay_us);
+}
+
 /**
  *  Continue from the given tick.  This function implements only the
  *  RtMidi-specific code.
@@ -440,6 +461,24 @@ midibus::api_clock (midipulse tick)
         m_rt_midi->api_clock(tick);
 }
 
+/**
+ *  Sends a MIDI clock pulse the given time from now.  Forwards to the API,
+ *  which either schedules the pulse or sends it immediately.
+ *
+ * \param tick
+ *      The tick of the pulse.
+ *
+ * \param delay_us
+ *      The time from now, in microseconds, at which to send the pulse.
+ */
+
+void
+midibus::api_clock_at (midipulse tick, long delay_us)
+{
+    if (not_nullptr(m_rt_midi))
+        m_rt_midi->api_clock_at(tick, delay_us);
+}
+
 }           // namespace seq64
 
 /*
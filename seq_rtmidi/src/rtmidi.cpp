@@ -34,6 +34,10 @@
 #include "midi_alsa.hpp"
 #endif
 
+#ifdef SEQ64_BUILD_NULL_MIDI
+#include "midi_null.hpp"
+#endif
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -212,6 +216,12 @@ rtmidi_in::openmidi_api (rtmidi_api api, rtmidi_info & info)
         {
 #ifdef SEQ64_BUILD_LINUX_ALSA
             set_api(new midi_in_alsa(parent_bus(), midiinfo));
+#endif
+        }
+        else if (api == RTMIDI_API_NULL)
+        {
+#ifdef SEQ64_BUILD_NULL_MIDI
+            set_api(new midi_in_null(parent_bus(), midiinfo));
 #endif
         }
     }
@@ -357,6 +367,12 @@ rtmidi_out::openmidi_api (rtmidi_api api, rtmidi_info & info)
         {
 #ifdef SEQ64_BUILD_LINUX_ALSA
             set_api(new midi_out_alsa(parent_bus(), midiinfo));
+#endif
+        }
+        else if (api == RTMIDI_API_NULL)
+        {
+#ifdef SEQ64_BUILD_NULL_MIDI
+            set_api(new midi_out_null(parent_bus(), midiinfo));
 #endif
         }
     }
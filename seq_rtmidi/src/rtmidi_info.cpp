@@ -28,6 +28,10 @@
 #include "midi_jack_info.hpp"
 #endif
 
+#ifdef SEQ64_BUILD_NULL_MIDI
+#include "midi_null_info.hpp"
+#endif
+
 /*
  * Do not document the namespace; it breaks Doxygen.
  */
@@ -75,8 +79,15 @@ rtmidi_info::get_compiled_api (std::vector<rtmidi_api> & apis)
      * rc().with_jack_transport(), but the "rc" configuration file has not yet
      * been read by the time we get to here.  On the other hand, we can make
      * it default to "true" and see what happens.
+     *
+     * The null API is used only if selected, and then first.
      */
 
+#ifdef SEQ64_BUILD_NULL_MIDI
+     if (rc().with_null_midi())
+        apis.push_back(RTMIDI_API_NULL);
+#endif
+
 #ifdef SEQ64_BUILD_UNIX_JACK
      if (rc().with_jack_midi())
         apis.push_back(RTMIDI_API_UNIX_JACK);
@@ -241,6 +252,13 @@ rtmidi_info::openmidi_api
     }
 #endif
 
+#ifdef SEQ64_BUILD_NULL_MIDI
+    if (api == RTMIDI_API_NULL)
+    {
+        result = set_api_info(new midi_null_info(appname, ppqn, bpm));
+    }
+#endif
+
     return result;
 }
 
@@ -13,6 +13,10 @@
  *  loosely based on Gary Scavone's RtMidi library.
  */
 
+#include <stdint.h>                     /* uint64_t                     */
+#include <string.h>                     /* memcpy()                     */
+#include <utility>                      /* std::swap()                  */
+
 #include "easy_macros.h"                /* errprintfunc() macro, etc.   */
 #include "rtmidi_types.hpp"             /* seq64::rtmidi, etc.          */
 
@@ -23,6 +27,116 @@
 namespace seq64
 {
 
+/*
+ * class midi_sysex_pool
+ */
+
+/**
+ *  The SysEx blocks, allocated statically.
+ */
+
+static midibyte s_sysex_blocks[SEQ64_SYSEX_BLOCK_COUNT][SEQ64_SYSEX_BLOCK_SIZE];
+
+/**
+ *  For each free block, the index of the next free block, or -1.
+ */
+
+static std::atomic<int> s_sysex_next[SEQ64_SYSEX_BLOCK_COUNT];
+
+/**
+ *  The head of the free stack:  the modification tag in the upper 32 bits,
+ *  and the index of the first free block plus one (0 means empty) in the
+ *  lower 32 bits.
+ */
+
+static std::atomic<uint64_t> s_sysex_head(0);
+
+/**
+ *  Builds the free stack of SysEx blocks when the library is loaded, before
+ *  any message can be created.
+ */
+
+static bool
+sysex_pool_init ()
+{
+    for (int i = 0; i < SEQ64_SYSEX_BLOCK_COUNT; ++i)
+        s_sysex_next[i] = i - 1;
+
+    s_sysex_head = uint64_t(SEQ64_SYSEX_BLOCK_COUNT);
+    return true;
+}
+
+static bool s_sysex_pool_ready = sysex_pool_init();
+
+std::atomic<unsigned long> midi_sysex_pool::sm_overflow(0);
+
+/**
+ *  Pops a free block from the SysEx pool.  Lock-free; safe to call from a
+ *  realtime thread.
+ *
+ * \return
+ *      Returns a block of SEQ64_SYSEX_BLOCK_SIZE bytes, or a null pointer if
+ *      all of the blocks are in use.
+ */
+
+midibyte *
+midi_sysex_pool::acquire ()
+{
+    uint64_t head = s_sysex_head.load(std::memory_order_acquire);
+    for (;;)
+    {
+        int index = int(head & 0xFFFFFFFF) - 1;
+        if (index < 0 || ! s_sysex_pool_ready)
+            return nullptr;
+
+        uint64_t tag = (head >> 32) + 1;
+        uint64_t next = uint64_t(s_sysex_next[index] + 1);
+        if
+        (
+            s_sysex_head.compare_exchange_weak
+            (
+                head, (tag << 32) | next, std::memory_order_acq_rel
+            )
+        )
+        {
+            return s_sysex_blocks[index];
+        }
+    }
+}
+
+/**
+ *  Pushes a block back on the free stack of the SysEx pool.  Lock-free.
+ *
+ * \param block
+ *      A block obtained from acquire().  A null pointer is ignored.
+ */
+
+void
+midi_sysex_pool::release (midibyte * block)
+{
+    if (not_nullptr(block))
+    {
+        int index = int((block - s_sysex_blocks[0]) / SEQ64_SYSEX_BLOCK_SIZE);
+        uint64_t head = s_sysex_head.load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint64_t tag = (head >> 32) + 1;
+            s_sysex_next[index] = int(head & 0xFFFFFFFF) - 1;
+            if
+            (
+                s_sysex_head.compare_exchange_weak
+                (
+                    head, (tag << 32) | uint64_t(index + 1),
+                    std::memory_order_acq_rel
+                )
+            )
+            {
+                break;
+            }
+        }
+    }
+}
+
 /*
  * class midimessage
  */
@@ -33,12 +147,188 @@ namespace seq64
 
 midi_message::midi_message ()
  :
-    m_bytes     (),
+    m_inline    (),
+    m_sysex     (nullptr),
+    m_count     (0),
     m_timestamp (0.0)
 {
     // Empty body
 }
 
+/**
+ *  Copy constructor.  A long message gets a SysEx block of its own.
+ *
+ * \param rhs
+ *      The message to be copied.
+ */
+
+midi_message::midi_message (const midi_message & rhs)
+ :
+    m_inline    (),
+    m_sysex     (nullptr),
+    m_count     (0),
+    m_timestamp (rhs.m_timestamp)
+{
+    copy(rhs);
+}
+
+/**
+ *  Principal assignment operator.  A long message gets a SysEx block of its
+ *  own, or keeps the one it has; a short message gives its block back.
+ *
+ * \param rhs
+ *      The message to be copied.
+ *
+ * \return
+ *      Returns a reference to this message.
+ */
+
+midi_message &
+midi_message::operator = (const midi_message & rhs)
+{
+    (void) assign(rhs);
+    return *this;
+}
+
+/**
+ *  Assigns another message, like the assignment operator, but tells if the
+ *  message could be copied whole.
+ *
+ * \param rhs
+ *      The message to be copied.
+ *
+ * eturn
+ *      Returns false if the message is a SysEx message that could not get a
+ *      block, so that only its first bytes were copied.  The caller should
+ *      then drop it, rather than deliver it.
+ */
+
+bool
+midi_message::assign (const midi_message & rhs)
+{
+    bool result = true;
+    if (this != &rhs)
+    {
+        m_timestamp = rhs.m_timestamp;
+        result = copy(rhs);
+    }
+    return result;
+}
+
+/**
+ *  Exchanges the contents of two messages.  The SysEx blocks change hands;
+ *  no block is acquired, so this cannot fail.
+ *
+ * \param rhs
+ *      The other message.
+ */
+
+void
+midi_message::swap (midi_message & rhs)
+{
+    midibyte inline_bytes[SEQ64_MIDI_MESSAGE_INLINE];
+    memcpy(inline_bytes, m_inline, sizeof inline_bytes);
+    memcpy(m_inline, rhs.m_inline, sizeof inline_bytes);
+    memcpy(rhs.m_inline, inline_bytes, sizeof inline_bytes);
+    std::swap(m_sysex, rhs.m_sysex);
+    std::swap(m_count, rhs.m_count);
+    std::swap(m_timestamp, rhs.m_timestamp);
+}
+
+/**
+ *  Destructor.  Gives back the SysEx block, if any.
+ */
+
+midi_message::~midi_message ()
+{
+    midi_sysex_pool::release(m_sysex);
+}
+
+/**
+ *  Empties the message, and gives back the SysEx block, if any.
+ */
+
+void
+midi_message::clear ()
+{
+    midi_sysex_pool::release(m_sysex);
+    m_sysex = nullptr;
+    m_count = 0;
+}
+
+/**
+ *  Copies the bytes of another message, getting or giving back a SysEx
+ *  block as needed.  If no block can be had, only the inline bytes are
+ *  copied, and the overflow is counted.
+ *
+ * \param rhs
+ *      The message to be copied.
+ *
+ * \return
+ *      Returns false if the message was truncated.
+ */
+
+bool
+midi_message::copy (const midi_message & rhs)
+{
+    bool result = true;
+    int count = rhs.m_count;
+    if (count > SEQ64_MIDI_MESSAGE_INLINE)
+    {
+        if (is_nullptr(m_sysex))
+            m_sysex = midi_sysex_pool::acquire();
+
+        if (is_nullptr(m_sysex))
+        {
+            midi_sysex_pool::count_overflow();
+            count = SEQ64_MIDI_MESSAGE_INLINE;
+            result = false;
+        }
+    }
+    else if (not_nullptr(m_sysex))
+    {
+        midi_sysex_pool::release(m_sysex);
+        m_sysex = nullptr;
+    }
+    memcpy(not_nullptr(m_sysex) ? m_sysex : m_inline, rhs.bytes(), count);
+    m_count = count;
+    return result;
+}
+
+/**
+ *  Appends a byte that does not fit in the inline storage.  Moves the
+ *  message to a SysEx block if it is not in one already.
+ *
+ * \param b
+ *      The byte to append.
+ *
+ * \return
+ *      Returns false, and counts an overflow, if no block is free or the
+ *      block is full.
+ */
+
+bool
+midi_message::push_sysex (midibyte b)
+{
+    if (is_nullptr(m_sysex))
+    {
+        m_sysex = midi_sysex_pool::acquire();
+        if (is_nullptr(m_sysex))
+        {
+            midi_sysex_pool::count_overflow();
+            return false;
+        }
+        memcpy(m_sysex, m_inline, m_count);
+    }
+    if (m_count == SEQ64_SYSEX_BLOCK_SIZE)
+    {
+        midi_sysex_pool::count_overflow();
+        return false;
+    }
+    m_sysex[m_count++] = b;
+    return true;
+}
+
 /**
  *  Shows the bytes in a message, for trouble-shooting.
  */
@@ -46,7 +336,7 @@ midi_message::midi_message ()
 void
 midi_message::show () const
 {
-    if (m_bytes.empty())
+    if (empty())
     {
         fprintf(stderr, "midi_message: empty\n");
         fflush(stderr);
@@ -54,14 +344,10 @@ midi_message::show () const
     else
     {
         fprintf(stderr, "midi_message:\n");
-        for
-        (
-            container::const_iterator ci = m_bytes.begin();
-            ci != m_bytes.end(); ++ci
-        )
-        {
-            fprintf(stderr, " 0x%2x", int(*ci));
-        }
+        const midibyte * b = bytes();
+        for (int i = 0; i < m_count; ++i)
+            fprintf(stderr, " 0x%2x", int(b[i]));
+
         fprintf(stderr, "\n");
         fflush(stderr);
     }
@@ -79,9 +365,9 @@ midi_queue::midi_queue ()
  :
     m_front     (0),
     m_back      (0),
-    m_size      (0),
     m_ring_size (0),
-    m_ring      (nullptr)
+    m_ring      (nullptr),
+    m_overflow  (0)
 {
     allocate();
 }
@@ -96,9 +382,15 @@ midi_queue::~midi_queue ()
 }
 
 /**
+ *  Allocates the slots of the queue, which is emptied.  The size is rounded
+ *  up to a power of 2.  This would be better off as a constructor
+ *  operation.  But one step at a time.
+ *
+ * \threadunsafe
+ *      Must not be called while the producer or the consumer is running.
  *
- *  This would be better off as a constructor operation.  But one step at a
- *  time.
+ * \param queuesize
+ *      The minimum number of slots.
  */
 
 void
@@ -107,16 +399,21 @@ midi_queue::allocate (unsigned queuesize)
     deallocate();
     if (queuesize > 0 && is_nullptr(m_ring))
     {
-        m_ring = new(std::nothrow) midi_message[queuesize];
+        unsigned ringsize = 1;
+        while (ringsize < queuesize)
+            ringsize <<= 1;
+
+        m_ring = new(std::nothrow) midi_message[ringsize];
         if (not_nullptr(m_ring))
-            m_ring_size = queuesize;
+            m_ring_size = ringsize;
     }
 }
 
 /**
+ *  Frees the slots of the queue.  This would be better off as a destructor
+ *  operation.  But one step at a time.
  *
- *  This would be better off as a destructor operation.  But one step at a
- *  time.
+ * \threadunsafe
  */
 
 void
@@ -127,35 +424,53 @@ midi_queue::deallocate ()
         delete [] m_ring;
         m_ring = nullptr;
     }
+    m_ring_size = 0;
+    m_front = 0;
+    m_back = 0;
 }
 
 /**
- *
  *  As long as we haven't reached our queue size limit, push the message.
+ *  Called only by the producer.  The slot is filled before the back count
+ *  is published, with release ordering, so the consumer never sees a
+ *  partly-copied message.  A full queue drops the message and counts it;
+ *  nothing is printed, since the producer is usually a realtime callback.
+ *  A SysEx message that cannot get a block from the midi_sysex_pool is
+ *  dropped too, rather than delivered truncated.
+ *
+ * \param mmsg
+ *      The message to be copied into the next free slot.
+ *
+ * \return
+ *      Returns true if the message was added.
  */
 
 bool
 midi_queue::add (const midi_message & mmsg)
 {
-    bool result = ! full();
+    unsigned back = m_back.load(std::memory_order_relaxed);
+    unsigned front = m_front.load(std::memory_order_acquire);
+    bool result = (back - front) < m_ring_size;
     if (result)
     {
-        m_ring[m_back++] = mmsg;
-        if (m_back == m_ring_size)
-            m_back = 0;
-
-        ++m_size;
+        midi_message & slot = m_ring[back & (m_ring_size - 1)];
+        result = slot.assign(mmsg);
+        if (result)
+            m_back.store(back + 1, std::memory_order_release);
+        else
+            slot.clear();                   /* counted by midi_sysex_pool   */
     }
     else
-    {
-        errprintfunc("message queue limit reached");
-    }
+        ++m_overflow;
+
     return result;
 }
 
 /**
  *  Pops, so to speak, the front message out of the queue, effectively
- *  throwing it away.  One useful call sequence is:
+ *  throwing it away.  The slot is cleared before it is handed back to the
+ *  producer, so that it does not keep a SysEx block.  One useful call
+ *  sequence is:
  *
 \verbatim
     midi_message latest = queue.front();
@@ -168,17 +483,18 @@ midi_queue::add (const midi_message & mmsg)
 void
 midi_queue::pop ()
 {
-    --m_size;
-    ++m_front;
-    if (m_front == m_ring_size)
-        m_front = 0;
+    unsigned front = m_front.load(std::memory_order_relaxed);
+    if (front != m_back.load(std::memory_order_acquire))
+    {
+        m_ring[front & (m_ring_size - 1)].clear();
+        m_front.store(front + 1, std::memory_order_release);
+    }
 }
 
 /**
- *  Pops a copy of the front message.   Could be a little inefficient, since a
- *  couple of copies are made, and we cannot use return-code optimization.
- *
- *  Perhaps at some point we could use move semantics?
+ *  Pops the front message.  The message is swapped out of its slot, so
+ *  that a SysEx block goes with it instead of being copied, and the slot is
+ *  then cleared before it is handed back to the producer.
  *
  * \return
  *      Returns a copy of the message that was in front before the popping.
@@ -190,11 +506,13 @@ midi_message
 midi_queue::pop_front ()
 {
     midi_message result;
-    if (m_size != 0)
+    unsigned front = m_front.load(std::memory_order_relaxed);
+    if (front != m_back.load(std::memory_order_acquire))
     {
-        midi_message & mmr = m_ring[m_front];
-        result = mmr;
-        pop();
+        midi_message & slot = m_ring[front & (m_ring_size - 1)];
+        result.swap(slot);
+        slot.clear();
+        m_front.store(front + 1, std::memory_order_release);
     }
     return result;
 }
@@ -214,7 +532,8 @@ rtmidi_in_data::rtmidi_in_data ()
     m_using_callback    (false),
     m_user_callback     (nullptr),
     m_user_data         (nullptr),
-    m_continue_sysex    (false)
+    m_continue_sysex    (false),
+    m_wakeup            (nullptr)
 {
     // no body
 }
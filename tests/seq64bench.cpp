@@ -0,0 +1,919 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          seq64bench.cpp
+ *
+ *  This module defines a micro-benchmark of the hot paths of the engine.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2018-11-22
+ * \updates       2018-11-22
+ * \license       GNU GPLv2 or above
+ *
+ *  The benchmark builds synthetic songs, each of N patterns of M events,
+ *  with a given pattern length and trigger density, and times:
+ *
+ *      -   perform::play(), one tick per call, in Song mode and in Live mode.
+ *      -   sequence::play(), one tick per call.
+ *      -   triggers::play(), one tick per call.
+ *      -   event_list::verify_and_link(), via sequence::verify_and_link().
+ *      -   sequence::quantize_events(), on all of the notes of a pattern.
+ *      -   midifile::write() and midifile::parse() of the song.
+ *      -   event_list::add() of the events of a pattern, in random order.
+ *      -   sequence::select_note_events() and unselect() of a whole pattern.
+ *      -   sequence::get_next_note_event() over a whole pattern, as drawing
+ *          the pattern does.
+ *      -   midi_vector::fill() of a pattern, as when saving it.
+ *
+ *  It runs on the null MIDI API (see the seq_rtmidi midi_null module), so
+ *  it needs no sound server, and the events played are captured rather
+ *  than sent.  The songs come from a fixed-seed generator, so every run
+ *  times the same work.  Each measurement is repeated, and the median,
+ *  minimum, and maximum time per operation are written to standard output
+ *  as comma-separated values, with a header line.  The unit column tells
+ *  what one operation is: a "tick" of a play loop, an "event", or a "call".
+ *  The event container of the build (see the "--with-events" configure
+ *  option) is shown on standard error, so that the results of the list,
+ *  map, and array builds can be compared.
+ *
+ *  Usage:
+ *
+ *      seq64bench [--repeats n] [--filter text] > results.csv
+ *
+ *  Event containers.  These are the medians of 5 repeats for the "long"
+ *  song (16 patterns of 2048 events), in nanoseconds per operation, from
+ *  -O2 builds made with each "--with-events" choice, on x86-64 Linux with
+ *  the null MIDI API.  Compare builds on the same machine; only the ratios
+ *  mean anything.
+ *
+ *      benchmark               list        map       array     unit
+ *      event_list_insert      50713        129         196     event
+ *      event_list_select      12119      29039        9094     call
+ *      event_list_draw        39926      55105       40416     call
+ *      event_list_save       223628     147076      125260     call
+ *      verify_and_link        39502      87273       17488     call
+ *      midifile_write      17335059   11827958    10237091     call
+ *      midifile_parse      34016829   33723110    21781171     call
+ *
+ *  The list sorts itself on each event_list::add(), hence its insertion
+ *  cost.  Drawing costs about the same with the list and the array, since
+ *  each step takes the lock of the pattern.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>                     /* C::atoi()                        */
+#include <string.h>                     /* C::strcmp()                      */
+#include <time.h>                       /* C::clock_gettime()               */
+#include <algorithm>                    /* std::sort()                      */
+#include <string>
+#include <vector>
+
+#include "cmdlineopts.hpp"              /* seq64::parse_o_options()         */
+#include "event.hpp"                    /* seq64::event                     */
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "event_list.hpp"              /* seq64::event_list                */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "midi_vector.hpp"              /* seq64::midi_vector               */
+#include "perform.hpp"                  /* seq64::perform, the main object  */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "settings.hpp"                 /* seq64::usr() and seq64::rc()     */
+#include "triggers.hpp"                 /* seq64::triggers                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Gives the benchmark access to perform::play(), which is otherwise called
+ *  only by the output thread and by perform::render_offline().
+ */
+
+class benchmark
+{
+
+public:
+
+    /**
+     *  Plays all of the active patterns up to the given tick.
+     */
+
+    static void play (perform & p, midipulse tick)
+    {
+        p.play(tick);
+    }
+
+};          // class benchmark
+
+}           // namespace seq64
+
+/**
+ *  Describes a synthetic song.
+ */
+
+struct scenario
+{
+    const char * sc_name;               /**< The name in the results.       */
+    int sc_sequences;                   /**< The number of patterns.        */
+    int sc_events;                      /**< The events in each pattern.    */
+    int sc_measures;                    /**< The length of each pattern.    */
+    int sc_density;                     /**< Percent of slots triggered.    */
+};
+
+/**
+ *  The songs to benchmark.  Keep this list stable, so that results can be
+ *  compared from one build to the next; add new songs at the end.
+ */
+
+static const scenario s_scenarios [] =
+{
+    { "small",       8,    64,   1,  100 },
+    { "sparse",     32,   256,   4,   25 },
+    { "dense",      32,   256,   1,  100 },
+    { "long",       16,  2048,  16,   50 },
+    { "large",     128,   512,   4,   50 },
+};
+
+/**
+ *  The length of each song, in measures of 4/4 at the default PPQN.
+ */
+
+static const int s_song_measures = 32;
+
+/**
+ *  The default number of times that each measurement is made.
+ */
+
+static const int s_default_repeats = 5;
+
+/**
+ *  The number of calls timed together for the short operations.
+ */
+
+static const int s_short_calls = 10;
+
+/**
+ *  The state of the pseudo-random generator.  It is reseeded for each song,
+ *  so that each song is the same whatever was run before it.
+ */
+
+static unsigned long s_random_state = 1;
+
+/**
+ *  A small linear-congruential generator, so that the songs do not depend
+ *  on the C library.
+ *
+ * \param limit
+ *      One more than the largest value wanted.
+ *
+ * \return
+ *      Returns a value from 0 to limit - 1.
+ */
+
+static int
+bench_random (int limit)
+{
+    s_random_state = (s_random_state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return limit > 0 ? int((s_random_state >> 8) % (unsigned long)(limit)) : 0 ;
+}
+
+/**
+ * \return
+ *      Returns the monotonic time in nanoseconds.
+ */
+
+static long long
+now_ns ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)(ts.tv_sec) * 1000000000LL + (long long)(ts.tv_nsec);
+}
+
+/**
+ * \return
+ *      Returns the length of a measure, in ticks.
+ */
+
+static seq64::midipulse
+measure_ticks ()
+{
+    return seq64::midipulse(SEQ64_DEFAULT_PPQN * 4);
+}
+
+/**
+ * \return
+ *      Returns the last tick of the song.
+ */
+
+static seq64::midipulse
+song_ticks ()
+{
+    return s_song_measures * measure_ticks();
+}
+
+/**
+ *  Holds the repeated timings of one measurement.
+ */
+
+class timings
+{
+
+private:
+
+    std::vector<double> m_ns_per_op;
+
+public:
+
+    timings () : m_ns_per_op ()
+    {
+        // Empty body
+    }
+
+    /**
+     *  Adds one timing.
+     *
+     * \param ns
+     *      The nanoseconds taken by the whole run.
+     *
+     * \param ops
+     *      The operations done in that time.
+     */
+
+    void add (long long ns, long ops)
+    {
+        if (ops > 0)
+            m_ns_per_op.push_back(double(ns) / double(ops));
+    }
+
+    /**
+     *  Writes a line of results.
+     */
+
+    void report
+    (
+        const char * bench, const scenario & sc,
+        const char * unit, long ops
+    )
+    {
+        if (m_ns_per_op.empty())
+            return;
+
+        std::sort(m_ns_per_op.begin(), m_ns_per_op.end());
+        double median = m_ns_per_op[m_ns_per_op.size() / 2];
+        printf
+        (
+            "%s,%s,%d,%d,%d,%d,%s,%ld,%.1f,%.1f,%.1f\n",
+            bench, sc.sc_name, sc.sc_sequences, sc.sc_events,
+            sc.sc_measures, sc.sc_density, unit, ops, median,
+            m_ns_per_op.front(), m_ns_per_op.back()
+        );
+        fflush(stdout);
+    }
+
+};          // class timings
+
+/**
+ *  Fills a pattern with notes spread evenly over its length, each with a
+ *  little random lateness, pitch, and velocity.
+ *
+ * \param s
+ *      The pattern, which must be empty.
+ *
+ * \param sc
+ *      The song, which gives the event count and pattern length.
+ */
+
+static void
+fill_sequence (seq64::sequence & s, const scenario & sc)
+{
+    seq64::midipulse length = sc.sc_measures * measure_ticks();
+    int notes = sc.sc_events / 2;
+    if (notes < 1)
+        notes = 1;
+
+    seq64::midipulse spacing = length / notes;
+    if (spacing < 2)
+        spacing = 2;
+
+    seq64::midipulse notelength = spacing / 2;
+    for (int n = 0; n < notes; ++n)
+    {
+        seq64::midipulse tick = n * spacing;
+        tick += bench_random(int(spacing / 4) + 1);
+        seq64::midibyte note = seq64::midibyte(36 + bench_random(48));
+        seq64::midibyte velocity = seq64::midibyte(64 + bench_random(64));
+        seq64::event on;
+        on.set_timestamp(tick);
+        on.set_status(seq64::EVENT_NOTE_ON);
+        on.set_data(note, velocity);
+        s.append_event(on);
+
+        seq64::event off;
+        off.set_timestamp(tick + notelength - 1);
+        off.set_status(seq64::EVENT_NOTE_OFF);
+        off.set_data(note, 0);
+        s.append_event(off);
+    }
+    s.sort_events();
+    s.set_length(length);                           /* also verifies        */
+}
+
+/**
+ *  Adds the triggers of a pattern.  Each pattern-length slot of the song is
+ *  triggered with the song's density.
+ *
+ * \param sc
+ *      The song.
+ *
+ * \param [out] starts
+ *      The start ticks of the triggers.
+ */
+
+static void
+make_triggers (const scenario & sc, std::vector<seq64::midipulse> & starts)
+{
+    seq64::midipulse length = sc.sc_measures * measure_ticks();
+    starts.clear();
+    for (seq64::midipulse t = 0; t < song_ticks(); t += length)
+    {
+        if (bench_random(100) < sc.sc_density)
+            starts.push_back(t);
+    }
+}
+
+/**
+ *  Builds a song in the performance, replacing the one already there.
+ *
+ * \param p
+ *      The performance, which must have been launched.
+ *
+ * \param sc
+ *      The song to build.
+ *
+ * \return
+ *      Returns true if the song was built.
+ */
+
+static bool
+build_song (seq64::perform & p, const scenario & sc)
+{
+    bool result = p.clear_all();
+    seq64::midipulse length = sc.sc_measures * measure_ticks();
+    for (int i = 0; result && i < sc.sc_sequences; ++i)
+    {
+        result = p.new_sequence(i);
+        if (result)
+        {
+            seq64::sequence * s = p.get_sequence(i);
+            s->set_midi_bus(0);
+            s->set_midi_channel(seq64::midibyte(i % 16));
+            fill_sequence(*s, sc);
+
+            std::vector<seq64::midipulse> starts;
+            make_triggers(sc, starts);
+            for (size_t t = 0; t < starts.size(); ++t)
+                s->add_trigger(starts[t], length);
+        }
+    }
+    return result;
+}
+
+/**
+ *  Rewinds all of the patterns of the song to the start.
+ *
+ * \param p
+ *      The performance.
+ *
+ * \param sc
+ *      The song.
+ *
+ * \param songmode
+ *      If true, the patterns are turned off, for the triggers to turn them
+ *      on.  Otherwise, they are all turned on.
+ */
+
+static void
+rewind_song (seq64::perform & p, const scenario & sc, bool songmode)
+{
+    p.playback_mode(songmode);
+    for (int i = 0; i < sc.sc_sequences; ++i)
+    {
+        seq64::sequence * s = p.get_sequence(i);
+        if (not_nullptr(s))
+        {
+            s->stop(songmode);
+            if (! songmode)
+                s->set_playing(true);
+        }
+    }
+    p.set_tick(0);
+    p.wake_sequences();
+}
+
+/**
+ *  Times perform::play(), one tick per call, over the whole song.
+ */
+
+static void
+bench_perform_play
+(
+    seq64::perform & p, const scenario & sc, bool songmode, int repeats
+)
+{
+    timings t;
+    long ops = long(song_ticks()) + 1;
+    for (int r = 0; r < repeats; ++r)
+    {
+        rewind_song(p, sc, songmode);
+        long long start = now_ns();
+        for (seq64::midipulse tick = 0; tick <= song_ticks(); ++tick)
+            seq64::benchmark::play(p, tick);
+
+        t.add(now_ns() - start, ops);
+    }
+    rewind_song(p, sc, false);
+    const char * name = songmode ? "perform_play_song" : "perform_play_live" ;
+    t.report(name, sc, "tick", ops);
+}
+
+/**
+ *  Times sequence::play() of the first pattern, one tick per call, over the
+ *  whole song, in Live mode.
+ */
+
+static void
+bench_sequence_play (seq64::perform & p, const scenario & sc, int repeats)
+{
+    timings t;
+    long ops = long(song_ticks()) + 1;
+    seq64::sequence * s = p.get_sequence(0);
+    for (int r = 0; r < repeats; ++r)
+    {
+        s->stop(false);
+        s->set_playing(true);
+        long long start = now_ns();
+        for (seq64::midipulse tick = 0; tick <= song_ticks(); ++tick)
+            s->play(tick, false);
+
+        t.add(now_ns() - start, ops);
+    }
+    s->stop(false);
+    t.report("sequence_play", sc, "tick", ops);
+}
+
+/**
+ *  Times triggers::play() with the triggers of a pattern, one tick per call,
+ *  over the whole song.  The triggers turn the first pattern on and off, as
+ *  they do in Song mode.
+ */
+
+static void
+bench_triggers_play (seq64::perform & p, const scenario & sc, int repeats)
+{
+    timings t;
+    long ops = long(song_ticks()) + 1;
+    seq64::sequence * s = p.get_sequence(0);
+    seq64::midipulse length = sc.sc_measures * measure_ticks();
+    std::vector<seq64::midipulse> starts;
+    make_triggers(sc, starts);
+
+    seq64::triggers trigs(*s);
+    trigs.set_ppqn(SEQ64_DEFAULT_PPQN);
+    trigs.set_length(int(length));
+    for (size_t i = 0; i < starts.size(); ++i)
+        trigs.add(starts[i], length);
+
+    for (int r = 0; r < repeats; ++r)
+    {
+        s->stop(true);
+        long long start = now_ns();
+        for (seq64::midipulse tick = 0; tick <= song_ticks(); ++tick)
+        {
+            seq64::midipulse starttick = tick;
+            seq64::midipulse endtick = tick;
+            (void) trigs.play(starttick, endtick);
+        }
+        t.add(now_ns() - start, ops);
+    }
+    s->stop(false);
+    t.report("triggers_play", sc, "tick", ops);
+}
+
+/**
+ *  Times event_list::verify_and_link() on the first pattern.
+ */
+
+static void
+bench_verify_and_link (seq64::perform & p, const scenario & sc, int repeats)
+{
+    timings t;
+    seq64::sequence * s = p.get_sequence(0);
+    for (int r = 0; r < repeats; ++r)
+    {
+        long long start = now_ns();
+        for (int c = 0; c < s_short_calls; ++c)
+            s->verify_and_link();
+
+        t.add(now_ns() - start, s_short_calls);
+    }
+    t.report("verify_and_link", sc, "call", s_short_calls);
+}
+
+/**
+ *  Times sequence::quantize_events() of all of the notes of a new pattern,
+ *  to a sixteenth note.  Quantizing changes the pattern, so each repeat
+ *  quantizes a new copy.  The pattern needs the master bus, since removing
+ *  the original notes turns off any that are playing.
+ */
+
+static void
+bench_quantize_events (seq64::perform & p, const scenario & sc, int repeats)
+{
+    timings t;
+    for (int r = 0; r < repeats; ++r)
+    {
+        s_random_state = 1;
+        seq64::sequence s(SEQ64_DEFAULT_PPQN);
+        s.set_master_midi_bus(&p.master_bus());
+        fill_sequence(s, sc);
+        s.select_all();
+
+        long long start = now_ns();
+        s.quantize_events
+        (
+            seq64::EVENT_NOTE_ON, 0, SEQ64_DEFAULT_PPQN / 4, 1, true
+        );
+        t.add(now_ns() - start, 1);
+    }
+    t.report("quantize_events", sc, "call", 1);
+}
+
+/**
+ *  Times midifile::write() of the song, then midifile::parse() of the file
+ *  written.  The parse replaces the song in the performance.
+ */
+
+static void
+bench_midifile
+(
+    seq64::perform & p, const scenario & sc, int repeats,
+    const std::string & filename
+)
+{
+    timings tw;
+    for (int r = 0; r < repeats; ++r)
+    {
+        seq64::midifile f(filename, SEQ64_DEFAULT_PPQN);
+        long long start = now_ns();
+        bool ok = f.write(p);
+        tw.add(now_ns() - start, 1);
+        if (! ok)
+        {
+            fprintf(stderr, "cannot write %s\n", filename.c_str());
+            return;
+        }
+    }
+    tw.report("midifile_write", sc, "call", 1);
+
+    timings tp;
+    for (int r = 0; r < repeats; ++r)
+    {
+        if (! p.clear_all())
+            return;
+
+        seq64::midifile f(filename, SEQ64_DEFAULT_PPQN);
+        long long start = now_ns();
+        bool ok = f.parse(p, 0);
+        tp.add(now_ns() - start, 1);
+        if (! ok)
+        {
+            fprintf(stderr, "cannot parse %s\n", filename.c_str());
+            return;
+        }
+    }
+    tp.report("midifile_parse", sc, "call", 1);
+}
+
+/**
+ *  Times event_list::add() of the events of a pattern, taken in random
+ *  order, as when recording or pasting rather than reading a file.
+ */
+
+static void
+bench_event_list_insert (const scenario & sc, int repeats)
+{
+    s_random_state = 1;
+    seq64::sequence s(SEQ64_DEFAULT_PPQN);
+    fill_sequence(s, sc);
+
+    std::vector<seq64::event> events;
+    const seq64::event_list & evl = s.events();
+    for
+    (
+        seq64::event_list::const_iterator i = evl.begin(); i != evl.end(); ++i
+    )
+    {
+        events.push_back(seq64::event_list::dref(i));
+    }
+    for (size_t e = events.size(); e > 1; --e)
+        std::swap(events[e - 1], events[bench_random(int(e))]);
+
+    timings t;
+    long ops = long(events.size());
+    for (int r = 0; r < repeats; ++r)
+    {
+        seq64::event_list el;
+        long long start = now_ns();
+        for (size_t e = 0; e < events.size(); ++e)
+            (void) el.add(events[e]);
+
+        t.add(now_ns() - start, ops);
+    }
+    t.report("event_list_insert", sc, "event", ops);
+}
+
+/**
+ *  Times the selection of all of the notes of the first pattern by a box, as
+ *  a rubber-band selection does, then the unselection of them.
+ */
+
+static void
+bench_event_list_select (seq64::perform & p, const scenario & sc, int repeats)
+{
+    timings t;
+    seq64::sequence * s = p.get_sequence(0);
+    seq64::midipulse length = s->get_length();
+    for (int r = 0; r < repeats; ++r)
+    {
+        long long start = now_ns();
+        for (int c = 0; c < s_short_calls; ++c)
+        {
+            (void) s->select_note_events
+            (
+                0, SEQ64_MAX_DATA_VALUE, length, 0, seq64::sequence::e_select
+            );
+            s->unselect();
+        }
+        t.add(now_ns() - start, s_short_calls);
+    }
+    t.report("event_list_select", sc, "call", s_short_calls);
+}
+
+/**
+ *  Times a drawing pass over the first pattern: reset_draw_marker(), then
+ *  get_next_note_event() until it returns DRAW_FIN.
+ */
+
+static void
+bench_event_list_draw (seq64::perform & p, const scenario & sc, int repeats)
+{
+    timings t;
+    seq64::sequence * s = p.get_sequence(0);
+    long notes = 0;
+    for (int r = 0; r < repeats; ++r)
+    {
+        long long start = now_ns();
+        for (int c = 0; c < s_short_calls; ++c)
+        {
+            seq64::midipulse tick_s, tick_f;
+            int note, velocity;
+            bool selected;
+            s->reset_draw_marker();
+            while
+            (
+                s->get_next_note_event(tick_s, tick_f, note, selected, velocity)
+                    != seq64::DRAW_FIN
+            )
+            {
+                ++notes;
+            }
+        }
+        t.add(now_ns() - start, s_short_calls);
+    }
+    if (notes == 0)
+        fprintf(stderr, "event_list_draw: no notes drawn\n");
+
+    t.report("event_list_draw", sc, "call", s_short_calls);
+}
+
+/**
+ *  Times midi_vector::fill() of the first pattern, which converts its events
+ *  to a track, as midifile::write() does for each pattern.
+ */
+
+static void
+bench_event_list_save (seq64::perform & p, const scenario & sc, int repeats)
+{
+    timings t;
+    seq64::sequence * s = p.get_sequence(0);
+    for (int r = 0; r < repeats; ++r)
+    {
+        long long start = now_ns();
+        for (int c = 0; c < s_short_calls; ++c)
+        {
+            seq64::midi_vector track(*s);
+            track.fill(0, p, false);
+        }
+        t.add(now_ns() - start, s_short_calls);
+    }
+    t.report("event_list_save", sc, "call", s_short_calls);
+}
+
+/**
+ * \return
+ *      Returns the name of the event container of the build.
+ */
+
+static const char *
+event_container ()
+{
+#if defined SEQ64_USE_EVENT_MAP
+    return "map";
+#elif defined SEQ64_USE_EVENT_ARRAY
+    return "array";
+#else
+    return "list";
+#endif
+}
+
+/**
+ *  Tells if a benchmark is selected by the filter.
+ */
+
+static bool
+selected (const std::string & filter, const char * bench)
+{
+    return filter.empty() ||
+        std::string(bench).find(filter) != std::string::npos;
+}
+
+/**
+ *  Shows the usage.
+ */
+
+static void
+show_help ()
+{
+    printf
+    (
+        "seq64bench: times the hot paths of the Sequencer64 engine.\n\n"
+        "  --repeats n    Repeats each measurement n times (default %d).\n"
+        "  --filter text  Runs only the benchmarks whose name has 'text'.\n"
+        "  --help         Shows this help.\n\n"
+        "The results are written to standard output as comma-separated\n"
+        "values.  The times are nanoseconds per operation.\n",
+        s_default_repeats
+    );
+}
+
+/**
+ *  The main routine of the benchmark.
+ *
+ * \param argc
+ *      The number of command-line parameters.
+ *
+ * \param argv
+ *      The command-line parameters.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS, or EXIT_FAILURE if a song could not be built.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    int repeats = s_default_repeats;
+    std::string filter;
+    for (int a = 1; a < argc; ++a)
+    {
+        if (strcmp(argv[a], "--repeats") == 0 && a + 1 < argc)
+        {
+            repeats = atoi(argv[++a]);
+            if (repeats < 1)
+                repeats = 1;
+        }
+        else if (strcmp(argv[a], "--filter") == 0 && a + 1 < argc)
+        {
+            filter = argv[++a];
+        }
+        else
+        {
+            show_help();
+            return EXIT_SUCCESS;
+        }
+    }
+
+    seq64::set_app_name("seq64bench");
+    seq64::rc().set_defaults();
+    seq64::usr().set_defaults();
+    seq64::rc().with_jack_transport(false);
+    seq64::rc().with_jack_master(false);
+    seq64::rc().with_jack_master_cond(false);
+
+    /*
+     * Select the null MIDI API just as "-o null=1" does, so that no sound
+     * server is needed.
+     */
+
+    char appname [] = "seq64bench";
+    char optflag [] = "-o";
+    char optvalue [] = "null=1";
+    char * nullargs [] = { appname, optflag, optvalue };
+    (void) seq64::parse_o_options(3, nullargs);
+
+    seq64::keys_perform keys;
+    seq64::gui_assistant gui(keys);
+    seq64::perform p(gui);
+    p.launch(SEQ64_DEFAULT_PPQN);
+
+    const char * tmpdir = getenv("TMPDIR");
+    std::string filename = not_nullptr(tmpdir) ? tmpdir : "/tmp" ;
+    filename += "/seq64bench.midi";
+
+    fprintf
+    (
+        stderr, "seq64bench: event container is '%s'\n", event_container()
+    );
+    printf
+    (
+        "benchmark,scenario,sequences,events,measures,density,unit,ops,"
+        "median_ns,min_ns,max_ns\n"
+    );
+
+    bool ok = true;
+    int count = int(sizeof s_scenarios / sizeof s_scenarios[0]);
+    for (int i = 0; ok && i < count; ++i)
+    {
+        const scenario & sc = s_scenarios[i];
+        s_random_state = 1;
+        ok = build_song(p, sc);
+        if (! ok)
+        {
+            fprintf(stderr, "cannot build song '%s'\n", sc.sc_name);
+            break;
+        }
+        if (selected(filter, "perform_play_song"))
+            bench_perform_play(p, sc, true, repeats);
+
+        if (selected(filter, "perform_play_live"))
+            bench_perform_play(p, sc, false, repeats);
+
+        if (selected(filter, "sequence_play"))
+            bench_sequence_play(p, sc, repeats);
+
+        if (selected(filter, "triggers_play"))
+            bench_triggers_play(p, sc, repeats);
+
+        if (selected(filter, "verify_and_link"))
+            bench_verify_and_link(p, sc, repeats);
+
+        if (selected(filter, "quantize_events"))
+            bench_quantize_events(p, sc, repeats);
+
+        if (selected(filter, "event_list_insert"))
+            bench_event_list_insert(sc, repeats);
+
+        if (selected(filter, "event_list_select"))
+            bench_event_list_select(p, sc, repeats);
+
+        if (selected(filter, "event_list_draw"))
+            bench_event_list_draw(p, sc, repeats);
+
+        if (selected(filter, "event_list_save"))
+            bench_event_list_save(p, sc, repeats);
+
+        if (selected(filter, "midifile"))
+            bench_midifile(p, sc, repeats, filename);
+    }
+    (void) p.clear_all();
+    (void) remove(filename.c_str());
+    p.finish();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
+
+/*
+ * seq64bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */